@@ -10,6 +10,9 @@
  * \author Rene Rahn <rene.rahn AT fu-berlin.de>
  */
 
+#include <limits>
+#include <thread>
+
 #include <cereal/archives/binary.hpp>
 
 #include <seqan3/argument_parser/argument_parser.hpp>
@@ -53,6 +56,34 @@ int create_main(seqan3::argument_parser & create_parser)
                              "must contain the associated contigs for this vcf file.",
                              seqan3::option_spec::standard,
                              seqan3::input_file_validator{{"vcf"}});
+    create_parser.add_option(options.min_allele_frequency,
+                             '\0',
+                             "min-af",
+                             "Discards variants whose allele frequency among the selected haplotypes is below this "
+                             "threshold.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{0.0, 1.0});
+    create_parser.add_option(options.min_carrier_count,
+                             '\0',
+                             "min-carriers",
+                             "Discards variants that are carried by fewer of the selected haplotypes.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{1u, std::numeric_limits<uint32_t>::max()});
+    create_parser.add_option(options.sample_file,
+                             '\0',
+                             "samples",
+                             "A file listing one sample name per line. Only the haplotypes of the listed samples "
+                             "are added to the jst.",
+                             seqan3::option_spec::standard,
+                             seqan3::input_file_validator{});
+    create_parser.add_option(options.thread_count,
+                             't',
+                             "thread-count",
+                             "The number of contigs constructed in parallel. If the vcf file contains more than one "
+                             "contig, one jst per contig is written to the output path with the contig name appended "
+                             "to the file name.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{1u, std::thread::hardware_concurrency()});
     create_parser.add_option(options.bin_count,
                              'b',
                              "bin-count",
@@ -97,7 +128,7 @@ int create_main(seqan3::argument_parser & create_parser)
                 "Create from vcf ", options.vcf_file, " and contigs ", options.sequence_file);
 
             // auto jst_per_contig = construct_jst_from_vcf(options.sequence_file, options.vcf_file);
-            construct_jst_from_vcf2(options.sequence_file, options.vcf_file, options.output_file);
+            construct_jst_from_vcf2(options);
 
             // log(verbosity_level::standard, logging_level::info,
             //     "Generated ", jst_per_contig.size(), " journal sequence tree(s).");
@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the normalisation of vcf alleles into minimal breakpoints.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap
+{
+    //!\brief An alternative allele reduced to its minimal and left-aligned representation.
+    struct normalised_allele
+    {
+        uint32_t position{}; //!< The 0-based position of the first reference base replaced by the allele.
+        uint32_t deletion_size{}; //!< The number of reference bases replaced by the allele.
+        reference_t insertion{}; //!< The sequence inserted at the breakpoint.
+
+        //!\brief Whether the allele does not change the reference at all.
+        constexpr bool is_identity() const noexcept {
+            return deletion_size == 0 && insertion.empty();
+        }
+    };
+
+    /*!\brief Normalises a REF/ALT pair of a vcf record.
+     *
+     * \param[in] source The reference sequence the record refers to.
+     * \param[in] position The 0-based position of the REF allele.
+     * \param[in] ref The REF allele.
+     * \param[in] alt The ALT allele.
+     *
+     * \details
+     *
+     * Removes the common suffix and then the common prefix of both alleles.
+     * Pure insertions and deletions are afterwards shifted to their leftmost equivalent position within the source,
+     * such that the same event reported with different padding always ends up at the same breakpoint.
+     *
+     * \throws std::runtime_error if the REF allele exceeds the source.
+     */
+    template <std::ranges::random_access_range source_t>
+    normalised_allele normalise_allele(source_t const & source,
+                                       uint32_t position,
+                                       std::string_view ref,
+                                       std::string_view alt)
+    {
+        using namespace std::literals;
+
+        if (static_cast<size_t>(position) + ref.size() > std::ranges::size(source))
+            throw std::runtime_error{"The REF allele at position "s + std::to_string(position + 1) +
+                                     " exceeds the reference sequence!"s};
+
+        reference_t ref_allele{ref.begin(), ref.end()};
+        reference_t alt_allele{alt.begin(), alt.end()};
+
+        // Trim the common suffix.
+        auto [ref_suffix_end, alt_suffix_end] = std::ranges::mismatch(ref_allele | std::views::reverse,
+                                                                     alt_allele | std::views::reverse);
+        ref_allele.erase(ref_suffix_end.base(), ref_allele.end());
+        alt_allele.erase(alt_suffix_end.base(), alt_allele.end());
+
+        // Trim the common prefix.
+        auto [ref_prefix_end, alt_prefix_end] = std::ranges::mismatch(ref_allele, alt_allele);
+        position += std::ranges::distance(ref_allele.begin(), ref_prefix_end);
+        ref_allele.erase(ref_allele.begin(), ref_prefix_end);
+        alt_allele.erase(alt_allele.begin(), alt_prefix_end);
+
+        normalised_allele allele{.position = position,
+                                 .deletion_size = static_cast<uint32_t>(ref_allele.size()),
+                                 .insertion = std::move(alt_allele)};
+
+        auto source_at = [&] (uint32_t const idx) -> alphabet_t { return source[idx]; };
+
+        // Left-align pure deletions: the deleted segment can be rotated as long as it is flanked by a repeat.
+        if (allele.insertion.empty() && allele.deletion_size > 0) {
+            while (allele.position > 0 &&
+                   source_at(allele.position - 1) == source_at(allele.position + allele.deletion_size - 1))
+                --allele.position;
+        }
+
+        // Left-align pure insertions: the inserted sequence rotates with the preceding reference base.
+        if (allele.deletion_size == 0 && !allele.insertion.empty()) {
+            while (allele.position > 0 && source_at(allele.position - 1) == allele.insertion.back()) {
+                std::ranges::rotate(allele.insertion, std::ranges::prev(allele.insertion.end()));
+                --allele.position;
+            }
+        }
+
+        return allele;
+    }
+}  // namespace jstmap
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 
 namespace jstmap
@@ -22,9 +23,13 @@ struct create_options
     std::filesystem::path sequence_file{}; //!< The file path contianing the sequences to index.
     std::filesystem::path vcf_file{}; //!< The file path contianing the vcf file to build the jst for.
     std::filesystem::path output_file{}; //!< The file path to write the constructed index to.
+    std::filesystem::path sample_file{}; //!< The file path listing the samples to restrict the jst to.
     bool is_quite{false}; //!< Wether the index app should run in quite mode.
     bool is_verbose{false}; //!< Wether the index app should run in verbose mode.
     uint32_t bin_count = 1; //!< The number of bins to partition the JST into.
+    uint32_t thread_count = 1; //!< The number of contigs constructed in parallel.
+    uint32_t min_carrier_count = 1; //!< The minimal number of haplotypes carrying a variant.
+    double min_allele_frequency = 0.0; //!< The minimal allele frequency of a variant.
 };
 
 }  // namespace jstmap
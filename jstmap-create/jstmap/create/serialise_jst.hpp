@@ -14,24 +14,19 @@
 
 #include <filesystem>
 
-#include <cereal/archives/binary.hpp>
+#include <jstmap/global/jst_container.hpp>
 
 namespace jstmap
 {
 
+/*!\brief Writes the rcs store as sectioned jst container.
+ *
+ * \sa jstmap::save_jst
+ */
 template <typename rcs_store_t>
 void serialise(rcs_store_t const & rcs_store, std::filesystem::path const & output_path)
 {
-    using namespace std::literals;
-
-    std::ofstream output_stream{output_path.c_str()};
-    if (!output_stream.good())
-        throw std::runtime_error{"Couldn't open path for storing the rcs store! The path is ["s +
-                                 output_path.string() +
-                                 "]"s};
-
-    cereal::BinaryOutputArchive binary_archive{output_stream};
-    rcs_store.save(binary_archive);
+    save_jst(rcs_store, output_path);
 }
 
 } // namespace jstmap
@@ -12,8 +12,8 @@
 
 #include <algorithm>
 #include <charconv>
-#include <iostream>
 #include <ranges>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -23,43 +23,19 @@
 namespace jstmap
 {
 
-    void stripped_vcf_record::alternatives(rcs_store_t & store) const
+    void stripped_vcf_record::alternatives(rcs_store_t & store)
     {
-        if (_alternative_count != _genotypes.size())
-            throw std::logic_error{"Invalid number of coverages and alternative count."};
-
-        for (size_t i = 0; i < _alternative_count; ++i)
-        {
-            if (_alt[i][0] == '<') continue; // skip these alternatives for now
-
-            reference_t alt_sequence{_alt[i].begin(), _alt[i].end()};
-            variant_t variant{};
-
-            if (_ref.size() == _alt[i].size() && _ref.size() == 1) { // SNP
-                ++_stat->snv_count;
-                variant = variant_t{libjst::breakpoint{_pos, 1}, std::move(alt_sequence), std::move(_genotypes[i])};
-            } else { // generic alternative: SNP, InDel, etc.
-                ++_stat->indel_count;
-                continue; // skip for now!
-                // auto [fst_ref, fst_alt] = std::ranges::mismatch(_ref, _alt[i]); // first non equal ranges in the beginning
-                // auto ref_suffix = _ref | std::views::drop(std::ranges::distance(std::ranges::begin(_ref), fst_ref))
-                //                        | std::views::reverse;
-                // auto alt_suffix = _alt[i] | std::views::drop(std::ranges::distance(std::ranges::begin(_alt[i]), fst_alt))
-                //                           | std::views::reverse;
-                // auto [lst_ref_rev, lst_alt_rev] = std::ranges::mismatch(ref_suffix, alt_suffix);
-
-                // auto allele_view = std::ranges::subrange{fst_alt, lst_alt_rev.base()} | std::views::transform(
-                //     [] (char c) { return alphabet_t{c}; });
-                // std::vector<alphabet_t> allele{std::ranges::begin(allele_view), std::ranges::end(allele_view)};
-                // libjst::variant_deletion_t<indel_t> deletion = std::ranges::distance(fst_ref, lst_ref_rev.base());
-                // store.emplace(indel_t{_pos, std::move(allele), deletion}, std::move(_genotypes[i]));
-            }
+        for_each_alternative(store.source(), [&] (normalised_allele && allele, coverage_t && coverage) {
+            variant_t variant{libjst::breakpoint{allele.position, allele.deletion_size},
+                              std::move(allele.insertion),
+                              std::move(coverage)};
+
             if (!store.variants().has_conflicts(variant)) {
                 store.add(std::move(variant));
             } else {
-                std::cout << "CONFLICT\n";
+                ++_stat->conflict_count;
             }
-        }
+        });
     }
 
     stripped_vcf_record::genotypes_t const & stripped_vcf_record::field_genotype() const noexcept
@@ -106,30 +82,46 @@ namespace jstmap
     {
         _genotypes.resize(_alternative_count, coverage_t{_domain});
 
-        auto record_coverage = [&] (auto alt_first, auto alt_last, size_t const haplotype_idx) {
-            assert(haplotype_idx < _haplotype_count);
+        auto record_coverage = [&] (std::string_view const allele, size_t const haplotype_idx) {
+            assert(haplotype_idx < static_cast<size_t>(_haplotype_count));
+            uint32_t const haplotype_id = _filter->map_haplotype(haplotype_idx);
+            if (haplotype_id == variant_filter::unselected || allele == ".") // missing calls carry no alternative.
+                return;
+
             int32_t alt_index{};
-            if (std::from_chars(std::to_address(alt_first), std::to_address(alt_last), alt_index).ec != std::errc{})
+            auto [last, ec] = std::from_chars(allele.data(), allele.data() + allele.size(), alt_index);
+            if (ec != std::errc{} || last != allele.data() + allele.size() || alt_index > _alternative_count)
                 throw std::runtime_error{"Extracting haplotype failed!"};
 
             if (alt_index > 0) {
                 coverage_t & current_coverage = _genotypes[--alt_index];
-                current_coverage.insert(current_coverage.end(), haplotype_idx);
+                current_coverage.insert(current_coverage.end(), _haplotype_offset + haplotype_id);
             }
         };
 
         size_t haplotype_idx{};
         for (std::ptrdiff_t sample_idx = 0; sample_idx < _sample_count; ++sample_idx) {
-            // TODO: determine ploidy
+            // The genotype is the first subfield of every sample; it must list exactly one allele per haplotype.
             std::string_view genotype = read_field(genotypes);
-            auto genotype_it = genotype.begin();
-            // TODO: fix if more than 9 alternatives per position.
-            record_coverage(genotype_it, genotype_it + 1, haplotype_idx++);
-            genotype_it += 2;
-            record_coverage(genotype_it, genotype_it + 1, haplotype_idx++);
+            genotype = genotype.substr(0, genotype.find(':'));
+            size_t const separator = genotype.find_first_of("|/");
+            static_assert(sample_ploidy == 2, "The genotype parsing expects diploid samples.");
+            if (separator == genotype.npos || genotype.find_first_of("|/", separator + 1) != genotype.npos)
+                throw std::runtime_error{"Only diploid genotypes are supported, but the record at position " +
+                                         std::to_string(_pos + 1) + " contains the genotype [" +
+                                         std::string{genotype} + "]!"};
+
+            record_coverage(genotype.substr(0, separator), haplotype_idx++);
+            record_coverage(genotype.substr(separator + 1), haplotype_idx++);
         }
     }
 
+    bool stripped_vcf_record::is_supported_alternative(std::string_view alt) const noexcept
+    {
+        // Skips missing and spanning alleles (".", "*"), symbolic alleles ("<DEL>", ...) and breakends ("A[1:10[").
+        return !alt.empty() && alt != "." && alt != "*" && alt[0] != '<' && alt.find_first_of("[]") == alt.npos;
+    }
+
     std::string_view stripped_vcf_record::read_field(std::string_view & buffer) noexcept {
         auto delimiter_ptr = std::memchr(std::to_address(buffer.begin()), '\t', buffer.size());
         if (delimiter_ptr == nullptr) {
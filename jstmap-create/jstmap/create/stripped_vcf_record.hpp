@@ -22,12 +22,18 @@
 #include <libjst/coverage/range_domain.hpp>
 
 #include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/create/normalise_allele.hpp>
+#include <jstmap/create/variant_filter.hpp>
 
 namespace jstmap
 {
     struct variant_stat{
         size_t snv_count{};
+        size_t mnv_count{};
         size_t indel_count{};
+        size_t skipped_count{};
+        size_t filtered_count{};
+        size_t conflict_count{};
     };
     class stripped_vcf_record
     {
@@ -38,6 +44,8 @@ namespace jstmap
         using coverage_value_t = typename coverage_t::value_type;
         using domain_t = libjst::range_domain<coverage_value_t>;
 
+        inline static variant_filter const _select_all{};
+
         // relevant fields to set.
         std::string _ref{};
         std::string _chrom_name{};
@@ -45,6 +53,8 @@ namespace jstmap
         genotypes_t _genotypes{};
         domain_t _domain{};
         variant_stat * _stat{};
+        variant_filter const * _filter{&_select_all};
+        coverage_value_t _haplotype_offset{};
         position_t _pos{};
         int32_t _sample_count{};
         int32_t _haplotype_count{};
@@ -58,13 +68,19 @@ namespace jstmap
         stripped_vcf_record() = default;
 
         template <typename vcf_file_t>
-        stripped_vcf_record(vcf_file_t & vcf_file, domain_t domain, variant_stat & stat) :
+        stripped_vcf_record(vcf_file_t & vcf_file,
+                            domain_t domain,
+                            variant_stat & stat,
+                            coverage_value_t haplotype_offset = 0,
+                            variant_filter const & filter = _select_all) :
             _domain{std::move(domain)},
-            _stat{&stat}
+            _stat{&stat},
+            _filter{&filter},
+            _haplotype_offset{haplotype_offset}
         {
             auto & file_context = seqan2::context(vcf_file);
             _sample_count = seqan2::length(seqan2::sampleNames(file_context));
-            _haplotype_count = _sample_count << 1; // TODO: detect ploidy
+            _haplotype_count = _sample_count * sample_ploidy;
             read_record(file_context, directionIterator(vcf_file, seqan2::Input{}));
             _chrom_id = nameToId(contigNamesCache(file_context), seqan2::CharString{_chrom_name});
         }
@@ -76,7 +92,55 @@ namespace jstmap
         }
 
         genotypes_t const & field_genotype() const noexcept;
-        void alternatives(rcs_store_t &) const;
+        void alternatives(rcs_store_t &);
+
+        /*!\brief Invokes the callback with every supported alternative of this record.
+         *
+         * \param[in] source The reference sequence the record refers to.
+         * \param[in] callback The callback invoked with the jstmap::normalised_allele and its coverage.
+         *
+         * \details
+         *
+         * Unsupported and identity alleles as well as alternatives rejected by the jstmap::variant_filter are skipped.
+         * All alternatives are accounted in the variant statistics.
+         * The coverages are moved into the callback, so this function can be called only once per record.
+         */
+        template <typename source_t, typename callback_t>
+        void for_each_alternative(source_t const & source, callback_t && callback)
+        {
+            if (_alternative_count != _genotypes.size())
+                throw std::logic_error{"Invalid number of coverages and alternative count."};
+
+            for (size_t i = 0; i < _alternative_count; ++i)
+            {
+                if (!is_supported_alternative(_alt[i])) {
+                    ++_stat->skipped_count;
+                    continue;
+                }
+
+                if (!_filter->accepts(_genotypes[i].size())) {
+                    ++_stat->filtered_count;
+                    continue;
+                }
+
+                normalised_allele allele = normalise_allele(source, _pos, _ref, _alt[i]);
+                if (allele.is_identity()) {
+                    ++_stat->skipped_count;
+                    continue;
+                }
+
+                if (allele.deletion_size != allele.insertion.size()) { // InDel or complex substitution
+                    ++_stat->indel_count;
+                } else if (allele.deletion_size == 1) { // SNV
+                    ++_stat->snv_count;
+                } else { // MNV
+                    ++_stat->mnv_count;
+                }
+
+                _genotypes[i].optimise();
+                callback(std::move(allele), std::move(_genotypes[i]));
+            }
+        }
 
     private:
         void set_field_chrom(std::string_view);
@@ -89,6 +153,8 @@ namespace jstmap
 
         void set_field_genotype(std::string_view);
 
+        bool is_supported_alternative(std::string_view) const noexcept;
+
         std::string_view read_field(std::string_view &) noexcept;
 
         template <typename TForwardIter, typename TNameStore, typename TNameStoreCache, typename TStorageSpec>
@@ -0,0 +1,68 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the filter applied to the vcf records during the jst creation.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/create/variant_filter.hpp>
+
+namespace jstmap
+{
+
+    variant_filter make_variant_filter(std::vector<std::string> const & sample_names,
+                                       std::filesystem::path const & sample_file,
+                                       uint32_t min_carrier_count,
+                                       double min_allele_frequency)
+    {
+        using namespace std::literals;
+
+        variant_filter filter{.haplotype_count = static_cast<uint32_t>(sample_names.size() * sample_ploidy),
+                              .min_carrier_count = min_carrier_count,
+                              .min_allele_frequency = min_allele_frequency};
+
+        if (sample_file.empty())
+            return filter;
+
+        std::ifstream sample_stream{sample_file};
+        if (!sample_stream.good())
+            throw std::runtime_error{"Couldn't open the sample file! The path is ["s + sample_file.string() + "]"s};
+
+        std::unordered_set<std::string> selected_samples{};
+        for (std::string sample_name{}; std::getline(sample_stream, sample_name);) {
+            if (auto last = sample_name.find_last_not_of(" \t\r"); last != sample_name.npos)
+                selected_samples.insert(sample_name.substr(0, last + 1));
+        }
+
+        filter.haplotype_map.assign(sample_names.size() * sample_ploidy, variant_filter::unselected);
+        uint32_t selected_haplotype_count{};
+        for (size_t sample_idx = 0; sample_idx < sample_names.size(); ++sample_idx) {
+            if (selected_samples.erase(sample_names[sample_idx]) == 0)
+                continue;
+
+            for (uint32_t copy = 0; copy < sample_ploidy; ++copy)
+                filter.haplotype_map[sample_ploidy * sample_idx + copy] = selected_haplotype_count++;
+        }
+
+        for (std::string const & missing_sample : selected_samples)
+            log_warn("The sample ", missing_sample, " is not contained in the vcf file!");
+
+        if (selected_haplotype_count == 0)
+            throw std::runtime_error{"None of the samples in ["s + sample_file.string() + "] is contained in the "s +
+                                     "vcf file!"s};
+
+        filter.haplotype_count = selected_haplotype_count;
+        return filter;
+    }
+
+}  // namespace jstmap
@@ -0,0 +1,86 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the filter applied to the vcf records during the jst creation.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace jstmap
+{
+    /*!\brief The number of haplotypes of every vcf sample.
+     *
+     * \details
+     *
+     * Only diploid genotypes are supported. The vcf parser rejects records with genotypes of any other ploidy.
+     */
+    inline constexpr uint32_t sample_ploidy = 2;
+
+    /*!\brief Selects the haplotypes and alternatives that are added to the jst.
+     *
+     * \details
+     *
+     * The haplotype map assigns every haplotype of the vcf file its compacted id in the coverage domain.
+     * Haplotypes of unselected samples are mapped to jstmap::variant_filter::unselected.
+     * An alternative is kept if the number of selected haplotypes carrying it reaches the minimal carrier count
+     * and its frequency among the selected haplotypes reaches the minimal allele frequency.
+     * An alternative without carriers is only kept if the filter keeps uncarried alternatives, which is required to
+     * remove the carriers of a variant, e.g. when an updated record is genotyped without alternative alleles.
+     */
+    struct variant_filter
+    {
+        static constexpr uint32_t unselected = std::numeric_limits<uint32_t>::max();
+
+        std::vector<uint32_t> haplotype_map{}; //!< The compacted id per vcf haplotype; empty if all are selected.
+        uint32_t haplotype_count{}; //!< The number of selected haplotypes.
+        uint32_t min_carrier_count{}; //!< The minimal number of selected haplotypes carrying an alternative.
+        double min_allele_frequency{}; //!< The minimal frequency of an alternative among the selected haplotypes.
+        bool keep_uncarried{false}; //!< Whether alternatives without any carrier are kept.
+
+        //!\brief Returns the id of the haplotype within the coverage domain or jstmap::variant_filter::unselected.
+        constexpr uint32_t map_haplotype(size_t const vcf_haplotype_idx) const noexcept
+        {
+            return haplotype_map.empty() ? static_cast<uint32_t>(vcf_haplotype_idx) : haplotype_map[vcf_haplotype_idx];
+        }
+
+        //!\brief Whether an alternative carried by the given number of selected haplotypes is kept.
+        constexpr bool accepts(size_t const carrier_count) const noexcept
+        {
+            if (carrier_count == 0)
+                return keep_uncarried;
+            if (carrier_count < min_carrier_count)
+                return false;
+
+            return min_allele_frequency <= 0.0 ||
+                   static_cast<double>(carrier_count) >= min_allele_frequency * haplotype_count;
+        }
+    };
+
+    /*!\brief Creates the variant filter for the samples of a vcf file.
+     *
+     * \param[in] sample_names The sample names in the order of the vcf header.
+     * \param[in] sample_file A file listing one sample name per line; if empty, all samples are selected.
+     * \param[in] min_carrier_count The minimal number of haplotypes carrying an alternative.
+     * \param[in] min_allele_frequency The minimal allele frequency of an alternative.
+     *
+     * \throws std::runtime_error if the sample file can not be read or selects none of the vcf samples.
+     */
+    variant_filter make_variant_filter(std::vector<std::string> const & sample_names,
+                                       std::filesystem::path const & sample_file,
+                                       uint32_t min_carrier_count,
+                                       double min_allele_frequency);
+}  // namespace jstmap
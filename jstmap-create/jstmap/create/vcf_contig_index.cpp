@@ -0,0 +1,53 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides an index over the contig blocks of a vcf file.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+
+#include <jstmap/create/vcf_contig_index.hpp>
+
+namespace jstmap
+{
+
+    std::vector<vcf_contig_block> index_vcf_contigs(std::filesystem::path const & vcf_file_path)
+    {
+        using namespace std::literals;
+
+        std::ifstream vcf_stream{vcf_file_path, std::ios::binary};
+        if (!vcf_stream.good())
+            throw std::runtime_error{"Couldn't open the vcf file! The path is ["s + vcf_file_path.string() + "]"s};
+
+        std::vector<vcf_contig_block> contig_blocks{};
+        std::unordered_set<std::string> visited_contigs{};
+        std::string line{};
+        for (uint64_t line_offset = vcf_stream.tellg(); std::getline(vcf_stream, line); line_offset = vcf_stream.tellg()) {
+            if (line.empty() || line.front() == '#')
+                continue;
+
+            std::string_view contig_name{line.data(), std::min(line.find('\t'), line.size())};
+            if (contig_blocks.empty() || contig_blocks.back().contig_name != contig_name) {
+                if (!visited_contigs.emplace(contig_name).second)
+                    throw std::runtime_error{"The records of contig <"s + std::string{contig_name} + "> are not "s +
+                                             "stored consecutively in the vcf file!"s};
+
+                contig_blocks.push_back(vcf_contig_block{.contig_name = std::string{contig_name},
+                                                         .file_offset = line_offset});
+            }
+            ++contig_blocks.back().record_count;
+        }
+        return contig_blocks;
+    }
+
+}  // namespace jstmap
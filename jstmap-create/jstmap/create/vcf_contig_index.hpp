@@ -0,0 +1,40 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides an index over the contig blocks of a vcf file.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace jstmap
+{
+    //!\brief The block of consecutive records of one contig within a vcf file.
+    struct vcf_contig_block
+    {
+        std::string contig_name{}; //!< The name of the contig.
+        uint64_t file_offset{}; //!< The byte offset of the first record of the contig.
+        uint64_t record_count{}; //!< The number of records of the contig.
+    };
+
+    /*!\brief Scans the records of an uncompressed vcf file and returns the block of every contig.
+     *
+     * \details
+     *
+     * The vcf file must be sorted such that the records of a contig are stored consecutively.
+     * Only the contig column is inspected, so the scan is bounded by the disk throughput.
+     *
+     * \throws std::runtime_error if the file can not be read or the records of a contig are interleaved with others.
+     */
+    std::vector<vcf_contig_block> index_vcf_contigs(std::filesystem::path const &);
+}  // namespace jstmap
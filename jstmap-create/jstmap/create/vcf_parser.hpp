@@ -15,11 +15,12 @@
 #include <filesystem>
 
 #include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/create/options.hpp>
 
 namespace jstmap
 {
 
 // read them all
-void construct_jst_from_vcf2(std::filesystem::path const &, std::filesystem::path const &, std::filesystem::path const &);
+void construct_jst_from_vcf2(create_options const &);
 
 }  // namespace jstmap
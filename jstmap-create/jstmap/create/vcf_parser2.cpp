@@ -13,187 +13,200 @@
 #include <algorithm>
 #include <charconv>
 #include <chrono>
+#include <exception>
+#include <numeric>
 #include <ranges>
 #include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <seqan/vcf_io.h>
 
 #include <seqan3/io/record.hpp>
 
 #include <jstmap/global/application_logger.hpp>
+#include <jstmap/create/vcf_contig_index.hpp>
 #include <jstmap/create/vcf_parser.hpp>
 #include <jstmap/create/stripped_vcf_record.hpp>
 #include <jstmap/create/serialise_jst.hpp>
 
 namespace jstmap
 {
-inline reference_t load_base_sequence(std::filesystem::path const & reference_file, std::string_view contig_name)
+// Loads the sequences of all contig blocks in one pass over the reference file.
+inline std::vector<reference_t> load_contig_sequences(std::filesystem::path const & reference_file,
+                                                      std::vector<vcf_contig_block> const & contig_blocks)
 {
     using namespace std::literals;
-    seqan3::sequence_file_input<sequence_input_traits> record_contig_names{reference_file};
 
-    std::string chr_id = /*"chr"s + */std::string{contig_name};
-    for (auto && record : record_contig_names) {
-        if (record.id().starts_with(chr_id))
-            return record.sequence();
+    std::unordered_map<std::string_view, size_t> contig_ids{};
+    for (size_t contig_idx = 0; contig_idx < contig_blocks.size(); ++contig_idx)
+        contig_ids.emplace(contig_blocks[contig_idx].contig_name, contig_idx);
+
+    std::vector<reference_t> contig_sequences(contig_blocks.size());
+    std::vector<bool> is_loaded(contig_blocks.size(), false);
+    size_t loaded_count{};
+    seqan3::sequence_file_input<sequence_input_traits> reference_input{reference_file};
+    for (auto && record : reference_input) {
+        // The contig name is the first word of the id; the remaining words describe the sequence.
+        std::string_view id{record.id()};
+        auto it = contig_ids.find(id.substr(0, id.find_first_of(" \t")));
+        if (it == contig_ids.end() || is_loaded[it->second])
+            continue;
+
+        contig_sequences[it->second] = std::move(record.sequence());
+        is_loaded[it->second] = true;
+        if (++loaded_count == contig_blocks.size())
+            break;
     }
-    throw std::runtime_error{"Could not find a contig with the name <"s + chr_id + ">!"s};
-    return {};
+
+    for (size_t contig_idx = 0; contig_idx < contig_blocks.size(); ++contig_idx)
+        if (!is_loaded[contig_idx])
+            throw std::runtime_error{"Could not find a contig with the name <"s + contig_blocks[contig_idx].contig_name +
+                                     ">!"s};
+
+    return contig_sequences;
 }
 
-inline reference_t reference_for_record(std::filesystem::path const & reference_file_path,
-                                        seqan2::VcfFileIn const & vcf_file,
-                                        seqan2::VcfRecord const & record) {
-    // Load reference sequence!
-    return load_base_sequence(reference_file_path,
-                              seqan2::toCString(seqan2::contigNames(seqan2::context(vcf_file))[record.rID]));
+// Returns the output path of the jst of the given contig. Multiple contigs are distinguished by a name suffix.
+inline std::filesystem::path output_path_for(std::filesystem::path const & output_file,
+                                             std::string_view contig_name,
+                                             bool const has_multiple_contigs)
+{
+    if (!has_multiple_contigs)
+        return output_file;
+
+    std::filesystem::path contig_file = output_file.stem();
+    contig_file += "_" + std::string{contig_name};
+    contig_file += output_file.extension();
+    return std::filesystem::path{output_file}.replace_filename(contig_file);
 }
 
-void construct_jst_from_vcf2(std::filesystem::path const & reference_file,
-                             std::filesystem::path const & vcf_file_path,
-                             std::filesystem::path const & out_file_path)
+// Parses the records of one contig block from its own file handle and serialises the resulting rcs store.
+inline variant_stat construct_contig_jst(create_options const & options,
+                                         variant_filter const & filter,
+                                         vcf_contig_block const & contig_block,
+                                         reference_t contig_sequence,
+                                         std::filesystem::path const & output_path)
 {
-    // Get the application logger.
-    auto & log = get_application_logger();
+    seqan2::VcfFileIn vcf_file{options.vcf_file.c_str()};
+    seqan2::VcfHeader vcf_header{};
+    seqan2::readHeader(vcf_header, vcf_file);
+    seqan2::setPosition(vcf_file, contig_block.file_offset);
+
+    rcs_store_t rcs_store{std::move(contig_sequence), filter.haplotype_count};
+    variant_stat stat{};
+    for (uint64_t record_idx = 0; record_idx < contig_block.record_count; ++record_idx) {
+        stripped_vcf_record record{vcf_file, rcs_store.variants().coverage_domain(), stat, 0, filter};
+        record.alternatives(rcs_store);
+    }
+
+    serialise(rcs_store, output_path);
+    return stat;
+}
 
+void construct_jst_from_vcf2(create_options const & options)
+{
     auto duration = [] (auto const & start) {
         return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() -
                     start).count();
     };
 
     // ----------------------------------------------------------------------------
-    // Parse the vcf file.
+    // Index the contig blocks of the vcf file.
     // ----------------------------------------------------------------------------
 
-    log(verbosity_level::verbose, logging_level::info, "Initialise parsing vcf file ", vcf_file_path);
-
-    // ----------------------------------------------------------------------------
-    // Open vcf file handle.
-    seqan2::VcfFileIn vcf_file{vcf_file_path.c_str()};
-    seqan2::VcfHeader vcf_header{};
-    seqan2::readHeader(vcf_header, vcf_file);
+    log_debug("Initialise parsing vcf file ", options.vcf_file);
+    auto start = std::chrono::high_resolution_clock::now();
 
-    if (seqan2::atEnd(vcf_file))
+    std::vector<std::string> sample_names{};
     {
-        log(verbosity_level::standard,
-            logging_level::warning,
-            "The vcf file ", vcf_file_path, " does not contain any records!");
-        return;
+        seqan2::VcfFileIn vcf_file{options.vcf_file.c_str()};
+        seqan2::VcfHeader vcf_header{};
+        seqan2::readHeader(vcf_header, vcf_file);
+        for (auto const & sample_name : seqan2::sampleNames(seqan2::context(vcf_file)))
+            sample_names.emplace_back(seqan2::toCString(sample_name));
     }
 
-    // ----------------------------------------------------------------------------
-    // Transform vcf record into intermediate variants.
-
-    auto start = std::chrono::high_resolution_clock::now();
-
-    seqan2::VcfRecord record{};
-    seqan2::readRecord(record, vcf_file);
-    reference_t reference = reference_for_record(reference_file, vcf_file, record);
-    uint32_t haplotype_count = seqan2::length(seqan2::sampleNames(seqan2::context(vcf_file))) * 2;
-    std::cout << "haplotype_count: " << haplotype_count << "\n";
-
-    log(verbosity_level::verbose,
-        logging_level::info,
-        "Loading reference sequence: ", duration(start), " s");
-
-    // ----------------------------------------------------------------------------
-    // Parsing vcf records
-    // ----------------------------------------------------------------------------
-
-    start = std::chrono::high_resolution_clock::now();
-    rcs_store_t rcs_store{std::move(reference), haplotype_count};
-    log_info("Haplotype count: ", haplotype_count);
-    size_t record_count{0};
-    variant_stat stat{};
-    while (!seqan2::atEnd(vcf_file))
-    {
-        // if (record_count++ % 1000 == 0) {
-        //     log_debug("Processing record: ", record_count);
-        // }
-        stripped_vcf_record tmp_record{vcf_file, rcs_store.variants().coverage_domain(), stat};
-        tmp_record.alternatives(rcs_store);
+    std::vector<vcf_contig_block> const contig_blocks = index_vcf_contigs(options.vcf_file);
+    if (contig_blocks.empty()) {
+        log_warn("The vcf file ", options.vcf_file, " does not contain any records!");
+        return;
     }
+    log_debug("Time indexing vcf: ", duration(start), " s");
 
-    log_info("Time parsing vcf: ", duration(start), " s");
-    log_info("#SNVs: ", stat.snv_count);
-    log_info("#InDels: ", stat.indel_count);
+    variant_filter const filter = make_variant_filter(sample_names,
+                                                      options.sample_file,
+                                                      options.min_carrier_count,
+                                                      options.min_allele_frequency);
+    log_info("Haplotype count: ", filter.haplotype_count, " of ", sample_names.size() * sample_ploidy);
+    log_info("Contig count: ", contig_blocks.size());
 
-    // // ----------------------------------------------------------------------------
-    // // Sort the variants.  VCF is sorted by specification?
-
-    // // different model representations -> so the forward_jst is over the reference and the sorted objects model
-    // start = std::chrono::high_resolution_clock::now();
-    // libjst::variant_store_sorted<variant_store_t> sorted_store{intermediate_variant_store};
-    // log(verbosity_level::verbose,
-    //     logging_level::info,
-    //     "Time sorting jst: ", duration(start), " s");
-
-    // // ----------------------------------------------------------------------------
-    // // Resolve ambiguities.
-    // start = std::chrono::high_resolution_clock::now();
-
-    // auto first = std::ranges::begin(rcs_store);
-    // auto last = std::ranges::end(rcs_store);
-
-    // auto resolve_coverage = [] (auto first, auto last, auto && cmp)
-    // {
-    //     auto overlap_end = std::ranges::find_if(first, last, std::forward<decltype(cmp)>(cmp));
-    //     for (; first != overlap_end; ++first) {
-    //         for (auto it = std::ranges::next(first, 1, overlap_end); it != overlap_end; ++it) {
-    //                 (libjst::coverage(*it)).and_not(libjst::coverage(*first));
-    //         }
-    //     }
-    //     return first;
-    // };
-
-    // auto effective_size = [](auto const &variant) {
-    //     return std::ranges::size(libjst::insertion(variant)) - libjst::deletion(variant);
-    // };
-
-    // while (first != last) {
-    //     // find first adjacent position overlap
-    //     first = std::ranges::adjacent_find(first, last, [] (auto const & lhs, auto const & rhs) {
-    //         return libjst::position(lhs) == libjst::position(rhs);
-    //     });
-
-    //     // Resolve overlaps of insertions at current position overlap
-    //     first = resolve_coverage(first, last, [&](auto const & variant) {
-    //         return libjst::position(variant) != libjst::position(*first) || effective_size(variant) <= 0;
-    //     });
-
-    //     // Resolve overlaps of remaining variants at current position overlap
-    //     first = resolve_coverage(first, last, [&](auto const & variant) {
-    //         return libjst::position(variant) != libjst::position(*first);
-    //     });
-    // }
-
-    // log(verbosity_level::verbose,
-    //     logging_level::info,
-    //     "Time resolving ambiguities in store: ", duration(start), " s");
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<reference_t> contig_sequences = load_contig_sequences(options.sequence_file, contig_blocks);
+    log_debug("Time loading contig sequences: ", duration(start), " s");
 
     // ----------------------------------------------------------------------------
-    // Generate jst model
+    // Construct one rcs store per contig.
     // ----------------------------------------------------------------------------
 
-    // start = std::chrono::high_resolution_clock::now();
-    // fwd_jst_t fwd_jst{jst};
-
-    // log(verbosity_level::verbose,
-    //     logging_level::info,
-    //     "Time building forward layer: ", duration(start), " s");
+    // Start with the largest contigs so that the smaller ones fill up the idle threads at the end.
+    std::vector<size_t> build_order(contig_blocks.size());
+    std::iota(build_order.begin(), build_order.end(), 0);
+    std::ranges::stable_sort(build_order, std::ranges::greater{}, [&] (size_t const idx) {
+        return contig_blocks[idx].record_count;
+    });
 
-    // ----------------------------------------------------------------------------
-    // Serialise rcs_store
-    // ----------------------------------------------------------------------------
+    bool const has_multiple_contigs = contig_blocks.size() > 1;
+    std::vector<variant_stat> contig_stats(contig_blocks.size());
+    std::vector<std::exception_ptr> contig_errors(contig_blocks.size());
 
     start = std::chrono::high_resolution_clock::now();
+    #pragma omp parallel for num_threads(options.thread_count) schedule(dynamic, 1)
+    for (size_t order_idx = 0; order_idx < build_order.size(); ++order_idx) {
+        size_t const contig_idx = build_order[order_idx];
+        vcf_contig_block const & contig_block = contig_blocks[contig_idx];
+        try {
+            contig_stats[contig_idx] = construct_contig_jst(options,
+                                                            filter,
+                                                            contig_block,
+                                                            std::move(contig_sequences[contig_idx]),
+                                                            output_path_for(options.output_file,
+                                                                            contig_block.contig_name,
+                                                                            has_multiple_contigs));
+        } catch (...) {
+            contig_errors[contig_idx] = std::current_exception();
+        }
+    }
+
+    for (std::exception_ptr const & error : contig_errors)
+        if (error)
+            std::rethrow_exception(error);
 
-    serialise(rcs_store, out_file_path);
+    log_info("Time constructing jst: ", duration(start), " s");
 
-    log(verbosity_level::verbose,
-        logging_level::info,
-        "Time serialising jst: ", duration(start), " s");
+    variant_stat stat{};
+    for (size_t contig_idx = 0; contig_idx < contig_blocks.size(); ++contig_idx) {
+        variant_stat const & contig_stat = contig_stats[contig_idx];
+        log_debug("Contig ", contig_blocks[contig_idx].contig_name, ": ", contig_blocks[contig_idx].record_count,
+                  " records written to ", output_path_for(options.output_file,
+                                                          contig_blocks[contig_idx].contig_name,
+                                                          has_multiple_contigs));
+        stat.snv_count += contig_stat.snv_count;
+        stat.mnv_count += contig_stat.mnv_count;
+        stat.indel_count += contig_stat.indel_count;
+        stat.skipped_count += contig_stat.skipped_count;
+        stat.filtered_count += contig_stat.filtered_count;
+        stat.conflict_count += contig_stat.conflict_count;
+    }
+
+    log_info("#SNVs: ", stat.snv_count);
+    log_info("#MNVs: ", stat.mnv_count);
+    log_info("#InDels: ", stat.indel_count);
+    log_info("#Skipped alternatives: ", stat.skipped_count);
+    log_info("#Filtered alternatives: ", stat.filtered_count);
+    log_info("#Conflicting alternatives: ", stat.conflict_count);
 }
 
 }  // namespace jstmap
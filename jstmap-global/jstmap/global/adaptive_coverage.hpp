@@ -0,0 +1,665 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a coverage that adapts its representation to the density of the covered haplotypes.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cereal/types/vector.hpp>
+
+#include <libspm/std/tag_invoke.hpp>
+
+#include <libjst/coverage/concept.hpp>
+#include <libjst/coverage/range_domain.hpp>
+
+namespace jstmap
+{
+    //!\brief The representation used by an jstmap::adaptive_coverage.
+    enum struct coverage_kind : uint8_t
+    {
+        sparse, //!< Sorted list of haplotype ids.
+        dense, //!< One bit per haplotype.
+        runs //!< Sorted list of half-open id intervals.
+    };
+
+    /*!\brief A coverage that switches between a sparse, a dense and a run-length representation.
+     *
+     * \tparam value_t The type of the haplotype ids.
+     *
+     * \details
+     *
+     * Haplotype ids are inserted in ascending order into the sparse representation.
+     * Calling jstmap::adaptive_coverage::optimise selects the representation with the smallest memory footprint.
+     * Rare variants stay a short id list. Common variants become a bitvector. Variants shared by contiguous
+     * blocks of haplotypes, e.g. population specific ones, become a short interval list.
+     * The set operations used by the coloured tree dispatch on the representations of both operands.
+     * Two bitvectors are combined word by word in tight loops that the compiler vectorises.
+     * Sparse operands are filtered through membership tests and run lists are merged interval by interval.
+     * The results keep the representation their operation produces and are not optimised again, since they are
+     * short-lived along the traversed paths; the coverages of the store are optimised once when they are built.
+     */
+    template <std::unsigned_integral value_t>
+    class adaptive_coverage
+    {
+    public:
+        using value_type = value_t;
+        using size_type = size_t;
+        using domain_type = libjst::range_domain<value_t>;
+        using word_type = uint64_t;
+
+        class iterator;
+        using const_iterator = iterator;
+
+    private:
+        static constexpr size_t word_size = std::numeric_limits<word_type>::digits;
+
+        //!\brief Stores the sparse ids or the flattened run boundaries depending on the current kind.
+        std::vector<value_type> _values{};
+        std::vector<word_type> _words{};
+        domain_type _domain{};
+        size_type _count{};
+        coverage_kind _kind{coverage_kind::sparse};
+
+    public:
+
+        adaptive_coverage() = default;
+        explicit adaptive_coverage(domain_type domain) noexcept : _domain{std::move(domain)}
+        {}
+
+        adaptive_coverage(std::initializer_list<value_type> ids, domain_type domain) :
+            adaptive_coverage{std::move(domain)}
+        {
+            for (value_type id : ids)
+                insert(end(), id);
+        }
+
+        //!\brief Inserts the id into the coverage. Ids inserted in ascending order take constant time.
+        iterator insert([[maybe_unused]] const_iterator hint, value_type const id)
+        {
+            if (_kind != coverage_kind::sparse)
+                convert_to_sparse();
+
+            auto it = _values.end();
+            if (!_values.empty() && _values.back() >= id)
+                it = std::ranges::lower_bound(_values, id);
+
+            if (it != _values.end() && *it == id)
+                return iterator{this, static_cast<size_t>(it - _values.begin()), id};
+
+            it = _values.insert(it, id);
+            ++_count;
+            return iterator{this, static_cast<size_t>(it - _values.begin()), id};
+        }
+
+        //!\brief Whether the id is covered.
+        constexpr bool contains(value_type const id) const noexcept
+        {
+            switch (_kind) {
+                case coverage_kind::dense: return test_bit(_words, id);
+                case coverage_kind::runs: {
+                    size_t const run_count = _values.size() >> 1;
+                    size_t low = 0, high = run_count;
+                    while (low < high) { // first run whose end is greater than the id.
+                        size_t mid = (low + high) >> 1;
+                        if (_values[(mid << 1) + 1] <= id)
+                            low = mid + 1;
+                        else
+                            high = mid;
+                    }
+                    return low < run_count && _values[low << 1] <= id;
+                }
+                default: return std::ranges::binary_search(_values, id);
+            }
+        }
+
+        //!\brief Selects the representation with the smallest memory footprint.
+        void optimise()
+        {
+            if (_count == 0) {
+                clear();
+                return;
+            }
+
+            value_type const max_id = back();
+            size_t const sparse_bytes = _count * sizeof(value_type);
+            size_t const dense_bytes = word_count_for(max_id) * sizeof(word_type);
+            size_t const runs_bytes = count_runs() * 2 * sizeof(value_type);
+
+            if (runs_bytes < sparse_bytes && runs_bytes < dense_bytes)
+                convert_to_runs();
+            else if (dense_bytes < sparse_bytes)
+                convert_to_dense(max_id);
+            else
+                convert_to_sparse();
+
+            _values.shrink_to_fit();
+            _words.shrink_to_fit();
+        }
+
+        //!\brief Returns the ids covered by this but not by the other coverage.
+        adaptive_coverage and_not(adaptive_coverage const & other) const
+        {
+            return difference(*this, other);
+        }
+
+        constexpr coverage_kind kind() const noexcept { return _kind; }
+        constexpr domain_type const & get_domain() const noexcept { return _domain; }
+        constexpr size_type size() const noexcept { return _count; }
+        constexpr bool empty() const noexcept { return _count == 0; }
+        constexpr bool any() const noexcept { return !empty(); }
+
+        void clear() noexcept
+        {
+            _values.clear();
+            _words.clear();
+            _count = 0;
+            _kind = coverage_kind::sparse;
+        }
+
+        iterator begin() const noexcept { return iterator{this}; }
+        iterator end() const noexcept { return iterator{this, end_tag{}}; }
+
+        template <typename archive_t>
+        void save(archive_t & archive) const
+        {
+            archive(static_cast<uint8_t>(_kind), _count, _values, _words, _domain);
+        }
+
+        template <typename archive_t>
+        void load(archive_t & archive)
+        {
+            uint8_t kind{};
+            archive(kind, _count, _values, _words, _domain);
+            _kind = static_cast<coverage_kind>(kind);
+        }
+
+    private:
+
+        struct end_tag{};
+
+        // ----------------------------------------------------------------------------
+        // Set operations
+        // ----------------------------------------------------------------------------
+
+        static adaptive_coverage intersection(adaptive_coverage const & first, adaptive_coverage const & second)
+        {
+            adaptive_coverage result{first._domain};
+            if (first.empty() || second.empty())
+                return result;
+
+            if (first._kind == coverage_kind::sparse && second._kind == coverage_kind::sparse) {
+                result._values.reserve(std::min(first._count, second._count));
+                std::ranges::set_intersection(first._values, second._values, std::back_inserter(result._values));
+                result._count = result._values.size();
+            } else if (first._kind == coverage_kind::sparse || second._kind == coverage_kind::sparse) {
+                auto const & [sparse, other] = (first._kind == coverage_kind::sparse) ? std::tie(first, second)
+                                                                                       : std::tie(second, first);
+                result._values.reserve(sparse._count);
+                std::ranges::copy_if(sparse._values, std::back_inserter(result._values),
+                                     [&] (value_type const id) { return other.contains(id); });
+                result._count = result._values.size();
+            } else if (first._kind == coverage_kind::runs && second._kind == coverage_kind::runs) {
+                intersect_runs(first._values, second._values, result);
+            } else if (first._kind == coverage_kind::runs || second._kind == coverage_kind::runs) {
+                auto const & [runs, dense] = (first._kind == coverage_kind::runs) ? std::tie(first, second)
+                                                                                   : std::tie(second, first);
+                result._words.assign(std::min(dense._words.size(), word_count_for(runs.back())), 0);
+                for_each_run_mask(runs._values, result._words.size(), [&] (size_t const word_idx, word_type mask) {
+                    result._words[word_idx] |= dense._words[word_idx] & mask;
+                });
+                result._count = popcount_words(result._words.data(), result._words.size());
+                result._kind = coverage_kind::dense;
+            } else {
+                result._words.resize(std::min(first._words.size(), second._words.size()));
+                result._count = and_words(result._words.data(), first._words.data(), second._words.data(),
+                                          result._words.size());
+                result._kind = coverage_kind::dense;
+            }
+
+            if (result.empty())
+                result.clear();
+            return result;
+        }
+
+        static adaptive_coverage difference(adaptive_coverage const & first, adaptive_coverage const & second)
+        {
+            if (first.empty() || second.empty())
+                return first;
+
+            adaptive_coverage result{first._domain};
+            switch (first._kind) {
+                case coverage_kind::dense: {
+                    result._words = first._words;
+                    switch (second._kind) {
+                        case coverage_kind::dense: {
+                            and_not_words(result._words.data(), second._words.data(),
+                                          std::min(result._words.size(), second._words.size()));
+                            break;
+                        }
+                        case coverage_kind::runs: {
+                            for_each_run_mask(second._values, result._words.size(),
+                                              [&] (size_t const word_idx, word_type const mask) {
+                                result._words[word_idx] &= ~mask;
+                            });
+                            break;
+                        }
+                        default: {
+                            for (value_type id : second._values)
+                                if (id < result._words.size() * word_size)
+                                    result._words[id / word_size] &= ~(word_type{1} << (id % word_size));
+                        }
+                    }
+                    result._count = popcount_words(result._words.data(), result._words.size());
+                    result._kind = coverage_kind::dense;
+                    break;
+                }
+                case coverage_kind::runs: {
+                    switch (second._kind) {
+                        case coverage_kind::dense: {
+                            result._words.assign(word_count_for(first.back()), 0);
+                            for_each_run_mask(first._values, result._words.size(),
+                                              [&] (size_t const word_idx, word_type const mask) {
+                                result._words[word_idx] |= mask;
+                            });
+                            and_not_words(result._words.data(), second._words.data(),
+                                          std::min(result._words.size(), second._words.size()));
+                            result._count = popcount_words(result._words.data(), result._words.size());
+                            result._kind = coverage_kind::dense;
+                            break;
+                        }
+                        case coverage_kind::runs: {
+                            subtract_runs(first._values, second._values.size() >> 1, [&] (size_t const idx) {
+                                return std::pair{second._values[idx << 1], second._values[(idx << 1) + 1]};
+                            }, result);
+                            break;
+                        }
+                        default: {
+                            subtract_runs(first._values, second._values.size(), [&] (size_t const idx) {
+                                return std::pair{second._values[idx], static_cast<value_type>(second._values[idx] + 1)};
+                            }, result);
+                        }
+                    }
+                    break;
+                }
+                default: {
+                    result._values.reserve(first._count);
+                    if (second._kind == coverage_kind::sparse)
+                        std::ranges::set_difference(first._values, second._values, std::back_inserter(result._values));
+                    else
+                        std::ranges::copy_if(first._values, std::back_inserter(result._values),
+                                             [&] (value_type const id) { return !second.contains(id); });
+                    result._count = result._values.size();
+                }
+            }
+
+            if (result.empty())
+                result.clear();
+            return result;
+        }
+
+        // ----------------------------------------------------------------------------
+        // Run kernels
+        // ----------------------------------------------------------------------------
+
+        //!\brief Intersects two run lists by merging their intervals.
+        static void intersect_runs(std::vector<value_type> const & first,
+                                   std::vector<value_type> const & second,
+                                   adaptive_coverage & result)
+        {
+            result._values.reserve(first.size() + second.size());
+            for (size_t i = 0, j = 0; i < first.size() && j < second.size();) {
+                value_type const low = std::max(first[i], second[j]);
+                value_type const high = std::min(first[i + 1], second[j + 1]);
+                if (low < high) {
+                    result._values.insert(result._values.end(), {low, high});
+                    result._count += high - low;
+                }
+                if (first[i + 1] < second[j + 1])
+                    i += 2;
+                else
+                    j += 2;
+            }
+            result._kind = coverage_kind::runs;
+        }
+
+        //!\brief Removes the ascending intervals returned by `get_interval` from the runs.
+        template <typename get_interval_t>
+        static void subtract_runs(std::vector<value_type> const & runs,
+                                  size_t const interval_count,
+                                  get_interval_t && get_interval,
+                                  adaptive_coverage & result)
+        {
+            auto emit = [&] (value_type const low, value_type const high) {
+                result._values.insert(result._values.end(), {low, high});
+                result._count += high - low;
+            };
+
+            size_t idx{};
+            for (size_t run = 0; run < runs.size(); run += 2) {
+                value_type current = runs[run];
+                value_type const run_end = runs[run + 1];
+                while (idx < interval_count && get_interval(idx).second <= current)
+                    ++idx;
+                for (; idx < interval_count; ++idx) {
+                    auto const [low, high] = get_interval(idx);
+                    if (low >= run_end)
+                        break;
+                    if (current < low)
+                        emit(current, low);
+                    current = std::max(current, high);
+                    if (current >= run_end) // The interval may overlap the next run as well.
+                        break;
+                }
+                if (current < run_end)
+                    emit(current, run_end);
+            }
+            result._kind = coverage_kind::runs;
+        }
+
+        //!\brief Calls the function with the mask of every word overlapped by the runs, up to the word count.
+        template <typename word_function_t>
+        static void for_each_run_mask(std::vector<value_type> const & runs,
+                                      size_t const word_count,
+                                      word_function_t && word_function)
+        {
+            size_t const bit_count = word_count * word_size;
+            for (size_t run = 0; run < runs.size(); run += 2) {
+                size_t const first_bit = runs[run];
+                size_t const last_bit = std::min<size_t>(runs[run + 1], bit_count);
+                if (first_bit >= last_bit)
+                    break;
+
+                size_t const first_word = first_bit / word_size;
+                size_t const last_word = (last_bit - 1) / word_size;
+                for (size_t word_idx = first_word; word_idx <= last_word; ++word_idx) {
+                    size_t const low = (word_idx == first_word) ? first_bit % word_size : 0;
+                    size_t const high = (word_idx == last_word) ? (last_bit - 1) % word_size : word_size - 1;
+                    word_function(word_idx, (~word_type{0} << low) & (~word_type{0} >> (word_size - 1 - high)));
+                }
+            }
+        }
+
+        // ----------------------------------------------------------------------------
+        // Word kernels
+        // ----------------------------------------------------------------------------
+
+        static size_t and_words(word_type * __restrict target,
+                                word_type const * __restrict first,
+                                word_type const * __restrict second,
+                                size_t const count) noexcept
+        {
+            size_t ones{};
+            for (size_t i = 0; i < count; ++i) {
+                target[i] = first[i] & second[i];
+                ones += std::popcount(target[i]);
+            }
+            return ones;
+        }
+
+        static void and_not_words(word_type * __restrict target,
+                                  word_type const * __restrict second,
+                                  size_t const count) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+                target[i] &= ~second[i];
+        }
+
+        static size_t popcount_words(word_type const * words, size_t const count) noexcept
+        {
+            size_t ones{};
+            for (size_t i = 0; i < count; ++i)
+                ones += std::popcount(words[i]);
+            return ones;
+        }
+
+        static constexpr bool test_bit(std::vector<word_type> const & words, value_type const id) noexcept
+        {
+            size_t const word_idx = id / word_size;
+            return word_idx < words.size() && (words[word_idx] >> (id % word_size)) & 1;
+        }
+
+        static constexpr size_t word_count_for(value_type const max_id) noexcept
+        {
+            return (static_cast<size_t>(max_id) + word_size) / word_size;
+        }
+
+        // ----------------------------------------------------------------------------
+        // Conversions
+        // ----------------------------------------------------------------------------
+
+        //!\brief Returns the dense words, materialising them into the buffer if the coverage is not dense.
+        std::vector<word_type> const & words_view(std::vector<word_type> & buffer) const
+        {
+            if (_kind == coverage_kind::dense)
+                return _words;
+
+            buffer.assign(word_count_for(back()), 0);
+            if (_kind == coverage_kind::sparse) {
+                for (value_type id : _values)
+                    buffer[id / word_size] |= word_type{1} << (id % word_size);
+            } else {
+                for (size_t run = 0; run < _values.size(); run += 2)
+                    for (size_t id = _values[run]; id < _values[run + 1]; ++id)
+                        buffer[id / word_size] |= word_type{1} << (id % word_size);
+            }
+            return buffer;
+        }
+
+        size_t count_runs() const noexcept
+        {
+            size_t runs{};
+            std::optional<value_type> last{};
+            for (value_type id : *this) {
+                runs += !last.has_value() || *last + 1 != id;
+                last = id;
+            }
+            return runs;
+        }
+
+        value_type back() const noexcept
+        {
+            assert(!empty());
+            switch (_kind) {
+                case coverage_kind::dense: {
+                    size_t word_idx = _words.size();
+                    while (_words[--word_idx] == 0) {}
+                    return word_idx * word_size + (word_size - 1 - std::countl_zero(_words[word_idx]));
+                }
+                case coverage_kind::runs: return _values.back() - 1;
+                default: return _values.back();
+            }
+        }
+
+        void convert_to_sparse()
+        {
+            if (_kind == coverage_kind::sparse)
+                return;
+
+            std::vector<value_type> ids{};
+            ids.reserve(_count);
+            std::ranges::copy(*this, std::back_inserter(ids));
+            _values = std::move(ids);
+            _words.clear();
+            _kind = coverage_kind::sparse;
+        }
+
+        void convert_to_dense(value_type const max_id)
+        {
+            if (_kind == coverage_kind::dense)
+                return;
+
+            std::vector<word_type> words{};
+            words_view(words);
+            words.resize(word_count_for(max_id), 0);
+            _words = std::move(words);
+            _values.clear();
+            _kind = coverage_kind::dense;
+        }
+
+        void convert_to_runs()
+        {
+            if (_kind == coverage_kind::runs)
+                return;
+
+            std::vector<value_type> runs{};
+            for (value_type id : *this) {
+                if (runs.empty() || runs.back() != id)
+                    runs.insert(runs.end(), {id, static_cast<value_type>(id + 1)});
+                else
+                    ++runs.back();
+            }
+            _values = std::move(runs);
+            _words.clear();
+            _kind = coverage_kind::runs;
+        }
+
+        // ----------------------------------------------------------------------------
+        // Customisation points
+        // ----------------------------------------------------------------------------
+
+        friend adaptive_coverage tag_invoke(std::tag_t<libjst::coverage_intersection>,
+                                            adaptive_coverage const & first,
+                                            adaptive_coverage const & second)
+        {
+            return intersection(first, second);
+        }
+
+        friend adaptive_coverage tag_invoke(std::tag_t<libjst::coverage_difference>,
+                                            adaptive_coverage const & first,
+                                            adaptive_coverage const & second)
+        {
+            return difference(first, second);
+        }
+
+        friend domain_type tag_invoke(std::tag_t<libjst::get_domain>, adaptive_coverage const & me) noexcept
+        {
+            return me._domain;
+        }
+
+        friend bool operator==(adaptive_coverage const & lhs, adaptive_coverage const & rhs) noexcept
+        {
+            return lhs._count == rhs._count && std::ranges::equal(lhs, rhs);
+        }
+    };
+
+    /*!\brief Iterates the covered ids in ascending order independent of the representation.
+     *
+     * \details
+     *
+     * For the sparse and the run-length representation the index refers to the position in the value list.
+     * For the dense representation the current id is the position of the bit.
+     */
+    template <std::unsigned_integral value_t>
+    class adaptive_coverage<value_t>::iterator
+    {
+        friend adaptive_coverage;
+
+        adaptive_coverage const * _host{};
+        size_t _index{};
+        size_t _id{};
+
+        explicit iterator(adaptive_coverage const * host) noexcept : _host{host}
+        {
+            switch (_host->_kind) {
+                case coverage_kind::dense: _id = next_set_bit(0); break;
+                case coverage_kind::runs: [[fallthrough]];
+                default: _id = (_host->_values.empty()) ? 0 : _host->_values.front();
+            }
+        }
+
+        iterator(adaptive_coverage const * host, end_tag) noexcept : _host{host}
+        {
+            if (_host->_kind == coverage_kind::dense)
+                _id = _host->_words.size() * word_size;
+            else
+                _index = _host->_values.size();
+        }
+
+        iterator(adaptive_coverage const * host, size_t index, value_type id) noexcept :
+            _host{host},
+            _index{index},
+            _id{id}
+        {}
+
+    public:
+        using value_type = value_t;
+        using reference = value_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+
+        value_type operator*() const noexcept { return static_cast<value_type>(_id); }
+
+        iterator & operator++() noexcept
+        {
+            switch (_host->_kind) {
+                case coverage_kind::dense: _id = next_set_bit(_id + 1); break;
+                case coverage_kind::runs: {
+                    if (++_id == _host->_values[_index + 1]) {
+                        _index += 2;
+                        _id = (_index < _host->_values.size()) ? _host->_values[_index] : 0;
+                    }
+                    break;
+                }
+                default: {
+                    ++_index;
+                    _id = (_index < _host->_values.size()) ? _host->_values[_index] : 0;
+                }
+            }
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator tmp{*this};
+            ++(*this);
+            return tmp;
+        }
+
+    private:
+
+        size_t next_set_bit(size_t id) const noexcept
+        {
+            std::vector<word_type> const & words = _host->_words;
+            size_t const bit_count = words.size() * word_size;
+            if (id >= bit_count)
+                return bit_count;
+
+            size_t word_idx = id / word_size;
+            word_type word = words[word_idx] & (~word_type{0} << (id % word_size));
+            while (word == 0) {
+                if (++word_idx == words.size())
+                    return bit_count;
+                word = words[word_idx];
+            }
+            return word_idx * word_size + std::countr_zero(word);
+        }
+
+        friend bool operator==(iterator const & lhs, iterator const & rhs) noexcept
+        {
+            return lhs._index == rhs._index && lhs._id == rhs._id;
+        }
+    };
+}  // namespace jstmap
@@ -10,7 +10,11 @@
  * \author Rene Rahn <rene.rahn AT fu-berlin.de>
  */
 
+#include <algorithm>
+#include <cassert>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <string>
 
 #include <libjst/sequence_tree/path_descriptor.hpp>
@@ -18,22 +22,28 @@
 #include <libjst/utility/multi_invocable.hpp>
 
 #include <jstmap/global/bam_writer.hpp>
+#include <jstmap/global/sam_tags.hpp>
 #include <jstmap/global/search_query.hpp>
 
-namespace seqan3 {
-    template <> struct sam_tag_type<"ad"_tag> { using type = std::vector<std::byte>; };
-    template <> struct sam_tag_type<"rd"_tag> { using type = std::vector<std::byte>; };
-    template <> struct sam_tag_type<"lo"_tag> { using type = int32_t; };
-} // namespace seqan3
-
 namespace jstmap {
 
 
-    bam_writer::bam_writer(rcs_store_t const & rcs_store, std::filesystem::path file_name)
-        noexcept(std::is_nothrow_move_constructible_v<std::filesystem::path>)
-        : _rcs_store{rcs_store},
-          _output_file{create_output_file(std::move(file_name))}
+    bam_writer::bam_writer(rcs_store_t const & rcs_store,
+                           std::filesystem::path file_name,
+                           std::optional<sort_configuration> sorting)
+        : _rcs_store{rcs_store}
     {
+        using namespace std::literals;
+        if (sorting.has_value()) {
+            // The records are sorted by their variant index, which is no coordinate of the reference.
+            sorting->has_coordinates = false;
+            _sorted_output = std::make_unique<sorted_sam_writer>(std::move(file_name),
+                                                                 reference_names_type{"referentially compressed sequence store"s},
+                                                                 reference_lengths_type{_rcs_store.variants().size()},
+                                                                 *sorting);
+        } else {
+            _output_file.emplace(create_output_file(std::move(file_name)));
+        }
         write_program_info();
     }
 
@@ -45,56 +55,119 @@ namespace jstmap {
         return output_file_type{std::move(file_name), std::move(reference_names), std::move(reference_lengths)};
     }
 
-    void bam_writer::write_matches(search_matches const & query_matches)
+    void bam_writer::write_matches(search_matches const & query_matches,
+                                   seqan3::sam_flag const flag,
+                                   uint8_t const mapping_quality,
+                                   std::optional<mate_info> const mate)
     {
-        using namespace std::literals;
-        size_t cnt{};
-        for (auto const & match : query_matches.matches()) {
-            _output_file.emplace_back(query_matches.query().value().id(),                   /*QNAME*/
-                                      _output_file.header().ref_ids()[0],                   /*RNAME*/
-                                      match.position().tree_position.get_variant_index(),   /*POS*/
-                                      match.get_cigar(),                                    /*CIGAR*/
-                                      query_matches.query().value().sequence(),             /*SEQ*/
-                                      encode_position(match.position())                     /*OPTIONAL TAGS*/
-                                    );
+        using namespace seqan3::literals;
+        auto const & matches = query_matches.matches();
+        if (matches.empty())
+            return;
+
+        size_t const primary = primary_index(matches);
+        for (size_t idx = 0; idx < matches.size(); ++idx) {
+            search_match const & match = matches[idx];
+            bool const is_primary = idx == primary;
+            seqan3::sam_flag const record_flag = is_primary ? flag : flag | seqan3::sam_flag::secondary_alignment;
+            seqan3::sam_tag_dictionary tags{};
+            encode_match_position(match.position(), tags);
+            if (!match.haplotypes().empty())
+                tags.get<"hs"_tag>() = match.haplotypes();
+
+            mate_type mate_fields{};
+            if (mate.has_value()) {
+                mate_fields = mate_type{0, mate->position(), is_primary ? mate->template_length : 0};
+                encode_match_position(mate->tree_position, tags, mate_position_tags);
+                tags.get<"ms"_tag>() = static_cast<int32_t>(mate->sequence_size);
+            }
+
+            write_record(query_matches.query(),
+                         record_flag,
+                         match.position().tree_position.get_variant_index(),
+                         is_primary ? mapping_quality : uint8_t{0},
+                         match.get_cigar(),
+                         std::move(mate_fields),
+                         std::move(tags));
         }
     }
 
-    seqan3::sam_tag_dictionary bam_writer::encode_position(match_position const & position) const noexcept {
+    void bam_writer::write_unmapped(search_query const & query, seqan3::sam_flag const flag, mate_info const & mate)
+    {
         using namespace seqan3::literals;
 
-        seqan3::sam_tag_dictionary dict{};
-
-        // conversion to byte value?
-        position.tree_position.visit(libjst::multi_invocable {
-            [&](libjst::alternate_path_descriptor descriptor) {
-                size_t max_byte_count = (descriptor.size() + 7) / 8;
-
-                std::vector<std::byte> tmp(max_byte_count, std::byte{});
-                std::memcpy(tmp.data(), descriptor.data(), tmp.size());
-                dict.get<"ad"_tag>() = std::move(tmp);
-            },
-            [&](libjst::breakpoint_end descriptor) {
-                using data_t = std::underlying_type_t<libjst::breakpoint_end>;
-                static constexpr size_t max_byte_count = sizeof(data_t);
-
-                std::vector<std::byte> tmp(max_byte_count, std::byte{});
-                data_t _data = static_cast<data_t>(static_cast<libjst::breakpoint_end>(descriptor));
-                std::memcpy(tmp.data(), &_data, tmp.size());
-                dict.get<"rd"_tag>() = std::move(tmp);
-            }
+        seqan3::sam_tag_dictionary tags{};
+        encode_match_position(mate.tree_position, tags, mate_position_tags);
+        tags.get<"ms"_tag>() = static_cast<int32_t>(mate.sequence_size);
+        write_record(query,
+                     flag | seqan3::sam_flag::unmapped,
+                     mate.position(),
+                     uint8_t{0},
+                     std::vector<seqan3::cigar>{},
+                     mate_type{0, mate.position(), 0},
+                     std::move(tags));
+    }
+
+    size_t bam_writer::primary_index(std::span<search_match const> matches) noexcept
+    {
+        assert(!matches.empty());
+        auto primary_it = std::ranges::max_element(matches, std::less<>{}, [] (search_match const & match) {
+            return match.has_alignment() ? match.get_score() : std::numeric_limits<int32_t>::lowest();
         });
-        dict.get<"lo"_tag>() = position.label_offset;
-        return dict;
+        return std::ranges::distance(matches.begin(), primary_it);
+    }
+
+    void bam_writer::finish()
+    {
+        if (_sorted_output)
+            _sorted_output->finish();
+    }
+
+    void bam_writer::write_record(search_query const & query,
+                                  seqan3::sam_flag const flag,
+                                  int32_t const position,
+                                  uint8_t const mapping_quality,
+                                  std::vector<seqan3::cigar> cigar_sequence,
+                                  mate_type mate,
+                                  seqan3::sam_tag_dictionary tags)
+    {
+        if (!_sorted_output) {
+            _output_file->emplace_back(query.value().id(),                   /*QNAME*/
+                                       flag,                                 /*FLAG*/
+                                       _output_file->header().ref_ids()[0],  /*RNAME*/
+                                       position,                             /*POS*/
+                                       mapping_quality,                      /*MAPQ*/
+                                       std::move(cigar_sequence),            /*CIGAR*/
+                                       std::move(mate),                      /*RNEXT, PNEXT, TLEN*/
+                                       query.value().sequence(),             /*SEQ*/
+                                       std::move(tags)                       /*OPTIONAL TAGS*/
+                                     );
+            return;
+        }
+
+        sorted_sam_writer::record_type record{.id = query.value().id(),
+                                              .flag = flag,
+                                              .reference_position = position,
+                                              .mapping_quality = mapping_quality,
+                                              .cigar_sequence = std::move(cigar_sequence),
+                                              .mate_reference_id = std::get<0>(mate),
+                                              .mate_position = std::get<1>(mate),
+                                              .template_length = std::get<2>(mate),
+                                              .tags = std::move(tags)};
+        record.sequence.reserve(std::ranges::size(query.value().sequence()));
+        for (auto && symbol : query.value().sequence())
+            record.sequence.push_back(seqan3::assign_char_to(seqan3::to_char(symbol), seqan3::dna5{}));
+        _sorted_output->push(std::move(record));
     }
 
     void bam_writer::write_program_info() noexcept
     {
         using namespace std::literals;
-        using header_t = std::remove_reference_t<decltype(_output_file.header())>;
+        auto & header = _sorted_output ? _sorted_output->header() : _output_file->header();
+        using header_t = std::remove_reference_t<decltype(header)>;
         using program_info_t = typename header_t::program_info_t;
 
-        _output_file.header().program_infos.push_back(program_info_t{
+        header.program_infos.push_back(program_info_t{
             .name = "jst tools"s,
             .command_line_call = "add program call"s,
             .description = "Generated from the jst tools"s,
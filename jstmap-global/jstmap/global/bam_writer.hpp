@@ -13,25 +13,59 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <seqan3/core/debug_stream.hpp> // TODO: fix this!
 #include <seqan3/io/sam_file/output.hpp>
+#include <seqan3/io/sam_file/sam_flag.hpp>
 #include <seqan3/io/sam_file/sam_tag_dictionary.hpp>
 
 #include <jstmap/global/search_matches.hpp>
 #include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/match_position.hpp>
+#include <jstmap/global/sorted_sam_writer.hpp>
 
 namespace jstmap
 {
 
     class bam_writer {
+    public:
+
+        /*!\brief The mate of a paired record written into its RNEXT, PNEXT and TLEN fields.
+         *
+         * \details
+         *
+         * Since PNEXT only stores the variant index of the mate, the remaining tree position of the primary record of
+         * the mate is stored in the jstmap::mate_position_tags, such that PNEXT can be projected like POS.
+         * The size of the mate sequence is stored in the `ms` tag, since it selects the tree the position is sought in.
+         */
+        struct mate_info
+        {
+            match_position tree_position{}; //!< The match position of the primary record of the mate.
+            int32_t template_length{}; //!< The signed template length of the primary record; 0 if unknown.
+            size_t sequence_size{}; //!< The size of the mate sequence.
+
+            //!\brief The position of the primary record of the mate, i.e. its variant index.
+            int32_t position() const noexcept
+            {
+                return static_cast<int32_t>(tree_position.tree_position.get_variant_index());
+            }
+        };
+
+    private:
 
         using field_ids_type = seqan3::fields<seqan3::field::id,            /*QNAME*/
+                                              seqan3::field::flag,          /*FLAG*/
                                               seqan3::field::ref_id,        /*RNAME*/
                                               seqan3::field::ref_offset,    /*POS*/
+                                              seqan3::field::mapq,          /*MAPQ*/
                                               seqan3::field::cigar,         /*CIGAR*/
+                                              seqan3::field::mate,          /*RNEXT, PNEXT, TLEN*/
                                               seqan3::field::seq,           /*SEQ*/
                                               seqan3::field::tags           /*OPTIONAL TAGS*/
                                             >;
@@ -40,19 +74,65 @@ namespace jstmap
         using reference_names_type = std::vector<std::string>;
         using reference_lengths_type = std::vector<std::size_t>;
         using output_file_type = seqan3::sam_file_output<field_ids_type, valid_format_type, reference_names_type>;
+        using mate_type = std::tuple<std::optional<int32_t>, std::optional<int32_t>, int32_t>;
 
         rcs_store_t const & _rcs_store;
-        output_file_type _output_file;
+        std::optional<output_file_type> _output_file{};
+        std::unique_ptr<sorted_sam_writer> _sorted_output{};
 
     public:
-        explicit bam_writer(rcs_store_t const &, std::filesystem::path)
-            noexcept(std::is_nothrow_move_constructible_v<std::filesystem::path>);
+        /*!\brief Creates the writer for the given output file.
+         *
+         * \details
+         *
+         * Without a sort configuration the records are written in the order of the calls. Otherwise, the records are
+         * sorted by their position with the jstmap::sorted_sam_writer and written when the writer is finished.
+         */
+        explicit bam_writer(rcs_store_t const &,
+                            std::filesystem::path,
+                            std::optional<sort_configuration> sorting = std::nullopt);
+
+        //!\brief The mapping quality written if it is not available.
+        static constexpr uint8_t unknown_mapping_quality = 255;
+
+        /*!\brief Writes the matches of a query.
+         *
+         * \details
+         *
+         * The match with the highest alignment score is the primary record and gets the mapping quality of the query.
+         * All other matches are written as secondary records with a mapping quality of 0.
+         * If the mate is given, all records point to the primary record of the mate, but only the primary record
+         * gets the template length.
+         */
+        void write_matches(search_matches const &,
+                           seqan3::sam_flag flag = seqan3::sam_flag::none,
+                           uint8_t mapping_quality = unknown_mapping_quality,
+                           std::optional<mate_info> mate = std::nullopt);
+
+        /*!\brief Writes an unmapped record of a query placed at the position of its mapped mate.
+         *
+         * \details
+         *
+         * The seqan3::sam_flag::unmapped is added to the given flag. The record has no tree position of its own, but
+         * stores the tree position of its mate in the jstmap::mate_position_tags.
+         */
+        void write_unmapped(search_query const &, seqan3::sam_flag flag, mate_info const & mate);
+
+        //!\brief Returns the index of the match written as the primary record; the matches must not be empty.
+        static size_t primary_index(std::span<search_match const> matches) noexcept;
 
-        void write_matches(search_matches const &);
+        //!\brief Writes the buffered records of a sorted output; does nothing for an unsorted output.
+        void finish();
 
     private:
         output_file_type create_output_file(std::filesystem::path);
-        seqan3::sam_tag_dictionary encode_position(match_position const &) const noexcept;
+        void write_record(search_query const &,
+                          seqan3::sam_flag,
+                          int32_t,
+                          uint8_t,
+                          std::vector<seqan3::cigar>,
+                          mate_type,
+                          seqan3::sam_tag_dictionary);
         void write_program_info() noexcept;
     };
 }  // namespace jstmap
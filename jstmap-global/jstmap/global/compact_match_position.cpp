@@ -0,0 +1,114 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides implementation of the compact match position.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <libjst/sequence_tree/path_descriptor.hpp>
+#include <libjst/utility/multi_invocable.hpp>
+
+#include <jstmap/global/compact_match_position.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+inline constexpr size_t bits_per_word = 64;
+
+size_t word_count(size_t const bit_count) noexcept
+{
+    return (bit_count + bits_per_word - 1) / bits_per_word;
+}
+} // namespace
+
+compact_match_position match_position_arena::encode(match_position const & position)
+{
+    using namespace std::literals;
+
+    compact_match_position encoded{};
+    encoded._variant_index = position.tree_position.get_variant_index();
+    encoded._label_offset = position.label_offset;
+
+    position.tree_position.visit(libjst::multi_invocable{
+        [&] (libjst::breakpoint_end site) {
+            encoded._descriptor = static_cast<uint64_t>(site);
+        },
+        [&] (libjst::alternate_path_descriptor const & descriptor) {
+            size_t const descriptor_size = std::ranges::distance(descriptor);
+            if (descriptor_size > compact_match_position::max_descriptor_size)
+                throw std::length_error{"The alternate path descriptor with "s + std::to_string(descriptor_size) +
+                                        " steps exceeds the maximal size of a compact match position."s};
+
+            encoded._descriptor_size = descriptor_size;
+            encoded._is_spilled = descriptor_size > compact_match_position::inline_descriptor_capacity;
+
+            size_t const first_word = _words.size();
+            uint64_t word{};
+            size_t step{};
+            for (bool is_alternate : descriptor) {
+                word |= static_cast<uint64_t>(is_alternate) << (step % bits_per_word);
+                if (++step % bits_per_word == 0 && encoded._is_spilled) {
+                    _words.push_back(word);
+                    word = 0;
+                }
+            }
+
+            if (!encoded._is_spilled) {
+                encoded._descriptor = word;
+            } else {
+                if (step % bits_per_word != 0)
+                    _words.push_back(word);
+                encoded._descriptor = first_word;
+            }
+        }
+    });
+    return encoded;
+}
+
+match_position match_position_arena::decode(compact_match_position const & position) const
+{
+    match_position decoded{.label_offset = position.label_offset()};
+    if (!position.is_alternate()) {
+        decoded.tree_position.reset(position.variant_index(),
+                                    static_cast<libjst::breakpoint_end>(position._descriptor));
+        return decoded;
+    }
+
+    uint64_t const * words = position.is_spilled() ? _words.data() + position._descriptor : &position._descriptor;
+    auto is_alternate_step = [&] (size_t const step) -> bool {
+        return (words[step / bits_per_word] >> (step % bits_per_word)) & 1;
+    };
+
+    // The first step of the descriptor is set when the alternate node is initiated.
+    decoded.tree_position.initiate_alternate_node(position.variant_index());
+    for (size_t step = 1; step < position._descriptor_size; ++step)
+        decoded.tree_position.next_alternate_node(is_alternate_step(step));
+
+    return decoded;
+}
+
+compact_match_position match_position_arena::adopt(compact_match_position position,
+                                                   match_position_arena const & source)
+{
+    if (!position.is_spilled())
+        return position;
+
+    auto first = std::ranges::next(source._words.begin(), position._descriptor);
+    size_t const first_word = _words.size();
+    _words.insert(_words.end(), first, std::ranges::next(first, word_count(position._descriptor_size)));
+    position._descriptor = first_word;
+    return position;
+}
+
+} // namespace jstmap
@@ -0,0 +1,116 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a fixed-size encoding of a match position.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <jstmap/global/match_position.hpp>
+
+namespace jstmap
+{
+    class match_position_arena;
+
+    /*!\brief A match position encoded in 24 bytes.
+     *
+     * \details
+     *
+     * A position on a reference node stores its breakpoint end in the descriptor word. A position on an alternate node
+     * stores the steps of its alternate path descriptor as bits, of which up to 64 are kept inline. Longer descriptors
+     * are spilled to a jstmap::match_position_arena and the descriptor word stores their offset within the arena.
+     * Hence, a compact position can only be decoded by the arena that encoded it.
+     */
+    class compact_match_position
+    {
+    private:
+        friend match_position_arena;
+
+        uint64_t _variant_index{};
+        uint64_t _descriptor{};
+        int64_t _label_offset : 48 = 0;
+        uint64_t _descriptor_size : 15 = 0; //!< The number of alternate path steps; 0 for reference nodes.
+        uint64_t _is_spilled : 1 = 0;
+
+    public:
+        //!\brief The maximal number of alternate path steps stored without the arena.
+        static constexpr size_t inline_descriptor_capacity = 64;
+        //!\brief The maximal number of alternate path steps.
+        static constexpr size_t max_descriptor_size = (size_t{1} << 15) - 1;
+
+        compact_match_position() = default;
+
+        uint64_t variant_index() const noexcept
+        {
+            return _variant_index;
+        }
+
+        std::ptrdiff_t label_offset() const noexcept
+        {
+            return _label_offset;
+        }
+
+        bool is_alternate() const noexcept
+        {
+            return _descriptor_size > 0;
+        }
+
+        //!\brief Whether the descriptor is stored in the arena.
+        bool is_spilled() const noexcept
+        {
+            return _is_spilled;
+        }
+
+        //!\brief Compares the encodings; spilled positions are only comparable within the same arena.
+        friend bool operator==(compact_match_position const &, compact_match_position const &) noexcept = default;
+    };
+
+    static_assert(sizeof(compact_match_position) == 24);
+
+    /*!\brief Encodes match positions and stores the descriptors that do not fit into a jstmap::compact_match_position.
+     *
+     * \details
+     *
+     * Every thread owns an arena, such that recording a match does not need synchronisation. The spilled descriptors
+     * are appended to a single word vector, which avoids one allocation per recorded match.
+     * Positions moved to another arena must be adopted by the target arena.
+     */
+    class match_position_arena
+    {
+    private:
+        std::vector<uint64_t> _words{};
+
+    public:
+
+        match_position_arena() = default;
+
+        //!\brief Encodes the match position; throws std::length_error if its descriptor exceeds the maximal size.
+        compact_match_position encode(match_position const & position);
+
+        //!\brief Decodes a match position encoded by this arena.
+        match_position decode(compact_match_position const & position) const;
+
+        //!\brief Copies the spilled descriptor of a position encoded by the source arena into this arena.
+        compact_match_position adopt(compact_match_position position, match_position_arena const & source);
+
+        //!\brief The number of words used by the spilled descriptors.
+        size_t spilled_word_count() const noexcept
+        {
+            return _words.size();
+        }
+
+        void clear() noexcept
+        {
+            _words.clear();
+        }
+    };
+}  // namespace jstmap
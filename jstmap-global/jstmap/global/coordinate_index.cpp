@@ -0,0 +1,121 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the index projecting source positions onto the coordinates of the haplotypes.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <jstmap/global/coordinate_index.hpp>
+#include <jstmap/global/for_each_variant.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+inline constexpr uint64_t coordinate_index_magic = 0x32444943544a534aull; // "JSJTCID2"
+} // namespace
+
+coordinate_index::coordinate_index(rcs_store_t const & rcs_store) :
+    _source_size{std::ranges::size(rcs_store.source())},
+    _haplotype_count{rcs_store.size()},
+    _store_variant_count{std::ranges::size(rcs_store.variants())}
+{
+    auto for_each_indel = [&] (auto && callback) {
+        for_each_variant(rcs_store, [&] (auto low, auto high, auto const & alt_sequence, auto const & coverage) {
+            int64_t const delta = std::ranges::ssize(alt_sequence) - (high - low);
+            if (delta != 0)
+                callback(static_cast<uint64_t>(high) * 2 + (low == high), delta, coverage);
+        });
+    };
+
+    // Count the indels of every haplotype, such that the entries are written directly into their final place.
+    _haplotype_begins.assign(_haplotype_count + 1, 0);
+    for_each_indel([&] (uint64_t, int64_t, auto const & coverage) {
+        for (auto && haplotype : coverage)
+            ++_haplotype_begins[haplotype + 1];
+    });
+    std::partial_sum(_haplotype_begins.begin(), _haplotype_begins.end(), _haplotype_begins.begin());
+
+    _breakend_keys.resize(_haplotype_begins.back());
+    _delta_sums.resize(_haplotype_begins.back());
+    std::vector<uint64_t> cursors(_haplotype_begins.begin(), _haplotype_begins.end() - 1);
+    for_each_indel([&] (uint64_t const key, int64_t const delta, auto const & coverage) {
+        for (auto && haplotype : coverage) {
+            uint64_t const entry = cursors[haplotype]++;
+            _breakend_keys[entry] = key;
+            _delta_sums[entry] = delta;
+        }
+    });
+
+    // The variants are visited by their low breakend. Since the variants of one haplotype never overlap, their high
+    // breakends are in the same order, except for an insertion in front of a deletion at the same position.
+    std::vector<std::pair<uint64_t, int64_t>> entries{};
+    for (uint64_t haplotype = 0; haplotype < _haplotype_count; ++haplotype) {
+        uint64_t const first = _haplotype_begins[haplotype];
+        uint64_t const last = _haplotype_begins[haplotype + 1];
+        if (!std::is_sorted(_breakend_keys.begin() + first, _breakend_keys.begin() + last)) {
+            entries.clear();
+            for (uint64_t entry = first; entry < last; ++entry)
+                entries.emplace_back(_breakend_keys[entry], _delta_sums[entry]);
+            std::ranges::sort(entries);
+            for (uint64_t entry = first; entry < last; ++entry)
+                std::tie(_breakend_keys[entry], _delta_sums[entry]) = entries[entry - first];
+        }
+        std::partial_sum(_delta_sums.begin() + first, _delta_sums.begin() + last, _delta_sums.begin() + first);
+    }
+}
+
+void coordinate_index::save(std::filesystem::path const & index_path) const
+{
+    using namespace std::literals;
+
+    std::ofstream output_stream{index_path, std::ios::binary};
+    if (!output_stream.good())
+        throw std::runtime_error{"Couldn't open path for storing the coordinate index! The path is ["s +
+                                 index_path.string() + "]"s};
+
+    cereal::BinaryOutputArchive archive{output_stream};
+    archive(coordinate_index_magic, _source_size, _haplotype_count, _store_variant_count);
+    archive(_haplotype_begins, _breakend_keys, _delta_sums);
+}
+
+coordinate_index coordinate_index::load(std::filesystem::path const & index_path)
+{
+    using namespace std::literals;
+
+    std::ifstream input_stream{index_path, std::ios::binary};
+    if (!input_stream.good())
+        throw std::runtime_error{"Couldn't open path for loading the coordinate index! The path is ["s +
+                                 index_path.string() + "]"s};
+
+    cereal::BinaryInputArchive archive{input_stream};
+    uint64_t magic{};
+    archive(magic);
+    if (magic != coordinate_index_magic)
+        throw std::runtime_error{"The file ["s + index_path.string() + "] is not a coordinate index!"s};
+
+    coordinate_index index{};
+    archive(index._source_size, index._haplotype_count, index._store_variant_count);
+    archive(index._haplotype_begins, index._breakend_keys, index._delta_sums);
+    return index;
+}
+
+} // namespace jstmap
@@ -0,0 +1,114 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the index projecting source positions onto the coordinates of the haplotypes.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <ranges>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap
+{
+    /*!\brief Converts the source positions into the positions of every haplotype.
+     *
+     * \details
+     *
+     * The offset of a haplotype at a source position is the sum of the length differences of all variants of the
+     * haplotype ending before the position. Only insertions and deletions change the length, so the substitutions
+     * are not indexed at all. For every haplotype, the index stores the high breakends of its indels in ascending
+     * order together with the prefix sums of their length differences. The entries of all haplotypes are kept one
+     * after the other in a single array, which is delimited by the begin of every haplotype.
+     *
+     * A query finds the rank of the source position among the breakends of the haplotype by a binary search and
+     * returns the prefix sum in front of it. Hence, the index grows with the number of indels carried by the haplotypes,
+     * i.e. with the size of their coverages, instead of with the number of haplotypes times the number of variants,
+     * and a query takes logarithmic time in the number of indels of the haplotype.
+     *
+     * The index is built once per rcs store and can be saved and loaded.
+     */
+    class coordinate_index
+    {
+    private:
+        uint64_t _source_size{};
+        uint64_t _haplotype_count{};
+        uint64_t _store_variant_count{}; //!< The number of breakends of the rcs store.
+        std::vector<uint64_t> _haplotype_begins{}; //!< The begin of the entries of every haplotype, plus the end.
+        std::vector<uint64_t> _breakend_keys{}; //!< The high breakends times two, plus one for insertions.
+        std::vector<int64_t> _delta_sums{}; //!< The prefix sums of the length differences, including the entry.
+
+    public:
+
+        coordinate_index() = default;
+        explicit coordinate_index(rcs_store_t const & rcs_store);
+
+        /*!\brief The offset of the haplotype at the given source position.
+         *
+         * \param[in] haplotype The haplotype to get the offset for.
+         * \param[in] source_position The source position to get the offset for.
+         * \param[in] include_insertions Whether insertions at the source position precede the position.
+         *
+         * \returns The sum of the length differences of all variants of the haplotype ending at or before the position.
+         */
+        int64_t offset(uint64_t const haplotype,
+                       uint64_t const source_position,
+                       bool const include_insertions = false) const noexcept
+        {
+            auto first = _breakend_keys.begin() + _haplotype_begins[haplotype];
+            auto last = _breakend_keys.begin() + _haplotype_begins[haplotype + 1];
+            uint64_t const key = source_position * 2 + include_insertions;
+            auto rank = std::ranges::upper_bound(first, last, key);
+            if (rank == first)
+                return 0;
+            return _delta_sums[std::ranges::distance(_breakend_keys.begin(), rank) - 1];
+        }
+
+        //!\brief The position of the haplotype at the given source position.
+        uint64_t haplotype_position(uint64_t const haplotype,
+                                    uint64_t const source_position,
+                                    bool const include_insertions = false) const noexcept
+        {
+            return source_position + offset(haplotype, source_position, include_insertions);
+        }
+
+        //!\brief The size of the haplotype.
+        uint64_t haplotype_size(uint64_t const haplotype) const noexcept
+        {
+            return haplotype_position(haplotype, _source_size, true);
+        }
+
+        uint64_t haplotype_count() const noexcept
+        {
+            return _haplotype_count;
+        }
+
+        //!\brief The number of indexed entries, i.e. the indels summed over the haplotypes carrying them.
+        uint64_t entry_count() const noexcept
+        {
+            return _breakend_keys.size();
+        }
+
+        //!\brief Whether the index was built for the given store.
+        bool is_compatible(rcs_store_t const & rcs_store) const
+        {
+            return _source_size == static_cast<uint64_t>(std::ranges::size(rcs_store.source())) &&
+                   _haplotype_count == static_cast<uint64_t>(rcs_store.size()) &&
+                   _store_variant_count == static_cast<uint64_t>(std::ranges::size(rcs_store.variants()));
+        }
+
+        void save(std::filesystem::path const & index_path) const;
+        static coordinate_index load(std::filesystem::path const & index_path);
+    };
+}  // namespace jstmap
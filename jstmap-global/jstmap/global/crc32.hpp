@@ -0,0 +1,47 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the CRC-32 checksum used by the jst container.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace jstmap
+{
+    namespace detail
+    {
+        inline constexpr std::array<uint32_t, 256> crc32_table = [] () {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t byte = 0; byte < table.size(); ++byte) {
+                uint32_t crc = byte;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                table[byte] = crc;
+            }
+            return table;
+        }();
+    } // namespace detail
+
+    /*!\brief Computes the CRC-32 (IEEE 802.3) checksum of the given bytes.
+     *
+     * \param[in] bytes The bytes to compute the checksum for.
+     * \param[in] crc The checksum of the preceding bytes to continue from; defaults to the checksum of no bytes.
+     */
+    constexpr uint32_t crc32(std::string_view bytes, uint32_t crc = 0) noexcept
+    {
+        crc = ~crc;
+        for (unsigned char byte : bytes)
+            crc = detail::crc32_table[(crc ^ byte) & 0xFFu] ^ (crc >> 8);
+        return ~crc;
+    }
+}  // namespace jstmap
@@ -0,0 +1,42 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the tree composition used to filter the haystack for seeds.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <libjst/sequence_tree/labelled_tree.hpp>
+#include <libjst/sequence_tree/coloured_tree.hpp>
+#include <libjst/sequence_tree/left_extend_tree.hpp>
+#include <libjst/sequence_tree/merge_tree.hpp>
+#include <libjst/sequence_tree/prune_tree.hpp>
+#include <libjst/sequence_tree/seekable_tree.hpp>
+#include <libjst/sequence_tree/trim_tree.hpp>
+
+namespace jstmap
+{
+    /*!\brief Composes the seekable tree over the base tree in which every node label contains all windows of the
+     *        given size that are covered by at least one haplotype.
+     *
+     * \param[in] base_tree The tree to compose the filter tree for, e.g. a chunk of the rcs store.
+     * \param[in] window_size The size of the windows searched in the node labels; must be greater than 0.
+     */
+    template <typename base_tree_t>
+    constexpr auto make_filter_tree(base_tree_t && base_tree, size_t const window_size)
+    {
+        return std::forward<base_tree_t>(base_tree) | libjst::labelled()
+                                                    | libjst::coloured()
+                                                    | libjst::trim(window_size - 1)
+                                                    | libjst::prune()
+                                                    | libjst::left_extend(window_size - 1)
+                                                    | libjst::merge()
+                                                    | libjst::seek();
+    }
+}  // namespace jstmap
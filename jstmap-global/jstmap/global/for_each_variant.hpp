@@ -0,0 +1,78 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a function to visit every variant of a rcs store exactly once.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include <libjst/variant/concept.hpp>
+
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap
+{
+    /*!\brief Invokes the callback once for every variant stored in the rcs store.
+     *
+     * \param[in] rcs_store The store to visit the variants of.
+     * \param[in] callback The callback invoked with the low breakend, the high breakend, the alternate sequence and the
+     *                     coverage of each variant.
+     *
+     * \details
+     *
+     * The compressed multisequence stores every variant as a pair of breakends.
+     * Only the low breakend of a variant is reported, and sentinel breakends without coverage are skipped.
+     * Insertions have identical low and high breakends and are reported only once.
+     * The variants are visited in ascending order of their low breakend.
+     */
+    template <typename rcs_store_t, typename callback_t>
+    void for_each_variant(rcs_store_t const & rcs_store, callback_t && callback)
+    {
+        using position_t = std::ptrdiff_t;
+
+        position_t insertion_position = std::numeric_limits<position_t>::max();
+        std::vector<std::pair<reference_t, coverage_t>> visited_insertions{};
+
+        for (auto && breakend : rcs_store.variants()) {
+            auto const & coverage = libjst::coverage(breakend);
+            if (std::ranges::empty(coverage))
+                continue;
+
+            position_t low = libjst::low_breakend(breakend);
+            position_t high = libjst::high_breakend(breakend);
+            if (static_cast<position_t>(libjst::position(breakend)) != low)
+                continue;
+
+            auto && alt_sequence = libjst::alt_sequence(breakend);
+            if (low == high) {
+                if (low != insertion_position) {
+                    insertion_position = low;
+                    visited_insertions.clear();
+                }
+
+                reference_t insertion(std::ranges::begin(alt_sequence), std::ranges::end(alt_sequence));
+                auto is_visited = [&] (auto const & visited) {
+                    return visited.first == insertion && visited.second == coverage;
+                };
+                if (std::ranges::any_of(visited_insertions, is_visited))
+                    continue;
+
+                visited_insertions.emplace_back(std::move(insertion), coverage);
+            }
+
+            callback(low, high, alt_sequence, coverage);
+        }
+    }
+}  // namespace jstmap
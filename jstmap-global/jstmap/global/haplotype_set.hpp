@@ -0,0 +1,203 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the compressed binary encoding of the haplotypes supporting a match.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace jstmap
+{
+    //!\brief The representation of an encoded haplotype set, stored in its first byte.
+    enum struct haplotype_set_kind : uint8_t
+    {
+        sparse = 0, //!< The gaps between consecutive ids.
+        runs = 1, //!< The gap in front of and the length of every run of consecutive ids.
+        dense = 2 //!< The first id followed by a bitvector of the ids from the first to the last id.
+    };
+
+    namespace detail
+    {
+        inline size_t varint_size(uint64_t value) noexcept
+        {
+            size_t size{1};
+            for (; value >= 0x80; value >>= 7)
+                ++size;
+            return size;
+        }
+
+        inline void append_varint(std::vector<uint8_t> & encoded, uint64_t value)
+        {
+            for (; value >= 0x80; value >>= 7)
+                encoded.push_back(static_cast<uint8_t>(value | 0x80));
+            encoded.push_back(static_cast<uint8_t>(value));
+        }
+
+        inline uint64_t read_varint(std::span<uint8_t const> encoded, size_t & offset)
+        {
+            uint64_t value{};
+            for (size_t shift = 0; offset < encoded.size() && shift < 64; shift += 7) {
+                uint8_t const byte = encoded[offset++];
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+            throw std::invalid_argument{"Truncated haplotype set"};
+        }
+    } // namespace detail
+
+    /*!\brief Encodes a set of haplotype ids into bytes.
+     *
+     * \param[in] haplotype_ids The ids in ascending order, e.g. the coverage of a path.
+     *
+     * \details
+     *
+     * Like the jstmap::adaptive_coverage, the ids are encoded in the smallest of three representations, which are
+     * described by jstmap::haplotype_set_kind; the numbers are written as LEB128 variable length integers.
+     * Since the dense representation is always available, the encoding takes at most one bit per haplotype in the
+     * range of the set plus a few bytes, however scattered the haplotypes are. An empty set is encoded as no bytes.
+     */
+    template <std::ranges::input_range haplotype_ids_t>
+    std::vector<uint8_t> encode_haplotype_set(haplotype_ids_t && haplotype_ids)
+    {
+        std::vector<uint64_t> ids{};
+        for (auto && id : haplotype_ids)
+            ids.push_back(static_cast<uint64_t>(id));
+        if (ids.empty())
+            return {};
+
+        // Visits the first and the last id of every run of consecutive ids.
+        auto for_each_run = [&] (auto && visit) {
+            uint64_t run_first{ids.front()};
+            for (size_t idx = 0; idx < ids.size(); ++idx) {
+                if (idx + 1 < ids.size() && ids[idx + 1] == ids[idx] + 1)
+                    continue;
+                visit(run_first, ids[idx]);
+                if (idx + 1 < ids.size())
+                    run_first = ids[idx + 1];
+            }
+        };
+
+        // The size of every representation.
+        size_t sparse_size{1};
+        uint64_t next_id{};
+        for (uint64_t id : ids) {
+            sparse_size += detail::varint_size(id - next_id);
+            next_id = id + 1;
+        }
+        size_t runs_size{1};
+        next_id = 0;
+        for_each_run([&] (uint64_t const first, uint64_t const last) {
+            runs_size += detail::varint_size(first - next_id) + detail::varint_size(last - first);
+            next_id = last + 1;
+        });
+        size_t const dense_size = 1 + detail::varint_size(ids.front()) + (ids.back() - ids.front()) / 8 + 1;
+
+        std::vector<uint8_t> encoded{};
+        if (dense_size < sparse_size && dense_size < runs_size) {
+            encoded.reserve(dense_size);
+            encoded.push_back(static_cast<uint8_t>(haplotype_set_kind::dense));
+            detail::append_varint(encoded, ids.front());
+            size_t const bits_offset = encoded.size();
+            encoded.resize(dense_size, 0);
+            for (uint64_t id : ids) {
+                uint64_t const bit = id - ids.front();
+                encoded[bits_offset + bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+            }
+        } else if (runs_size < sparse_size) {
+            encoded.reserve(runs_size);
+            encoded.push_back(static_cast<uint8_t>(haplotype_set_kind::runs));
+            next_id = 0;
+            for_each_run([&] (uint64_t const first, uint64_t const last) {
+                detail::append_varint(encoded, first - next_id);
+                detail::append_varint(encoded, last - first);
+                next_id = last + 1;
+            });
+        } else {
+            encoded.reserve(sparse_size);
+            encoded.push_back(static_cast<uint8_t>(haplotype_set_kind::sparse));
+            next_id = 0;
+            for (uint64_t id : ids) {
+                detail::append_varint(encoded, id - next_id);
+                next_id = id + 1;
+            }
+        }
+        return encoded;
+    }
+
+    /*!\brief Decodes the haplotype ids encoded by jstmap::encode_haplotype_set.
+     *
+     * \throws std::invalid_argument if the encoding is malformed, i.e. it has an unknown representation, is truncated,
+     *         or encodes an id that exceeds 32 bits.
+     */
+    inline std::vector<uint32_t> decode_haplotype_set(std::span<uint8_t const> encoded)
+    {
+        using namespace std::literals;
+
+        std::vector<uint32_t> haplotype_ids{};
+        if (encoded.empty())
+            return haplotype_ids;
+
+        // The ids are computed in 64 bits, such that an overflowing gap or run is detected instead of wrapping.
+        auto push_id = [&] (uint64_t const id) {
+            if (id > std::numeric_limits<uint32_t>::max())
+                throw std::invalid_argument{"Haplotype id "s + std::to_string(id) + " exceeds 32 bits"s};
+            haplotype_ids.push_back(static_cast<uint32_t>(id));
+        };
+
+        size_t offset{1};
+        uint64_t next_id{};
+        switch (static_cast<haplotype_set_kind>(encoded[0])) {
+            case haplotype_set_kind::sparse: {
+                while (offset < encoded.size()) {
+                    uint64_t const gap = detail::read_varint(encoded, offset);
+                    if (gap > std::numeric_limits<uint32_t>::max())
+                        throw std::invalid_argument{"Haplotype id gap exceeds 32 bits"};
+                    push_id(next_id + gap);
+                    next_id = haplotype_ids.back() + uint64_t{1};
+                }
+                break;
+            }
+            case haplotype_set_kind::runs: {
+                while (offset < encoded.size()) {
+                    uint64_t const gap = detail::read_varint(encoded, offset);
+                    uint64_t const length = detail::read_varint(encoded, offset);
+                    if (gap > std::numeric_limits<uint32_t>::max() || length > std::numeric_limits<uint32_t>::max())
+                        throw std::invalid_argument{"Haplotype run exceeds 32 bits"};
+                    uint64_t const first = next_id + gap;
+                    uint64_t const last = first + length;
+                    if (last > std::numeric_limits<uint32_t>::max())
+                        throw std::invalid_argument{"Haplotype run ends behind 32 bits"};
+                    for (uint64_t id = first; id <= last; ++id)
+                        push_id(id);
+                    next_id = last + 1;
+                }
+                break;
+            }
+            case haplotype_set_kind::dense: {
+                uint64_t const first = detail::read_varint(encoded, offset);
+                for (size_t bit = 0; offset + bit / 8 < encoded.size(); ++bit)
+                    if ((encoded[offset + bit / 8] >> (bit % 8)) & 1u)
+                        push_id(first + bit);
+                break;
+            }
+            default: throw std::invalid_argument{"Unknown haplotype set representation "s +
+                                                 std::to_string(encoded[0])};
+        }
+        return haplotype_ids;
+    }
+}  // namespace jstmap
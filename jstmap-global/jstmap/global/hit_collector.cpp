@@ -0,0 +1,45 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides implementation of the hit collector.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <jstmap/global/hit_collector.hpp>
+
+namespace jstmap
+{
+
+std::unordered_map<size_t, mapping_summary> summarise_hits(std::span<hit_collector const> collectors)
+{
+    // Most reads are found by a single thread, whose strata are summarised without copying them.
+    std::unordered_map<size_t, hit_strata> merged_strata{};
+    std::unordered_map<size_t, hit_collector::read_hits const *> first_hits{};
+    for (hit_collector const & collector : collectors) {
+        for (auto const & [key, hits] : collector.hits()) {
+            auto [it, is_first] = first_hits.emplace(key, &hits);
+            if (is_first)
+                continue;
+
+            auto [merged_it, is_new] = merged_strata.try_emplace(key);
+            if (is_new)
+                merged_it->second = it->second->strata;
+            merged_it->second.merge(hits.strata);
+        }
+    }
+
+    std::unordered_map<size_t, mapping_summary> summaries{};
+    summaries.reserve(first_hits.size());
+    for (auto const & [key, hits] : first_hits) {
+        auto merged_it = merged_strata.find(key);
+        summaries.emplace(key, (merged_it == merged_strata.end()) ? hits->strata.summary() : merged_it->second.summary());
+    }
+    return summaries;
+}
+
+}  // namespace jstmap
@@ -0,0 +1,211 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the collection of the hits found by one search thread.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <jstmap/global/compact_match_position.hpp>
+#include <jstmap/global/mapping_summary.hpp>
+#include <jstmap/global/match_position.hpp>
+
+namespace jstmap
+{
+    /*!\brief The locus of a hit, i.e. the variant index and the label offset of its match position.
+     *
+     * \details
+     *
+     * The paths below a node share the path sequence of the node. Hence, the hits found on different haplotype paths
+     * that begin at the same label offset within the subtree of the same variant have the same locus.
+     */
+    struct hit_locus
+    {
+        uint64_t variant_index{};
+        std::ptrdiff_t label_offset{};
+
+        friend auto operator<=>(hit_locus const &, hit_locus const &) noexcept = default;
+    };
+
+    /*!\brief The distinct loci of the hits of a read in its best and second best error stratum.
+     *
+     * \details
+     *
+     * The hits are recorded as they are found. A locus counts once with its least error count, and a locus worse than
+     * the second stratum is dropped right away, since it can never enter the two best strata again. Hence, only the
+     * loci of the two best strata are kept, which are merged by locus if the hits of a read were found by several
+     * threads. The strata give the jstmap::mapping_summary of the read.
+     */
+    class hit_strata
+    {
+    private:
+
+        //!\brief The distinct loci of one stratum sorted by locus.
+        struct stratum
+        {
+            uint32_t error_count{std::numeric_limits<uint32_t>::max()};
+            std::vector<hit_locus> loci{};
+
+            bool contains(hit_locus const & locus) const noexcept
+            {
+                return std::ranges::binary_search(loci, locus);
+            }
+
+            void insert(hit_locus const & locus)
+            {
+                auto it = std::ranges::lower_bound(loci, locus);
+                if (it == loci.end() || *it != locus)
+                    loci.insert(it, locus);
+            }
+
+            void erase(hit_locus const & locus)
+            {
+                auto it = std::ranges::lower_bound(loci, locus);
+                if (it != loci.end() && *it == locus)
+                    loci.erase(it);
+            }
+        };
+
+        stratum _best{};
+        stratum _second{};
+
+    public:
+
+        //!\brief Records a hit at the given locus with the given error count.
+        void record(hit_locus const & locus, uint32_t const error_count)
+        {
+            if (error_count < _best.error_count) {
+                _second = std::move(_best);
+                _second.erase(locus);
+                _best = stratum{.error_count = error_count, .loci = {locus}};
+            } else if (error_count == _best.error_count) {
+                _best.insert(locus);
+                _second.erase(locus);
+            } else if (error_count <= _second.error_count && !_best.contains(locus)) {
+                if (error_count < _second.error_count)
+                    _second = stratum{.error_count = error_count};
+                _second.insert(locus);
+            }
+        }
+
+        //!\brief Adds the loci of the same read recorded by another thread.
+        void merge(hit_strata const & other)
+        {
+            for (stratum const * source : {&other._best, &other._second})
+                for (hit_locus const & locus : source->loci)
+                    record(locus, source->error_count);
+        }
+
+        //!\brief The least error count of all hits.
+        uint32_t best_error_count() const noexcept
+        {
+            return _best.error_count;
+        }
+
+        //!\brief The summary of the distinct loci of both strata.
+        mapping_summary summary() const noexcept
+        {
+            mapping_summary summary{};
+            if (!_best.loci.empty())
+                summary.record(_best.error_count, static_cast<uint32_t>(_best.loci.size()));
+            if (!_second.loci.empty())
+                summary.record(_second.error_count, static_cast<uint32_t>(_second.loci.size()));
+            return summary;
+        }
+    };
+
+    /*!\brief Collects the hits of the reads found by one search thread.
+     *
+     * \details
+     *
+     * The match positions are stored in their compact encoding, whose long descriptors are kept in the arena of the
+     * collector. Every hit is also recorded by its jstmap::hit_locus in the jstmap::hit_strata of the read, such that
+     * the hits of a read found on several haplotype paths through the same locus count once for its mapping quality;
+     * see jstmap::summarise_hits. If only the best hits are kept, the positions of worse hits are dropped as soon as
+     * they are found.
+     */
+    class hit_collector
+    {
+    public:
+
+        using match_positions_type = std::vector<compact_match_position>;
+
+        //!\brief The hits of a read.
+        struct read_hits
+        {
+            match_positions_type positions{}; //!< The positions of the kept hits.
+            hit_strata strata{}; //!< The distinct loci of the two best strata.
+        };
+
+    private:
+
+        std::unordered_map<size_t, read_hits> _hits{};
+        match_position_arena _arena{};
+        bool _best_only{};
+
+    public:
+
+        hit_collector() = default;
+        explicit hit_collector(bool const best_only) noexcept : _best_only{best_only}
+        {}
+
+        //!\brief Records a hit of the read with the given key; the callback of the search.
+        void record(size_t const key, match_position const & position, uint32_t const error_count)
+        {
+            read_hits & hits = _hits[key];
+            bool const is_new_best = error_count < hits.strata.best_error_count();
+            hits.strata.record(hit_locus{.variant_index = position.tree_position.get_variant_index(),
+                                         .label_offset = position.label_offset},
+                               error_count);
+            if (_best_only) { // Only the hits of the best stratum are kept.
+                if (error_count > hits.strata.best_error_count())
+                    return;
+                if (is_new_best)
+                    hits.positions.clear();
+            }
+            hits.positions.push_back(_arena.encode(position));
+        }
+
+        //!\brief The hits of every read with at least one hit.
+        std::unordered_map<size_t, read_hits> & hits() noexcept
+        {
+            return _hits;
+        }
+
+        //!\overload
+        std::unordered_map<size_t, read_hits> const & hits() const noexcept
+        {
+            return _hits;
+        }
+
+        //!\brief The arena encoding the positions of the collector.
+        match_position_arena const & arena() const noexcept
+        {
+            return _arena;
+        }
+    };
+
+    /*!\brief Summarises the hits of every read collected by several threads.
+     *
+     * \details
+     *
+     * The jstmap::hit_strata of a read collected by different threads are merged by locus, such that every distinct
+     * locus counts once with its least error count for the jstmap::mapping_summary of the read.
+     */
+    std::unordered_map<size_t, mapping_summary> summarise_hits(std::span<hit_collector const> collectors);
+}  // namespace jstmap
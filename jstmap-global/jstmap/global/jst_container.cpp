@@ -0,0 +1,424 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the sectioned and checksummed container format of the jst.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <seqan3/alphabet/concept.hpp>
+
+#include <jstmap/global/crc32.hpp>
+#include <jstmap/global/for_each_variant.hpp>
+#include <jstmap/global/jst_container.hpp>
+#include <jstmap/global/packed_dna_sequence.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+inline constexpr uint64_t default_chunk_span = 1ull << 16;
+
+//!\brief The fixed size header at the beginning of the container.
+struct container_header
+{
+    std::array<char, 8> magic{jst_container_magic};
+    uint32_t version{jst_container_version};
+    uint32_t table_of_contents_checksum{};
+    uint64_t table_of_contents_offset{};
+    uint64_t table_of_contents_size{};
+};
+
+template <typename ...values_t>
+std::string to_bytes(values_t const & ...values)
+{
+    std::ostringstream byte_stream{};
+    {
+        cereal::BinaryOutputArchive archive{byte_stream};
+        archive(values...);
+    }
+    return std::move(byte_stream).str();
+}
+
+template <typename ...values_t>
+void from_bytes(std::string const & bytes, values_t & ...values)
+{
+    std::istringstream byte_stream{bytes};
+    cereal::BinaryInputArchive archive{byte_stream};
+    archive(values...);
+}
+
+template <typename rank_iterator_t>
+reference_t from_ranks(rank_iterator_t first, rank_iterator_t last)
+{
+    reference_t sequence{};
+    sequence.reserve(std::ranges::distance(first, last));
+    for (; first != last; ++first)
+        sequence.push_back(seqan3::assign_rank_to(*first, alphabet_t{}));
+    return sequence;
+}
+
+jst_section_entry write_section(std::ofstream & output_stream, uint32_t const id, std::string const & bytes)
+{
+    jst_section_entry entry{.id = id,
+                            .offset = static_cast<uint64_t>(output_stream.tellp()),
+                            .size = bytes.size(),
+                            .checksum = crc32(bytes)};
+    output_stream.write(bytes.data(), bytes.size());
+    return entry;
+}
+
+void write_header(std::ofstream & output_stream, container_header const & header)
+{
+    output_stream.write(header.magic.data(), header.magic.size());
+    output_stream.write(reinterpret_cast<char const *>(&header.version), sizeof(header.version));
+    output_stream.write(reinterpret_cast<char const *>(&header.table_of_contents_checksum),
+                        sizeof(header.table_of_contents_checksum));
+    output_stream.write(reinterpret_cast<char const *>(&header.table_of_contents_offset),
+                        sizeof(header.table_of_contents_offset));
+    output_stream.write(reinterpret_cast<char const *>(&header.table_of_contents_size),
+                        sizeof(header.table_of_contents_size));
+}
+
+container_header read_header(std::ifstream & input_stream)
+{
+    container_header header{};
+    input_stream.read(header.magic.data(), header.magic.size());
+    input_stream.read(reinterpret_cast<char *>(&header.version), sizeof(header.version));
+    input_stream.read(reinterpret_cast<char *>(&header.table_of_contents_checksum),
+                      sizeof(header.table_of_contents_checksum));
+    input_stream.read(reinterpret_cast<char *>(&header.table_of_contents_offset),
+                      sizeof(header.table_of_contents_offset));
+    input_stream.read(reinterpret_cast<char *>(&header.table_of_contents_size),
+                      sizeof(header.table_of_contents_size));
+    return header;
+}
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Writer
+// ----------------------------------------------------------------------------
+
+void save_jst(rcs_store_t const & rcs_store,
+              std::filesystem::path const & output_path,
+              uint64_t const coverage_block_size)
+{
+    using namespace std::literals;
+
+    std::ofstream output_stream{output_path, std::ios::binary};
+    if (!output_stream.good())
+        throw std::runtime_error{"Couldn't open path for storing the rcs store! The path is ["s +
+                                 output_path.string() +
+                                 "]"s};
+
+    // Collect the variants in breakpoint order.
+    std::vector<uint32_t> lows{};
+    std::vector<uint32_t> deletion_sizes{};
+    std::vector<uint32_t> insertion_sizes{};
+    std::vector<uint8_t> insertion_ranks{};
+    std::vector<coverage_t> coverages{};
+    for_each_variant(rcs_store, [&] (auto low, auto high, auto const & alt_sequence, auto const & coverage) {
+        lows.push_back(low);
+        deletion_sizes.push_back(high - low);
+        insertion_sizes.push_back(std::ranges::size(alt_sequence));
+        for (auto const & symbol : alt_sequence)
+            insertion_ranks.push_back(seqan3::to_rank(symbol));
+        coverages.push_back(coverage);
+    });
+
+    jst_meta const meta{.haplotype_count = rcs_store.size(),
+                        .source_size = std::ranges::size(rcs_store.source()),
+                        .variant_count = lows.size(),
+                        .coverage_block_size = std::max<uint64_t>(coverage_block_size, 1),
+                        .chunk_span = default_chunk_span};
+
+    container_header header{};
+    write_header(output_stream, header);
+
+    std::vector<jst_section_entry> table_of_contents{};
+    table_of_contents.push_back(write_section(output_stream,
+                                              static_cast<uint32_t>(jst_section::meta),
+                                              to_bytes(meta)));
+    table_of_contents.push_back(write_section(output_stream,
+                                              static_cast<uint32_t>(jst_section::packed_source),
+                                              to_bytes(packed_dna_sequence<alphabet_t>{rcs_store.source()})));
+    table_of_contents.push_back(write_section(output_stream,
+                                              static_cast<uint32_t>(jst_section::breakends),
+                                              to_bytes(lows, deletion_sizes, insertion_sizes, insertion_ranks)));
+
+    // Every coverage block is checksummed separately. The coverage section itself holds the table of the blocks.
+    std::vector<jst_section_entry> coverage_blocks{};
+    for (size_t first = 0; first < coverages.size(); first += meta.coverage_block_size) {
+        size_t last = std::min<size_t>(first + meta.coverage_block_size, coverages.size());
+        std::vector<coverage_t> block(std::make_move_iterator(coverages.begin() + first),
+                                      std::make_move_iterator(coverages.begin() + last));
+        coverage_blocks.push_back(write_section(output_stream,
+                                                static_cast<uint32_t>(jst_section::coverages),
+                                                to_bytes(block)));
+    }
+    table_of_contents.push_back(write_section(output_stream,
+                                              static_cast<uint32_t>(jst_section::coverages),
+                                              to_bytes(coverage_blocks)));
+
+    // The chunk index stores the first variant whose low breakend is not left of the chunk begin.
+    std::vector<uint64_t> chunk_index{};
+    for (uint64_t chunk_begin = 0; chunk_begin <= meta.source_size; chunk_begin += meta.chunk_span)
+        chunk_index.push_back(std::ranges::lower_bound(lows, chunk_begin) - lows.begin());
+    table_of_contents.push_back(write_section(output_stream,
+                                              static_cast<uint32_t>(jst_section::chunk_index),
+                                              to_bytes(chunk_index)));
+
+    std::string table_of_contents_bytes = to_bytes(table_of_contents);
+    header.table_of_contents_offset = output_stream.tellp();
+    header.table_of_contents_size = table_of_contents_bytes.size();
+    header.table_of_contents_checksum = crc32(table_of_contents_bytes);
+    output_stream.write(table_of_contents_bytes.data(), table_of_contents_bytes.size());
+
+    output_stream.seekp(0);
+    write_header(output_stream, header);
+
+    if (!output_stream.good())
+        throw std::runtime_error{"Failed writing the rcs store to ["s + output_path.string() + "]"s};
+}
+
+// ----------------------------------------------------------------------------
+// Reader
+// ----------------------------------------------------------------------------
+
+jst_container_reader::jst_container_reader(std::filesystem::path const & container_path) :
+    _path{container_path},
+    _stream{container_path, std::ios::binary}
+{
+    using namespace std::literals;
+
+    if (!_stream.good())
+        throw std::runtime_error{"Couldn't open path for loading the jst! The path is ["s + _path.string() + "]"s};
+
+    container_header header = read_header(_stream);
+    if (!_stream.good() || header.magic != jst_container_magic)
+        throw std::runtime_error{"The file ["s + _path.string() + "] is not a jst container!"s};
+    if (header.version > jst_container_version)
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] has the unsupported version "s +
+                                 std::to_string(header.version) + "!"s};
+
+    jst_section_entry table_of_contents_entry{.offset = header.table_of_contents_offset,
+                                              .size = header.table_of_contents_size,
+                                              .checksum = header.table_of_contents_checksum};
+    from_bytes(read_verified(table_of_contents_entry, "table of contents"), _table_of_contents);
+
+    if (auto meta_entry = find_section(jst_section::meta); meta_entry.has_value())
+        from_bytes(read_verified(*meta_entry, "meta"), _meta);
+    else
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] has no meta section!"s};
+
+    if (auto coverage_entry = find_section(jst_section::coverages); coverage_entry.has_value())
+        from_bytes(read_verified(*coverage_entry, "coverages"), _coverage_blocks);
+}
+
+bool jst_container_reader::is_container(std::filesystem::path const & path)
+{
+    std::ifstream input_stream{path, std::ios::binary};
+    std::array<char, 8> magic{};
+    input_stream.read(magic.data(), magic.size());
+    return input_stream.good() && magic == jst_container_magic;
+}
+
+jst_meta const & jst_container_reader::meta() const noexcept
+{
+    return _meta;
+}
+
+bool jst_container_reader::has_section(jst_section const section) const noexcept
+{
+    return find_section(section).has_value();
+}
+
+uint32_t jst_container_reader::section_checksum(jst_section const section) const
+{
+    using namespace std::literals;
+
+    auto entry = find_section(section);
+    if (!entry.has_value())
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] has no section with id "s +
+                                 std::to_string(static_cast<uint32_t>(section)) + "!"s};
+    return entry->checksum;
+}
+
+reference_t jst_container_reader::load_source() const
+{
+    using namespace std::literals;
+
+    if (auto packed_entry = find_section(jst_section::packed_source); packed_entry.has_value()) {
+        packed_dna_sequence<alphabet_t> packed_source{};
+        from_bytes(read_verified(*packed_entry, "source"), packed_source);
+        return packed_source.unpack<reference_t>();
+    }
+
+    auto entry = find_section(jst_section::source);
+    if (!entry.has_value())
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] has no source section!"s};
+
+    std::vector<uint8_t> ranks{};
+    from_bytes(read_verified(*entry, "source"), ranks);
+    return from_ranks(ranks.begin(), ranks.end());
+}
+
+std::vector<jst_breakend> jst_container_reader::load_breakends() const
+{
+    using namespace std::literals;
+
+    auto entry = find_section(jst_section::breakends);
+    if (!entry.has_value())
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] has no breakend section!"s};
+
+    std::vector<uint32_t> lows{};
+    std::vector<uint32_t> deletion_sizes{};
+    std::vector<uint32_t> insertion_sizes{};
+    std::vector<uint8_t> insertion_ranks{};
+    from_bytes(read_verified(*entry, "breakends"), lows, deletion_sizes, insertion_sizes, insertion_ranks);
+
+    std::vector<jst_breakend> breakends{};
+    breakends.reserve(lows.size());
+    auto rank_it = insertion_ranks.begin();
+    for (size_t idx = 0; idx < lows.size(); ++idx) {
+        breakends.push_back(jst_breakend{.low = lows[idx],
+                                         .deletion_size = deletion_sizes[idx],
+                                         .insertion = from_ranks(rank_it, rank_it + insertion_sizes[idx])});
+        rank_it += insertion_sizes[idx];
+    }
+    return breakends;
+}
+
+std::vector<uint64_t> jst_container_reader::load_chunk_index() const
+{
+    using namespace std::literals;
+
+    auto entry = find_section(jst_section::chunk_index);
+    if (!entry.has_value())
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] has no chunk index section!"s};
+
+    std::vector<uint64_t> chunk_index{};
+    from_bytes(read_verified(*entry, "chunk index"), chunk_index);
+    return chunk_index;
+}
+
+size_t jst_container_reader::coverage_block_count() const noexcept
+{
+    return _coverage_blocks.size();
+}
+
+std::vector<coverage_t> jst_container_reader::load_coverage_block(size_t const block_idx) const
+{
+    std::vector<coverage_t> coverages{};
+    from_bytes(read_verified(_coverage_blocks.at(block_idx), "coverage block"), coverages);
+    return coverages;
+}
+
+std::vector<bool>
+jst_container_reader::select_coverage_blocks(std::vector<std::pair<uint64_t, uint64_t>> const & source_ranges) const
+{
+    std::vector<bool> block_filter(coverage_block_count(), false);
+    if (source_ranges.empty() || block_filter.empty())
+        return block_filter;
+
+    std::vector<uint64_t> const chunk_index = load_chunk_index();
+    auto first_variant_of_chunk = [&] (uint64_t const chunk_idx) -> uint64_t {
+        return (chunk_idx < chunk_index.size()) ? chunk_index[chunk_idx] : _meta.variant_count;
+    };
+
+    for (auto [begin, end] : source_ranges) {
+        if (begin >= end)
+            continue;
+
+        // Widen the range to the chunk boundaries of the index.
+        uint64_t first_variant = first_variant_of_chunk(begin / _meta.chunk_span);
+        uint64_t last_variant = first_variant_of_chunk((end + _meta.chunk_span - 1) / _meta.chunk_span);
+        if (first_variant >= last_variant)
+            continue;
+
+        uint64_t const last_block = (last_variant - 1) / _meta.coverage_block_size;
+        for (uint64_t block_idx = first_variant / _meta.coverage_block_size; block_idx <= last_block; ++block_idx)
+            block_filter[block_idx] = true;
+    }
+    return block_filter;
+}
+
+rcs_store_t jst_container_reader::load_store() const
+{
+    return load_store(std::vector<bool>(coverage_block_count(), true));
+}
+
+rcs_store_t jst_container_reader::load_store(std::vector<bool> const & block_filter) const
+{
+    using namespace std::literals;
+
+    if (block_filter.size() != coverage_block_count())
+        throw std::invalid_argument{"The block filter has "s + std::to_string(block_filter.size()) + " entries but "s +
+                                    "the jst container stores "s + std::to_string(coverage_block_count()) +
+                                    " coverage blocks!"s};
+
+    rcs_store_t rcs_store{load_source(), static_cast<uint32_t>(_meta.haplotype_count)};
+    std::vector<jst_breakend> breakends = load_breakends();
+    if (breakends.size() != _meta.variant_count)
+        throw std::runtime_error{"The jst container ["s + _path.string() + "] stores "s +
+                                 std::to_string(breakends.size()) + " breakends but "s +
+                                 std::to_string(_meta.variant_count) + " variants!"s};
+
+    // The variants of the unselected blocks are added without carriers, so all variants keep their indices.
+    auto const domain = rcs_store.variants().coverage_domain();
+    for (size_t block_idx = 0; block_idx < coverage_block_count(); ++block_idx) {
+        size_t const first_variant = block_idx * _meta.coverage_block_size;
+        size_t const last_variant = std::min<size_t>(first_variant + _meta.coverage_block_size, breakends.size());
+        std::vector<coverage_t> coverages = (block_filter[block_idx])
+                                          ? load_coverage_block(block_idx)
+                                          : std::vector<coverage_t>(last_variant - first_variant, coverage_t{domain});
+        if (coverages.size() != last_variant - first_variant)
+            throw std::runtime_error{"The coverage block "s + std::to_string(block_idx) + " of the jst container ["s +
+                                     _path.string() + "] has an invalid size!"s};
+
+        for (size_t variant_idx = first_variant; variant_idx < last_variant; ++variant_idx) {
+            jst_breakend & breakend = breakends[variant_idx];
+            rcs_store.add(variant_t{libjst::breakpoint{breakend.low, breakend.deletion_size},
+                                    std::move(breakend.insertion),
+                                    std::move(coverages[variant_idx - first_variant])});
+        }
+    }
+    return rcs_store;
+}
+
+std::optional<jst_section_entry> jst_container_reader::find_section(jst_section const section) const noexcept
+{
+    auto it = std::ranges::find(_table_of_contents, static_cast<uint32_t>(section), &jst_section_entry::id);
+    if (it == _table_of_contents.end())
+        return std::nullopt;
+    return *it;
+}
+
+std::string jst_container_reader::read_verified(jst_section_entry const & entry, std::string_view section_name) const
+{
+    using namespace std::literals;
+
+    std::string bytes(entry.size, '\0');
+    _stream.clear();
+    _stream.seekg(entry.offset);
+    _stream.read(bytes.data(), bytes.size());
+
+    if (!_stream.good() || crc32(bytes) != entry.checksum)
+        throw std::runtime_error{"The "s + std::string{section_name} + " section of the jst container ["s +
+                                 _path.string() + "] is corrupted!"s};
+    return bytes;
+}
+
+} // namespace jstmap
@@ -0,0 +1,197 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the sectioned and checksummed container format of the jst.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap
+{
+    /*!\brief The sections of the jst container.
+     *
+     * \details
+     *
+     * The container starts with a fixed header holding the magic bytes, the format version and the position of the
+     * table of contents. The table of contents is written after the last section and lists the id, the offset,
+     * the size and the CRC-32 checksum of every section.
+     */
+    enum struct jst_section : uint32_t
+    {
+        meta = 1, //!< The jstmap::jst_meta information.
+        source = 2, //!< The reference sequence with one byte per base.
+        breakends = 3, //!< The breakpoints and alternate sequences of all variants.
+        coverages = 4, //!< The coverages of all variants, stored in independently checksummed blocks.
+        chunk_index = 5, //!< The index of the first variant per source chunk.
+        reverse = 6, //!< Reserved for a precomputed reverse store.
+        packed_source = 7 //!< The reference sequence as jstmap::packed_dna_sequence; unpacked when it is loaded.
+    };
+
+    //!\brief The global information about the stored rcs store.
+    struct jst_meta
+    {
+        uint64_t haplotype_count{}; //!< The number of haplotypes.
+        uint64_t source_size{}; //!< The length of the reference sequence.
+        uint64_t variant_count{}; //!< The number of stored variants.
+        uint64_t coverage_block_size{}; //!< The number of variants per coverage block.
+        uint64_t chunk_span{}; //!< The number of source positions per entry of the chunk index.
+
+        template <typename archive_t>
+        void serialize(archive_t & archive)
+        {
+            archive(haplotype_count, source_size, variant_count, coverage_block_size, chunk_span);
+        }
+    };
+
+    //!\brief A variant without its coverage as stored in the breakend section.
+    struct jst_breakend
+    {
+        uint32_t low{}; //!< The low breakend of the variant.
+        uint32_t deletion_size{}; //!< The number of deleted source positions.
+        reference_t insertion{}; //!< The inserted sequence.
+    };
+
+    //!\brief An entry of the table of contents.
+    struct jst_section_entry
+    {
+        uint32_t id{}; //!< The jstmap::jst_section id.
+        uint64_t offset{}; //!< The byte offset of the section within the file.
+        uint64_t size{}; //!< The byte size of the section.
+        uint32_t checksum{}; //!< The CRC-32 checksum of the section.
+
+        template <typename archive_t>
+        void serialize(archive_t & archive)
+        {
+            archive(id, offset, size, checksum);
+        }
+    };
+
+    //!\brief The magic bytes identifying the jst container.
+    inline constexpr std::array<char, 8> jst_container_magic{'\x89', 'J', 'S', 'T', '\r', '\n', '\x1a', '\n'};
+    //!\brief The current version of the jst container.
+    inline constexpr uint32_t jst_container_version = 1;
+    //!\brief The default number of variants per coverage block.
+    inline constexpr uint64_t jst_default_coverage_block_size = 1ull << 14;
+
+    /*!\brief Writes the rcs store as sectioned container.
+     *
+     * \param[in] rcs_store The store to write.
+     * \param[in] output_path The path of the container.
+     * \param[in] coverage_block_size The number of variants per coverage block.
+     *
+     * \throws std::runtime_error if the file can not be written.
+     */
+    void save_jst(rcs_store_t const & rcs_store,
+                  std::filesystem::path const & output_path,
+                  uint64_t coverage_block_size = jst_default_coverage_block_size);
+
+    /*!\brief Reads the sections of a jst container.
+     *
+     * \details
+     *
+     * Every section is read on demand and its checksum is verified before it is decoded.
+     * The coverages are stored in blocks of jstmap::jst_meta::coverage_block_size variants.
+     * Each block carries its own checksum and can be loaded separately.
+     * An std::runtime_error is thrown if a section is missing or corrupted.
+     */
+    class jst_container_reader
+    {
+    private:
+        std::filesystem::path _path{};
+        mutable std::ifstream _stream{};
+        std::vector<jst_section_entry> _table_of_contents{};
+        std::vector<jst_section_entry> _coverage_blocks{};
+        jst_meta _meta{};
+
+    public:
+
+        //!\brief Opens the container and reads its table of contents.
+        explicit jst_container_reader(std::filesystem::path const & container_path);
+
+        //!\brief Whether the file at the given path is a jst container.
+        static bool is_container(std::filesystem::path const & path);
+
+        jst_meta const & meta() const noexcept;
+        bool has_section(jst_section) const noexcept;
+
+        /*!\brief Returns the CRC-32 checksum of a section as listed in the table of contents.
+         *
+         * \details
+         *
+         * The coverage section lists the checksums of all coverage blocks, such that its checksum changes with
+         * the coverage of any variant.
+         * \throws std::runtime_error if the section is missing.
+         */
+        uint32_t section_checksum(jst_section) const;
+
+        /*!\brief Loads the reference sequence with one byte per base.
+         *
+         * \details
+         *
+         * The packed source section only reduces the size of the container and the bytes read from it. It is decoded
+         * completely into the unpacked source, since the sequence trees take the labels as slices of the source.
+         * Hence, the resident memory of the loaded store is the same as for the unpacked source section.
+         */
+        reference_t load_source() const;
+        std::vector<jst_breakend> load_breakends() const;
+        std::vector<uint64_t> load_chunk_index() const;
+
+        size_t coverage_block_count() const noexcept;
+        std::vector<coverage_t> load_coverage_block(size_t block_idx) const;
+
+        /*!\brief Selects the coverage blocks holding the variants of the given source ranges.
+         *
+         * \param[in] source_ranges The half-open source intervals to select the variants for.
+         *
+         * \details
+         *
+         * The chunk index maps every source range to the variants with a low breakend inside it.
+         * The returned vector has one entry per coverage block and is `true` for every block containing at least one
+         * of these variants.
+         */
+        std::vector<bool> select_coverage_blocks(std::vector<std::pair<uint64_t, uint64_t>> const & source_ranges) const;
+
+        //!\brief Loads the complete rcs store from the source, breakend and coverage sections.
+        rcs_store_t load_store() const;
+
+        /*!\brief Loads the rcs store with the variants of the selected coverage blocks only.
+         *
+         * \param[in] block_filter The selected coverage blocks; must have one entry per coverage block.
+         *
+         * \details
+         *
+         * The coverage blocks that are not selected are neither read nor decoded, and their variants are added to
+         * the store with an empty coverage. Hence, the store contains the same breakends as the complete store and
+         * every variant keeps its index, such that the positions of matches refer to the complete store. The
+         * haplotypes of every chunk of the source covered by the selected blocks are identical to the ones of the
+         * complete store, while all other variants are pruned by the coloured traversal.
+         *
+         * Only the coverages are loaded partially. The complete source and all breakends are still read, decoded and
+         * added to the store, because the variant indices and the source positions of the matches must refer to the
+         * complete store. Hence, a job selecting a few chunks saves the memory and time of the unselected coverages
+         * only, but still pays for the complete source and all breakends.
+         */
+        rcs_store_t load_store(std::vector<bool> const & block_filter) const;
+
+    private:
+        std::optional<jst_section_entry> find_section(jst_section) const noexcept;
+        std::string read_verified(jst_section_entry const &, std::string_view) const;
+    };
+}  // namespace jstmap
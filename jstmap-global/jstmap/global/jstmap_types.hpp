@@ -22,13 +22,13 @@
 
 #include <libjst/rcms/compressed_multisequence.hpp>
 #include <libjst/rcms/rcs_store.hpp>
-#include <libjst/coverage/int_coverage.hpp>
+#include <jstmap/global/adaptive_coverage.hpp>
 
 namespace jstmap
 {
 
 using alphabet_t = spm::dna5;
-using coverage_t = libjst::int_coverage<uint32_t>;
+using coverage_t = adaptive_coverage<uint32_t>;
 using reference_t = std::vector<alphabet_t>;
 using sequence_collection_t = std::vector<reference_t>;
 
@@ -5,32 +5,44 @@
 // shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
 // -----------------------------------------------------------------------------------------------------
 
-#include <fstream>
+#include <algorithm>
+#include <stdexcept>
 #include <string>
 
-#include <cereal/archives/binary.hpp>
-
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/jst_container.hpp>
 #include <jstmap/global/load_jst.hpp>
 
 namespace jstmap
 {
 
-rcs_store_t load_jst(std::filesystem::path const & rcs_store_path)
+namespace
+{
+// The coverage format changed with the container, so plain cereal archives of earlier versions can not be read.
+void check_is_container(std::filesystem::path const & rcs_store_path)
 {
     using namespace std::literals;
 
-    std::fstream rcs_store_stream{rcs_store_path};
-    if (!rcs_store_stream.good())
-        throw std::runtime_error{"Couldn't open path for loading the jst! The path is ["s +
-                                 rcs_store_path.string() +
-                                 "]"s};
-
-    rcs_store_t rcs_store{};
-    {
-        cereal::BinaryInputArchive input_archive{rcs_store_stream};
-        rcs_store.load(input_archive);
-    }
-    return rcs_store;
+    if (!jst_container_reader::is_container(rcs_store_path))
+        throw std::runtime_error{"The file ["s + rcs_store_path.string() + "] is not a jst container! Jst files "s +
+                                 "written by earlier versions must be recreated with jstmap create."s};
+}
+} // namespace
+
+rcs_store_t load_jst(std::filesystem::path const & rcs_store_path)
+{
+    check_is_container(rcs_store_path);
+    return jst_container_reader{rcs_store_path}.load_store();
+}
+
+rcs_store_t load_jst(std::filesystem::path const & rcs_store_path,
+                     std::vector<std::pair<uint64_t, uint64_t>> const & source_ranges)
+{
+    check_is_container(rcs_store_path);
+    jst_container_reader reader{rcs_store_path};
+    std::vector<bool> block_filter = reader.select_coverage_blocks(source_ranges);
+    log_debug("Loading ", std::ranges::count(block_filter, true), " of ", block_filter.size(), " coverage blocks");
+    return reader.load_store(block_filter);
 }
 
 } // namespace jstmap
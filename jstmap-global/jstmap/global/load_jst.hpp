@@ -5,13 +5,33 @@
 // shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
 // -----------------------------------------------------------------------------------------------------
 
+#include <cstdint>
 #include <filesystem>
+#include <utility>
+#include <vector>
 
 #include <jstmap/global/jstmap_types.hpp>
 
 namespace jstmap
 {
 
+/*!\brief Loads the store from a jst container.
+ *
+ * \throws std::runtime_error if the file is not a valid jst container.
+ */
 rcs_store_t load_jst(std::filesystem::path const &);
 
+/*!\brief Loads only the variants of the given source ranges.
+ *
+ * \details
+ *
+ * For a jst container only the coverage blocks overlapping one of the half-open source ranges are read.
+ * All variants with a low breakend in one of the ranges are contained in the returned store. Variants outside of
+ * the ranges might have an empty coverage, but every variant keeps the index it has in the complete store.
+ * Hence, the complete source and all breakends are loaded nevertheless; only the unselected coverages are skipped.
+ *
+ * \throws std::runtime_error if the file is not a valid jst container.
+ */
+rcs_store_t load_jst(std::filesystem::path const &, std::vector<std::pair<uint64_t, uint64_t>> const &);
+
 } // namespace jstmap
@@ -0,0 +1,136 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a streaming summary of the hits of a read to estimate its mapping quality.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace jstmap
+{
+    /*!\brief Summarises the hits of a read by the best and the second best error stratum.
+     *
+     * \details
+     *
+     * The hits are recorded by their error count as they are found, such that the mapping quality can be computed
+     * without keeping the hits. Only the two best strata are counted, since the hits of the worse strata hardly
+     * change the mapping quality. Summaries of the same read collected by different threads can be merged.
+     *
+     * The mapping quality is the phred scaled probability that the best hit is wrong, where a hit with `d` more
+     * errors than the best hits is assumed to be `10^(-d * error_penalty / 10)` times as likely.
+     * A unique best hit without a second stratum gets the maximal mapping quality.
+     */
+    class mapping_summary
+    {
+    private:
+
+        static constexpr uint32_t _no_hit = std::numeric_limits<uint32_t>::max();
+
+        uint32_t _best_error_count{_no_hit};
+        uint32_t _best_count{};
+        uint32_t _second_error_count{_no_hit};
+        uint32_t _second_count{};
+
+    public:
+
+        static constexpr uint8_t max_mapping_quality = 60; //!< The mapping quality of a unique hit.
+        static constexpr double error_penalty = 30.0; //!< The phred scaled likelihood of a single error.
+
+        /*!\brief Records the given number of hits with the same error count.
+         *
+         * \returns `true` if the hits have less errors than all previously recorded hits, otherwise `false`.
+         */
+        constexpr bool record(uint32_t const error_count, uint32_t const count = 1) noexcept
+        {
+            return add(error_count, count);
+        }
+
+        //!\brief Adds the strata of another summary of the same read.
+        constexpr void merge(mapping_summary const & other) noexcept
+        {
+            if (other._best_count > 0)
+                add(other._best_error_count, other._best_count);
+            if (other._second_count > 0)
+                add(other._second_error_count, other._second_count);
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return _best_count == 0;
+        }
+
+        constexpr uint32_t best_error_count() const noexcept
+        {
+            return _best_error_count;
+        }
+
+        constexpr uint32_t best_count() const noexcept
+        {
+            return _best_count;
+        }
+
+        constexpr uint32_t second_error_count() const noexcept
+        {
+            return _second_error_count;
+        }
+
+        constexpr uint32_t second_count() const noexcept
+        {
+            return _second_count;
+        }
+
+        //!\brief The mapping quality of the best hit; 0 if no hit was recorded.
+        uint8_t mapping_quality() const noexcept
+        {
+            if (empty())
+                return 0;
+
+            double likelihood_sum = _best_count;
+            if (_second_count > 0) {
+                double const error_distance = _second_error_count - _best_error_count;
+                likelihood_sum += _second_count * std::pow(10.0, -error_distance * error_penalty / 10.0);
+            }
+
+            double const error_probability = 1.0 - 1.0 / likelihood_sum;
+            if (error_probability <= 0.0)
+                return max_mapping_quality;
+
+            double const quality = std::round(-10.0 * std::log10(error_probability));
+            return static_cast<uint8_t>(std::clamp(quality, 0.0, static_cast<double>(max_mapping_quality)));
+        }
+
+    private:
+
+        constexpr bool add(uint32_t const error_count, uint32_t const count) noexcept
+        {
+            if (error_count < _best_error_count) {
+                _second_error_count = _best_error_count;
+                _second_count = _best_count;
+                _best_error_count = error_count;
+                _best_count = count;
+                return true;
+            }
+
+            if (error_count == _best_error_count) {
+                _best_count += count;
+            } else if (error_count < _second_error_count) {
+                _second_error_count = error_count;
+                _second_count = count;
+            } else if (error_count == _second_error_count) {
+                _second_count += count;
+            }
+            return false;
+        }
+    };
+}  // namespace jstmap
@@ -14,6 +14,7 @@
 
 #include <concepts>
 #include <iosfwd>
+#include <ranges>
 
 #include <libjst/sequence_tree/seek_position.hpp>
 
@@ -30,6 +31,22 @@ namespace jstmap
         constexpr friend auto operator<=>(match_position const &, match_position const &) noexcept = default;
     };
 
+    /*!\brief Returns the size of the path sequence ending with the label of the given node cargo.
+     *
+     * \details
+     *
+     * The label offsets of a jstmap::match_position are relative to the path sequence. Cargos that do not hold the path
+     * sequence, e.g. the jstmap::cached_node_cargo, provide its size with a member function `path_size()`.
+     */
+    template <typename cargo_t>
+    constexpr std::ptrdiff_t path_size(cargo_t const & cargo) noexcept
+    {
+        if constexpr (requires { cargo.path_size(); })
+            return static_cast<std::ptrdiff_t>(cargo.path_size());
+        else
+            return std::ranges::ssize(cargo.path_sequence());
+    }
+
     template <typename char_t, typename char_traits_t, typename match_position_t>
         requires std::same_as<std::remove_cvref_t<match_position_t>, match_position>
     inline std::basic_ostream<char_t, char_traits_t> & operator<<(std::basic_ostream<char_t, char_traits_t> & stream,
@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a 2-bit packed nucleotide sequence with a sparse list of N runs.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include <cereal/types/utility.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <seqan3/alphabet/concept.hpp>
+
+namespace jstmap
+{
+    /*!\brief A nucleotide sequence storing 2 bits per base and the positions of all N as runs.
+     *
+     * \tparam alphabet_t The nucleotide alphabet of the sequence; must contain the characters 'A', 'C', 'G', 'T' and 'N'.
+     *
+     * \details
+     *
+     * Four bases are packed into one byte, where the base at position `i` occupies the bits `2 * (i % 4)`.
+     * The N symbols are stored as a sorted list of non-overlapping runs and are encoded as 'A' in the packed bytes.
+     * Decoding uses a precomputed table mapping each byte to its four symbols, such that four bases are unpacked
+     * per lookup instead of shifting and masking every base.
+     * This type is only the encoding of the source section in the jst container; the loaded store keeps the source
+     * unpacked.
+     */
+    template <seqan3::writable_alphabet alphabet_t>
+    class packed_dna_sequence
+    {
+    private:
+        using run_type = std::pair<uint64_t, uint64_t>;
+
+        std::vector<uint8_t> _bytes{};
+        std::vector<run_type> _n_runs{};
+        uint64_t _size{};
+
+        static constexpr std::array<char, 4> _base_chars{'A', 'C', 'G', 'T'};
+
+    public:
+        using value_type = alphabet_t; //!< The type of the stored symbols.
+        using size_type = uint64_t; //!< The type of the size.
+
+        packed_dna_sequence() = default;
+
+        //!\brief Packs the given sequence.
+        template <std::ranges::input_range sequence_t>
+            requires std::convertible_to<std::ranges::range_reference_t<sequence_t>, alphabet_t>
+        explicit packed_dna_sequence(sequence_t && sequence)
+        {
+            if constexpr (std::ranges::sized_range<sequence_t>)
+                _bytes.reserve((std::ranges::size(sequence) + 3) / 4);
+
+            for (alphabet_t symbol : sequence)
+                push_back(symbol);
+        }
+
+        size_type size() const noexcept
+        {
+            return _size;
+        }
+
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        //!\brief The runs of N as pairs of begin position and length.
+        std::vector<run_type> const & n_runs() const noexcept
+        {
+            return _n_runs;
+        }
+
+        //!\brief Decodes the complete sequence into a container.
+        template <typename container_t = std::vector<alphabet_t>>
+        container_t unpack() const
+        {
+            container_t sequence{};
+            sequence.reserve(_size);
+            auto out = std::back_inserter(sequence);
+            size_type position = 0;
+            for (run_type const & run : _n_runs) {
+                out = decode_bases(position, run.first, out);
+                out = std::ranges::fill_n(out, run.second, seqan3::assign_char_to('N', alphabet_t{}));
+                position = run.first + run.second;
+            }
+            decode_bases(position, _size, out);
+            return sequence;
+        }
+
+        template <typename archive_t>
+        void serialize(archive_t & archive)
+        {
+            archive(_size, _bytes, _n_runs);
+        }
+
+        bool operator==(packed_dna_sequence const &) const = default;
+
+    private:
+
+        //!\brief Appends a symbol to the end of the sequence.
+        void push_back(alphabet_t const symbol)
+        {
+            if (_size % 4 == 0)
+                _bytes.push_back(0);
+
+            uint8_t code{};
+            switch (seqan3::to_char(symbol))
+            {
+                case 'C': code = 1; break;
+                case 'G': code = 2; break;
+                case 'T': code = 3; break;
+                case 'A': code = 0; break;
+                default: // every other symbol is stored as N.
+                    if (!_n_runs.empty() && _n_runs.back().first + _n_runs.back().second == _size)
+                        ++_n_runs.back().second;
+                    else
+                        _n_runs.emplace_back(_size, 1);
+            }
+            _bytes.back() |= code << (2 * (_size % 4));
+            ++_size;
+        }
+
+        //!\brief Decodes the bases in [first, last) without N, the aligned bytes with one table lookup each.
+        template <typename out_iterator_t>
+        out_iterator_t decode_bases(size_type position, size_type const last, out_iterator_t out) const
+        {
+            auto symbol_at = [&] (size_type const pos) {
+                return symbol_table()[(_bytes[pos / 4] >> (2 * (pos % 4))) & 0b11];
+            };
+
+            for (; position < last && position % 4 != 0; ++position)
+                *out++ = symbol_at(position);
+            for (; position + 4 <= last; position += 4)
+                out = std::ranges::copy(byte_table()[_bytes[position / 4]], out).out;
+            for (; position < last; ++position)
+                *out++ = symbol_at(position);
+            return out;
+        }
+
+        static std::array<alphabet_t, 4> const & symbol_table() noexcept
+        {
+            static std::array<alphabet_t, 4> const table = [] () {
+                std::array<alphabet_t, 4> symbols{};
+                for (size_t code = 0; code < symbols.size(); ++code)
+                    seqan3::assign_char_to(_base_chars[code], symbols[code]);
+                return symbols;
+            }();
+            return table;
+        }
+
+        static std::array<std::array<alphabet_t, 4>, 256> const & byte_table() noexcept
+        {
+            static std::array<std::array<alphabet_t, 4>, 256> const table = [] () {
+                std::array<std::array<alphabet_t, 4>, 256> symbols{};
+                for (size_t byte = 0; byte < symbols.size(); ++byte)
+                    for (size_t slot = 0; slot < 4; ++slot)
+                        symbols[byte][slot] = symbol_table()[(byte >> (2 * slot)) & 0b11];
+                return symbols;
+            }();
+            return table;
+        }
+    };
+}  // namespace jstmap
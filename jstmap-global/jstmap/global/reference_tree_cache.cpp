@@ -0,0 +1,37 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides implementation of the reference tree cache.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <jstmap/global/reference_tree_cache.hpp>
+
+namespace jstmap
+{
+    reference_tree_cache::tree_type const & reference_tree_cache::get(size_t const window_size) const
+    {
+        std::scoped_lock lock{_tree_mutex};
+        auto it = _trees.find(window_size);
+        if (it == _trees.end())
+            it = _trees.emplace(window_size, std::make_unique<tree_type>(create(window_size))).first;
+        return *it->second;
+    }
+
+    reference_tree_cache::tree_type reference_tree_cache::create(size_t const window_size) const
+    {
+        return _rcs_store | libjst::make_volatile()
+                          | libjst::labelled()
+                          | libjst::coloured()
+                          | libjst::trim(window_size)
+                         //  | libjst::prune()
+                          | libjst::left_extend(window_size)
+                          | libjst::merge()
+                          | libjst::seek();
+    }
+}  // namespace jstmap
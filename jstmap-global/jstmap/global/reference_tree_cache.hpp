@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the reference trees to seek the tree positions of the matches in.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <libspm/std/tag_invoke.hpp>
+
+#include <libjst/sequence_tree/coloured_tree.hpp>
+#include <libjst/sequence_tree/labelled_tree.hpp>
+#include <libjst/sequence_tree/left_extend_tree.hpp>
+#include <libjst/sequence_tree/merge_tree.hpp>
+#include <libjst/sequence_tree/seekable_tree.hpp>
+#include <libjst/sequence_tree/trim_tree.hpp>
+#include <libjst/sequence_tree/volatile_tree.hpp>
+
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap
+{
+
+    namespace detail {
+        namespace _defer {
+            template <auto & cpo, typename ...args_t>
+            struct _cpo  {
+                constexpr auto operator()() const
+                    noexcept(std::is_nothrow_invocable_v<std::tag_t<cpo>, args_t...>)
+                    -> std::invoke_result_t<std::tag_t<cpo>, args_t...> {
+                    return std::invoke(cpo, std::declval<args_t>()...);
+                }
+            };
+
+            template <auto & cpo, typename ...args_t>
+            inline constexpr _cpo<cpo, args_t...> defer;
+        } // namespace _defer
+
+        using _defer::defer;
+
+        template <auto & cpo>
+        using instantiate_t = std::invoke_result_t<std::tag_t<cpo>>;
+
+    } // namespace detail
+
+    template <typename rcs_store_t, auto & ...tree_cpos>
+    using composed_tree_t =
+        std::remove_cvref_t<
+            decltype((std::declval<rcs_store_t>() | ... | std::declval<detail::instantiate_t<tree_cpos>>()))
+        >;
+
+    /*!\brief Creates and keeps the reference trees in which the tree positions of the matches are sought.
+     *
+     * \details
+     *
+     * The tree positions reported by the search are only valid in the tree of the same window size, i.e. of the size
+     * of the matched query minus one. The cache keeps one tree per window size, which is created by the first thread
+     * that requests it. It is shared by the aligner of the search and the lineariser of the mapped records.
+     */
+    class reference_tree_cache {
+    public:
+
+        using tree_type = composed_tree_t<rcs_store_t const &,
+                                          libjst::make_volatile,
+                                          libjst::labelled,
+                                          libjst::coloured,
+                                          detail::defer<libjst::trim, size_t>,
+                                          // libjst::prune,
+                                          detail::defer<libjst::left_extend, size_t>,
+                                          libjst::merge,
+                                          libjst::seek
+                                         >;
+
+    private:
+
+        rcs_store_t const & _rcs_store;
+        mutable std::mutex _tree_mutex{};
+        mutable std::map<size_t, std::unique_ptr<tree_type>> _trees{};
+
+    public:
+
+        explicit reference_tree_cache(rcs_store_t const & rcs_store) noexcept : _rcs_store{rcs_store}
+        {}
+
+        //!\brief Returns the reference tree for the window size; thread-safe and valid for the lifetime of the cache.
+        tree_type const & get(size_t window_size) const;
+
+    private:
+
+        tree_type create(size_t const window_size) const;
+    };
+}  // namespace jstmap
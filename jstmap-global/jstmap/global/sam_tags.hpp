@@ -0,0 +1,168 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the custom sam tags storing the tree position of a match.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <seqan3/io/sam_file/sam_tag_dictionary.hpp>
+
+#include <libjst/sequence_tree/path_descriptor.hpp>
+#include <libjst/sequence_tree/seek_position.hpp>
+#include <libjst/utility/multi_invocable.hpp>
+
+#include <jstmap/global/match_position.hpp>
+
+namespace seqan3 {
+    template <> struct sam_tag_type<"ad"_tag> { using type = std::vector<std::byte>; }; //!< alternate path descriptor
+    template <> struct sam_tag_type<"al"_tag> { using type = int32_t; }; //!< length of the alternate path descriptor
+    template <> struct sam_tag_type<"rd"_tag> { using type = std::vector<std::byte>; }; //!< breakpoint end
+    template <> struct sam_tag_type<"lo"_tag> { using type = int32_t; }; //!< label offset
+    template <> struct sam_tag_type<"hs"_tag> { using type = std::vector<uint8_t>; }; //!< haplotype set
+    template <> struct sam_tag_type<"ma"_tag> { using type = std::vector<std::byte>; }; //!< alternate path descriptor of the mate
+    template <> struct sam_tag_type<"ml"_tag> { using type = int32_t; }; //!< descriptor length of the mate
+    template <> struct sam_tag_type<"mr"_tag> { using type = std::vector<std::byte>; }; //!< breakpoint end of the mate
+    template <> struct sam_tag_type<"mo"_tag> { using type = int32_t; }; //!< label offset of the mate
+    template <> struct sam_tag_type<"ms"_tag> { using type = int32_t; }; //!< sequence size of the mate
+} // namespace seqan3
+
+namespace jstmap
+{
+    //!\brief The tags storing a tree position, whose variant index is stored in the position field of the record.
+    struct tree_position_tags
+    {
+        uint16_t alternate_path{}; //!< The bits of the alternate path descriptor.
+        uint16_t alternate_path_length{}; //!< The number of steps of the alternate path descriptor.
+        uint16_t breakend{}; //!< The breakpoint end of a reference node.
+        uint16_t label_offset{}; //!< The offset of the match within the path sequence.
+
+        //!\brief The tags of the tree position in the order they are listed.
+        std::array<uint16_t, 4> ids() const noexcept
+        {
+            return {alternate_path, alternate_path_length, breakend, label_offset};
+        }
+    };
+
+    //!\brief The tags storing the tree position of the record, whose variant index is stored in POS.
+    inline constexpr tree_position_tags match_position_tags = [] () {
+        using namespace seqan3::literals;
+        return tree_position_tags{"ad"_tag, "al"_tag, "rd"_tag, "lo"_tag};
+    }();
+
+    //!\brief The tags storing the tree position of the primary record of the mate, whose variant index is in PNEXT.
+    inline constexpr tree_position_tags mate_position_tags = [] () {
+        using namespace seqan3::literals;
+        return tree_position_tags{"ma"_tag, "ml"_tag, "mr"_tag, "mo"_tag};
+    }();
+
+    //!\brief Whether the tags store a tree position.
+    inline bool has_tree_position(seqan3::sam_tag_dictionary const & tags,
+                                  tree_position_tags const & position_tags = match_position_tags) noexcept
+    {
+        return tags.contains(position_tags.alternate_path) || tags.contains(position_tags.breakend);
+    }
+
+    /*!\brief Stores the tree position and the label offset of a match in the tags.
+     *
+     * \param[in] position The match position to store; its variant index is stored in the position field instead.
+     * \param[in,out] tags The tags to add the tree position to.
+     * \param[in] position_tags The tags storing the tree position.
+     *
+     * \details
+     *
+     * The alternate path descriptor is stored as its bits together with its number of steps, which the byte encoding
+     * loses. A breakpoint end is stored as the bytes of its value.
+     */
+    inline void encode_match_position(match_position const & position,
+                                      seqan3::sam_tag_dictionary & tags,
+                                      tree_position_tags const & position_tags = match_position_tags)
+    {
+        position.tree_position.visit(libjst::multi_invocable{
+            [&] (libjst::alternate_path_descriptor const & descriptor) {
+                std::vector<std::byte> descriptor_bytes((descriptor.size() + 7) / 8, std::byte{});
+                std::memcpy(descriptor_bytes.data(), descriptor.data(), descriptor_bytes.size());
+                tags[position_tags.alternate_path] = std::move(descriptor_bytes);
+                tags[position_tags.alternate_path_length] = static_cast<int32_t>(descriptor.size());
+            },
+            [&] (libjst::breakpoint_end descriptor) {
+                using data_t = std::underlying_type_t<libjst::breakpoint_end>;
+                data_t const data = static_cast<data_t>(descriptor);
+                std::vector<std::byte> breakend_bytes(sizeof(data_t), std::byte{});
+                std::memcpy(breakend_bytes.data(), &data, breakend_bytes.size());
+                tags[position_tags.breakend] = std::move(breakend_bytes);
+            }
+        });
+        tags[position_tags.label_offset] = static_cast<int32_t>(position.label_offset);
+    }
+
+    //!\brief Removes the tags of a tree position.
+    inline void erase_match_position(seqan3::sam_tag_dictionary & tags,
+                                     tree_position_tags const & position_tags = match_position_tags)
+    {
+        for (uint16_t const tag : position_tags.ids())
+            tags.erase(tag);
+    }
+
+    /*!\brief Restores the match position written by the jstmap::bam_writer.
+     *
+     * \param[in] variant_index The variant index of the tree position, which is written as the position of the record,
+     *                          or as the position of the mate for the mate position tags.
+     * \param[in] tags The tags of the record.
+     * \param[in] position_tags The tags storing the tree position.
+     *
+     * \throws std::runtime_error if the tags do not contain a tree position.
+     *
+     * \details
+     *
+     * The first step of an alternate path descriptor initiates the alternate node of the variant, all further steps
+     * are replayed in order. Records written before the length of the descriptor was stored replay all bits of the
+     * `ad` tag.
+     */
+    inline match_position decode_match_position(size_t const variant_index,
+                                                seqan3::sam_tag_dictionary const & tags,
+                                                tree_position_tags const & position_tags = match_position_tags)
+    {
+        match_position position{};
+        if (auto it = tags.find(position_tags.alternate_path); it != tags.end()) {
+            auto const & descriptor_bytes = std::get<std::vector<std::byte>>(it->second);
+            size_t step_count = descriptor_bytes.size() * 8;
+            if (auto length_it = tags.find(position_tags.alternate_path_length); length_it != tags.end())
+                step_count = std::get<int32_t>(length_it->second);
+
+            position.tree_position.initiate_alternate_node(variant_index);
+            for (size_t step = 1; step < step_count; ++step) {
+                std::byte const bit = (descriptor_bytes[step / 8] >> (step % 8)) & std::byte{1};
+                position.tree_position.next_alternate_node(bit != std::byte{0});
+            }
+        } else if (auto it = tags.find(position_tags.breakend); it != tags.end()) {
+            using data_t = std::underlying_type_t<libjst::breakpoint_end>;
+            auto const & breakend_bytes = std::get<std::vector<std::byte>>(it->second);
+            data_t data{};
+            std::memcpy(&data, breakend_bytes.data(), std::min(sizeof(data_t), breakend_bytes.size()));
+            position.tree_position.reset(variant_index, static_cast<libjst::breakpoint_end>(data));
+        } else {
+            throw std::runtime_error{"The record does not store a tree position."};
+        }
+
+        if (auto it = tags.find(position_tags.label_offset); it != tags.end())
+            position.label_offset = std::get<int32_t>(it->second);
+        return position;
+    }
+}  // namespace jstmap
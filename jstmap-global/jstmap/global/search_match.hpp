@@ -13,7 +13,9 @@
 #pragma once
 
 #include <concepts>
+#include <cstdint>
 #include <optional>
+#include <vector>
 
 #include <seqan3/alphabet/cigar/cigar.hpp>
 #include <seqan3/alignment/cigar_conversion/cigar_from_alignment.hpp>
@@ -27,6 +29,11 @@ namespace jstmap
         int32_t score{};
         std::vector<seqan3::cigar> cigar_sequence{};
 
+        explicit alignment_result(int32_t score, std::vector<seqan3::cigar> cigar_sequence) noexcept :
+            score{score},
+            cigar_sequence{std::move(cigar_sequence)}
+        {}
+
         template <typename original_result_t>
             requires (!std::same_as<std::remove_cvref_t<original_result_t>, alignment_result>)
         explicit alignment_result(original_result_t && res) noexcept :
@@ -60,12 +67,26 @@ namespace jstmap
             return _alignment.has_value();
         }
 
+        int32_t get_score() const noexcept {
+            return _alignment->score;
+        }
+
         std::vector<seqan3::cigar> get_cigar() const noexcept {
             return _alignment->cigar_sequence;
         }
+
+        //!\brief Sets the haplotypes supporting the match as encoded by jstmap::encode_haplotype_set.
+        void set_haplotypes(std::vector<uint8_t> haplotypes) noexcept {
+            _haplotypes = std::move(haplotypes);
+        }
+
+        std::vector<uint8_t> const & haplotypes() const noexcept {
+            return _haplotypes;
+        }
     private:
 
         match_position _position{};
         std::optional<alignment_result> _alignment{std::nullopt};
+        std::vector<uint8_t> _haplotypes{};
     };
 }  // namespace jstmap
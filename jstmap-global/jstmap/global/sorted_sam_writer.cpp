@@ -0,0 +1,254 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides implementation of the sorted sam writer.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+#include <seqan3/io/sam_file/input.hpp>
+
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/sorted_sam_writer.hpp>
+
+namespace jstmap {
+
+    namespace {
+        inline constexpr auto position_of = [] (sorted_sam_writer::record_type const & record) noexcept {
+            return std::tuple{record.reference_id, record.reference_position};
+        };
+    } // namespace
+
+    sorted_sam_writer::sorted_sam_writer(std::filesystem::path output_path,
+                                         reference_names_type reference_names,
+                                         reference_lengths_type reference_lengths,
+                                         sort_configuration configuration) :
+        _output_path{std::move(output_path)},
+        _reference_names{std::move(reference_names)},
+        _reference_lengths{std::move(reference_lengths)},
+        _configuration{configuration},
+        _output_file{_output_path, _reference_names, _reference_lengths}
+    {
+        using namespace std::literals;
+        _configuration.thread_count = std::max<size_t>(_configuration.thread_count, 1);
+        _output_file.header().sorting = _configuration.has_coordinates ? "coordinate"s : "unknown"s;
+    }
+
+    sorted_sam_writer::~sorted_sam_writer()
+    {
+        try {
+            finish();
+        } catch (std::exception const & ex) {
+            log_err("While writing the sorted records: ", ex.what());
+        }
+
+        std::error_code ignored{};
+        for (std::filesystem::path const & run_path : _run_paths)
+            std::filesystem::remove(run_path, ignored);
+    }
+
+    void sorted_sam_writer::push(record_type record)
+    {
+        _buffer_memory += estimate_memory(record);
+        _buffer.push_back(std::move(record));
+        if (_buffer_memory > _configuration.max_memory)
+            spill();
+    }
+
+    void sorted_sam_writer::finish()
+    {
+        if (_is_finished)
+            return;
+
+        _is_finished = true;
+        std::ranges::stable_sort(_buffer, std::less<>{}, position_of);
+        if (_run_paths.empty()) {
+            std::ranges::for_each(_buffer, [&] (record_type & record) { write_record(record); });
+        } else {
+            log_debug("Merging ", _run_paths.size(), " sorted runs");
+            merge_runs();
+        }
+        _buffer.clear();
+        _buffer_memory = 0;
+
+        for (std::filesystem::path const & run_path : _run_paths)
+            std::filesystem::remove(run_path);
+        _run_paths.clear();
+    }
+
+    void sorted_sam_writer::spill()
+    {
+        using namespace std::literals;
+
+        // Every thread sorts and writes a contiguous slice, such that the runs keep the order of the added records.
+        size_t const slice_count = std::min(_configuration.thread_count, _buffer.size());
+        size_t const slice_size = (_buffer.size() + slice_count - 1) / slice_count;
+        std::vector<std::exception_ptr> errors(slice_count);
+        {
+            std::vector<std::jthread> workers{};
+            workers.reserve(slice_count);
+            for (size_t slice = 0; slice < slice_count; ++slice) {
+                size_t const first = slice * slice_size;
+                size_t const last = std::min(first + slice_size, _buffer.size());
+                std::filesystem::path run_path = _output_path;
+                run_path += ".run"s + std::to_string(_run_paths.size()) + ".bam"s;
+                _run_paths.push_back(run_path);
+                workers.emplace_back([this, &errors, slice, first, last, run_path = std::move(run_path)] () {
+                    try {
+                        write_run(run_path, first, last);
+                    } catch (...) {
+                        errors[slice] = std::current_exception();
+                    }
+                });
+            }
+        }
+
+        for (std::exception_ptr const & error : errors)
+            if (error)
+                std::rethrow_exception(error);
+
+        log_debug("Spilled ", _buffer.size(), " records into ", slice_count, " sorted runs");
+        _buffer.clear();
+        _buffer_memory = 0;
+    }
+
+    void sorted_sam_writer::write_run(std::filesystem::path const & run_path, size_t const first, size_t const last)
+    {
+        auto slice = std::ranges::subrange{_buffer.begin() + first, _buffer.begin() + last};
+        std::ranges::stable_sort(slice, std::less<>{}, position_of);
+
+        output_file_type run_file{run_path, _reference_names, _reference_lengths};
+        for (record_type & record : slice)
+            run_file.emplace_back(std::move(record.id),
+                                  record.flag,
+                                  run_file.header().ref_ids()[record.reference_id],
+                                  record.reference_position,
+                                  record.mapping_quality,
+                                  std::move(record.cigar_sequence),
+                                  std::tuple{record.mate_reference_id, record.mate_position, record.template_length},
+                                  std::move(record.sequence),
+                                  std::move(record.tags));
+    }
+
+    void sorted_sam_writer::merge_runs()
+    {
+        using run_file_type = seqan3::sam_file_input<seqan3::sam_file_input_default_traits<>,
+                                                     field_ids_type,
+                                                     seqan3::type_list<seqan3::format_bam>>;
+        using run_iterator_type = std::ranges::iterator_t<run_file_type>;
+
+        std::vector<std::unique_ptr<run_file_type>> run_files{};
+        std::vector<run_iterator_type> run_iterators{};
+        run_files.reserve(_run_paths.size());
+        run_iterators.reserve(_run_paths.size());
+        for (std::filesystem::path const & run_path : _run_paths) {
+            run_files.push_back(std::make_unique<run_file_type>(run_path));
+            run_iterators.push_back(run_files.back()->begin());
+        }
+
+        // The runs are merged by the position of their current records; the buffer is merged as the last run.
+        size_t const buffer_source = run_files.size();
+        size_t buffer_position{};
+        std::vector<record_type> heads(buffer_source + 1);
+        auto advance = [&] (size_t const source) -> bool {
+            if (source == buffer_source) {
+                if (buffer_position == _buffer.size())
+                    return false;
+                heads[source] = std::move(_buffer[buffer_position++]);
+                return true;
+            }
+
+            run_iterator_type & it = run_iterators[source];
+            if (it == run_files[source]->end())
+                return false;
+
+            auto && record = *it;
+            heads[source] = record_type{.id = std::move(record.id()),
+                                        .flag = record.flag(),
+                                        .reference_id = record.reference_id().value_or(0),
+                                        .reference_position = record.reference_position().value_or(0),
+                                        .mapping_quality = record.mapping_quality(),
+                                        .cigar_sequence = std::move(record.cigar_sequence()),
+                                        .mate_reference_id = record.mate_reference_id(),
+                                        .mate_position = record.mate_position(),
+                                        .template_length = record.template_length(),
+                                        .sequence = std::move(record.sequence()),
+                                        .tags = std::move(record.tags())};
+            ++it;
+            return true;
+        };
+
+        // Records with equal positions are taken from the earlier run first, which keeps the merge stable.
+        using queue_entry_type = std::tuple<int32_t, int32_t, size_t>;
+        std::priority_queue<queue_entry_type, std::vector<queue_entry_type>, std::greater<>> queue{};
+        auto enqueue = [&] (size_t const source) {
+            if (advance(source))
+                queue.emplace(heads[source].reference_id, heads[source].reference_position, source);
+        };
+
+        for (size_t source = 0; source <= buffer_source; ++source)
+            enqueue(source);
+
+        while (!queue.empty()) {
+            size_t const source = std::get<2>(queue.top());
+            queue.pop();
+            write_record(heads[source]);
+            enqueue(source);
+        }
+    }
+
+    void sorted_sam_writer::write_record(record_type & record)
+    {
+        _output_file.emplace_back(std::move(record.id),
+                                  record.flag,
+                                  _output_file.header().ref_ids()[record.reference_id],
+                                  record.reference_position,
+                                  record.mapping_quality,
+                                  std::move(record.cigar_sequence),
+                                  std::tuple{record.mate_reference_id, record.mate_position, record.template_length},
+                                  std::move(record.sequence),
+                                  std::move(record.tags));
+    }
+
+    size_t sorted_sam_writer::estimate_memory(record_type const & record) noexcept
+    {
+        // Every tag is stored in the node of a map, which holds the value and three pointers and the colour of the
+        // red-black tree. Strings and arrays, like the haplotype set, keep their elements on the heap.
+        static constexpr size_t tag_node_memory = sizeof(seqan3::sam_tag_dictionary::value_type) + 4 * sizeof(void *);
+
+        size_t tag_memory{};
+        for (auto const & [tag, value] : record.tags) {
+            tag_memory += tag_node_memory + std::visit([] (auto const & tag_value) -> size_t {
+                using tag_value_t = std::remove_cvref_t<decltype(tag_value)>;
+                if constexpr (std::ranges::contiguous_range<tag_value_t>)
+                    return tag_value.capacity() * sizeof(std::ranges::range_value_t<tag_value_t>);
+                else
+                    return 0;
+            }, value);
+        }
+
+        return sizeof(record_type) +
+               record.id.capacity() +
+               record.cigar_sequence.capacity() * sizeof(seqan3::cigar) +
+               record.sequence.capacity() * sizeof(seqan3::dna5) +
+               tag_memory;
+    }
+
+}  // namespace jstmap
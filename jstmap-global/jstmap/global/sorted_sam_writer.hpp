@@ -0,0 +1,138 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a sam writer sorting the records by their position with an external merge sort.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <seqan3/alphabet/cigar/cigar.hpp>
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+#include <seqan3/io/sam_file/output.hpp>
+#include <seqan3/io/sam_file/sam_flag.hpp>
+#include <seqan3/io/sam_file/sam_tag_dictionary.hpp>
+
+namespace jstmap
+{
+    //!\brief The configuration of the coordinate sorted output.
+    struct sort_configuration
+    {
+        size_t max_memory{size_t{1} << 30}; //!< The number of bytes of the buffered records before they are spilled.
+        size_t thread_count{1}; //!< The number of threads sorting and writing the spilled runs.
+        //!\brief Whether the positions are coordinates of the references; only then the header declares the
+        //!        output as coordinate sorted, otherwise the sort order is unknown.
+        bool has_coordinates{false};
+    };
+
+    /*!\brief Writes the records sorted by their position into a sam or bam file.
+     *
+     * \details
+     *
+     * The records are buffered until their estimated memory exceeds the configured maximum. Then, the buffer is split
+     * into one slice per thread, and every thread sorts its slice and writes it as a run into a temporary bam file
+     * next to the output file. When the writer is finished, the runs and the remaining buffer are merged with a
+     * k-way merge into the output file; if no run was spilled, the buffer is only sorted and written.
+     * The sort is stable, i.e. records with the same position are written in the order they were added.
+     *
+     * Every thread compresses its own run, and the bam output is compressed by the threads of the bgzf stream of seqan3.
+     */
+    class sorted_sam_writer
+    {
+    public:
+
+        //!\brief A buffered record.
+        struct record_type
+        {
+            std::string id{};
+            seqan3::sam_flag flag{};
+            int32_t reference_id{};
+            int32_t reference_position{};
+            uint8_t mapping_quality{};
+            std::vector<seqan3::cigar> cigar_sequence{};
+            std::optional<int32_t> mate_reference_id{}; //!< The RNEXT field; not set if the record has no mate.
+            std::optional<int32_t> mate_position{}; //!< The PNEXT field; not set if the record has no mate.
+            int32_t template_length{}; //!< The TLEN field; 0 if unknown.
+            std::vector<seqan3::dna5> sequence{};
+            seqan3::sam_tag_dictionary tags{};
+        };
+
+    private:
+
+        using field_ids_type = seqan3::fields<seqan3::field::id,
+                                              seqan3::field::flag,
+                                              seqan3::field::ref_id,
+                                              seqan3::field::ref_offset,
+                                              seqan3::field::mapq,
+                                              seqan3::field::cigar,
+                                              seqan3::field::mate,
+                                              seqan3::field::seq,
+                                              seqan3::field::tags>;
+        using valid_format_type = seqan3::type_list<seqan3::format_bam, seqan3::format_sam>;
+        using reference_names_type = std::vector<std::string>;
+        using reference_lengths_type = std::vector<std::size_t>;
+        using output_file_type = seqan3::sam_file_output<field_ids_type, valid_format_type, reference_names_type>;
+
+        std::filesystem::path _output_path{};
+        reference_names_type _reference_names{};
+        reference_lengths_type _reference_lengths{};
+        sort_configuration _configuration{};
+        output_file_type _output_file;
+        std::vector<record_type> _buffer{};
+        std::vector<std::filesystem::path> _run_paths{};
+        size_t _buffer_memory{};
+        bool _is_finished{false};
+
+    public:
+
+        sorted_sam_writer(std::filesystem::path output_path,
+                          reference_names_type reference_names,
+                          reference_lengths_type reference_lengths,
+                          sort_configuration configuration);
+        sorted_sam_writer(sorted_sam_writer const &) = delete;
+        sorted_sam_writer & operator=(sorted_sam_writer const &) = delete;
+
+        //!\brief Finishes the output if it was not finished explicitly and removes the spilled runs.
+        ~sorted_sam_writer();
+
+        //!\brief The header of the output file.
+        auto & header()
+        {
+            return _output_file.header();
+        }
+
+        //!\brief Adds a record and spills the buffer if it exceeds the maximal memory.
+        void push(record_type record);
+
+        /*!\brief Merges the spilled runs and the buffer into the output file.
+         *
+         * \throws std::runtime_error if a run can not be written or read.
+         */
+        void finish();
+
+        //!\brief The number of spilled runs.
+        size_t run_count() const noexcept
+        {
+            return _run_paths.size();
+        }
+
+    private:
+
+        void spill();
+        void write_run(std::filesystem::path const & run_path, size_t first, size_t last);
+        void merge_runs();
+        void write_record(record_type & record);
+        static size_t estimate_memory(record_type const & record) noexcept;
+    };
+}  // namespace jstmap
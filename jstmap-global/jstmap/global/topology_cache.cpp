@@ -0,0 +1,155 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the precomputed topology of the filter trees of all chunks.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <libjst/utility/multi_invocable.hpp>
+
+#include <jstmap/global/packed_dna_sequence.hpp>
+#include <jstmap/global/topology_cache.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+inline constexpr uint64_t topology_cache_magic = 0x32504f544a53544aull; // "JSTJTOP2"
+
+// A seek position is encoded by its variant index, the breakpoint end of a reference node, and the descriptor of an
+// alternate path; the descriptor is empty for reference nodes.
+struct encoded_seek_position
+{
+    int64_t variant_index{};
+    uint8_t breakpoint_end{};
+    std::vector<bool> alternate_path{};
+
+    template <typename archive_t>
+    void serialize(archive_t & archive)
+    {
+        archive(variant_index, breakpoint_end, alternate_path);
+    }
+};
+
+encoded_seek_position encode(libjst::seek_position const & position)
+{
+    encoded_seek_position encoded{.variant_index = static_cast<int64_t>(position.get_variant_index())};
+    position.visit(libjst::multi_invocable{
+        [&] (libjst::breakpoint_end site) {
+            encoded.breakpoint_end = static_cast<uint8_t>(site);
+        },
+        [&] (libjst::alternate_path_descriptor const & descriptor) {
+            for (bool is_alternate : descriptor)
+                encoded.alternate_path.push_back(is_alternate);
+        }
+    });
+    return encoded;
+}
+
+// A cached node is encoded by its seek position and the position of its label.
+struct encoded_filter_node
+{
+    encoded_seek_position position{};
+    uint64_t label_begin{};
+    uint64_t label_size{};
+    uint64_t path_size{};
+    bool is_source_label{};
+
+    template <typename archive_t>
+    void serialize(archive_t & archive)
+    {
+        archive(position, label_begin, label_size, path_size, is_source_label);
+    }
+};
+
+libjst::seek_position decode(encoded_seek_position const & encoded)
+{
+    libjst::seek_position position{};
+    if (encoded.alternate_path.empty()) {
+        position.reset(encoded.variant_index, static_cast<libjst::breakpoint_end>(encoded.breakpoint_end));
+    } else { // The first step of the descriptor is set when the alternate node is initiated.
+        position.initiate_alternate_node(encoded.variant_index);
+        for (auto it = std::ranges::next(encoded.alternate_path.begin()); it != encoded.alternate_path.end(); ++it)
+            position.next_alternate_node(*it);
+    }
+    return position;
+}
+} // namespace
+
+void topology_cache::save(std::filesystem::path const & cache_path) const
+{
+    using namespace std::literals;
+
+    std::ofstream output_stream{cache_path, std::ios::binary};
+    if (!output_stream.good())
+        throw std::runtime_error{"Couldn't open path for storing the topology cache! The path is ["s +
+                                 cache_path.string() + "]"s};
+
+    cereal::BinaryOutputArchive archive{output_stream};
+    archive(topology_cache_magic, _bin_size, _window_size, _jst, static_cast<uint64_t>(_chunks.size()));
+    for (cached_chunk const & chunk : _chunks) {
+        std::vector<encoded_filter_node> encoded_nodes{};
+        encoded_nodes.reserve(chunk.nodes.size());
+        for (cached_filter_node const & node : chunk.nodes)
+            encoded_nodes.push_back(encoded_filter_node{.position = encode(node.position),
+                                                        .label_begin = node.label_begin,
+                                                        .label_size = node.label_size,
+                                                        .path_size = node.path_size,
+                                                        .is_source_label = node.is_source_label});
+        archive(encoded_nodes, packed_dna_sequence<alphabet_t>{chunk.labels});
+    }
+}
+
+topology_cache topology_cache::load(std::filesystem::path const & cache_path)
+{
+    using namespace std::literals;
+
+    std::ifstream input_stream{cache_path, std::ios::binary};
+    if (!input_stream.good())
+        throw std::runtime_error{"Couldn't open path for loading the topology cache! The path is ["s +
+                                 cache_path.string() + "]"s};
+
+    cereal::BinaryInputArchive archive{input_stream};
+    uint64_t magic{};
+    uint64_t chunk_count{};
+    topology_cache cache{};
+    archive(magic);
+    if (magic != topology_cache_magic)
+        throw std::runtime_error{"The file ["s + cache_path.string() + "] is not a topology cache!"s};
+
+    archive(cache._bin_size, cache._window_size, cache._jst, chunk_count);
+    cache._chunks.resize(chunk_count);
+    for (cached_chunk & chunk : cache._chunks) {
+        std::vector<encoded_filter_node> encoded_nodes{};
+        packed_dna_sequence<alphabet_t> packed_labels{};
+        archive(encoded_nodes, packed_labels);
+        chunk.labels = packed_labels.unpack<reference_t>();
+        chunk.nodes.reserve(encoded_nodes.size());
+        for (encoded_filter_node const & encoded : encoded_nodes) {
+            if (!encoded.is_source_label && encoded.label_begin + encoded.label_size > chunk.labels.size())
+                throw std::runtime_error{"The topology cache ["s + cache_path.string() + "] is corrupted!"s};
+
+            chunk.nodes.push_back(cached_filter_node{.position = decode(encoded.position),
+                                                     .label_begin = encoded.label_begin,
+                                                     .label_size = encoded.label_size,
+                                                     .path_size = encoded.path_size,
+                                                     .is_source_label = encoded.is_source_label});
+        }
+    }
+    return cache;
+}
+
+} // namespace jstmap
@@ -0,0 +1,260 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the precomputed topology of the filter trees of all chunks.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <libjst/sequence_tree/seek_position.hpp>
+#include <libjst/traversal/tree_traverser_base.hpp>
+
+#include <jstmap/global/filter_tree.hpp>
+#include <jstmap/global/jst_container.hpp>
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap
+{
+    /*!\brief Identifies the variants of a jst container.
+     *
+     * \details
+     *
+     * The filter tree topology depends on the breakends and the coverages of the variants, and the cached labels contain
+     * symbols of the source. All three are identified by the checksums of their sections in the jst container.
+     */
+    struct jst_fingerprint
+    {
+        uint64_t variant_count{}; //!< The number of variants.
+        uint32_t source_checksum{}; //!< The checksum of the source section.
+        uint32_t breakends_checksum{}; //!< The checksum of the jstmap::jst_section::breakends.
+        uint32_t coverages_checksum{}; //!< The checksum of the jstmap::jst_section::coverages.
+
+        //!\brief Reads the fingerprint from the table of contents of the container.
+        static jst_fingerprint read(jst_container_reader const & jst)
+        {
+            jst_section const source_section = jst.has_section(jst_section::packed_source) ? jst_section::packed_source
+                                                                                           : jst_section::source;
+            return jst_fingerprint{.variant_count = jst.meta().variant_count,
+                                   .source_checksum = jst.section_checksum(source_section),
+                                   .breakends_checksum = jst.section_checksum(jst_section::breakends),
+                                   .coverages_checksum = jst.section_checksum(jst_section::coverages)};
+        }
+
+        template <typename archive_t>
+        void serialize(archive_t & archive)
+        {
+            archive(variant_count, source_checksum, breakends_checksum, coverages_checksum);
+        }
+
+        bool operator==(jst_fingerprint const &) const = default;
+    };
+
+    //!\brief A filter tree node as it is replayed from the jstmap::topology_cache.
+    struct cached_filter_node
+    {
+        libjst::seek_position position{}; //!< The seek position of the node.
+        uint64_t label_begin{}; //!< The begin of the label in the source or in the stored labels of the chunk.
+        uint64_t label_size{}; //!< The size of the label.
+        uint64_t path_size{}; //!< The size of the path sequence ending with the label.
+        bool is_source_label{}; //!< Whether the label is a slice of the source.
+
+        bool operator==(cached_filter_node const &) const = default;
+    };
+
+    //!\brief The cargo of a replayed filter tree node with the label, the seek position and the path size of the node.
+    class cached_node_cargo
+    {
+    private:
+        cached_filter_node const * _node{};
+        std::span<alphabet_t const> _label{};
+
+    public:
+
+        cached_node_cargo() = default;
+        cached_node_cargo(cached_filter_node const & node, std::span<alphabet_t const> label) noexcept :
+            _node{std::addressof(node)},
+            _label{label}
+        {}
+
+        std::span<alphabet_t const> sequence() const noexcept
+        {
+            return _label;
+        }
+
+        libjst::seek_position const & position() const noexcept
+        {
+            return _node->position;
+        }
+
+        //!\brief The size of the path sequence ending with the label, which is cached in place of the path sequence.
+        uint64_t path_size() const noexcept
+        {
+            return _node->path_size;
+        }
+    };
+
+    /*!\brief The cached filter tree nodes of one chunk.
+     *
+     * \details
+     *
+     * A label that is a contiguous slice of the source is stored as its position in the source. All other labels,
+     * i.e. the labels spelling an alternate sequence, are copied into the chunk.
+     */
+    struct cached_chunk
+    {
+        std::vector<cached_filter_node> nodes{}; //!< The nodes in traversal order.
+        reference_t labels{}; //!< The labels of the nodes that are no slice of the source.
+
+        //!\brief Returns the cargo of the node with its label taken from the source or the stored labels.
+        cached_node_cargo cargo(cached_filter_node const & node, reference_t const & source) const noexcept
+        {
+            reference_t const & sequence = node.is_source_label ? source : labels;
+            return cached_node_cargo{node, std::span<alphabet_t const>{sequence}.subspan(node.label_begin,
+                                                                                         node.label_size)};
+        }
+
+        bool operator==(cached_chunk const &) const = default;
+    };
+
+    /*!\brief Stores the filter tree nodes of every chunk for a fixed window size.
+     *
+     * \details
+     *
+     * The colours and the pruning of the filter tree only depend on the stored haplotypes and the window size.
+     * Hence, the nodes that can contain a window covered by at least one haplotype are identical for every search
+     * using the same jst, bin size and window size. The cache records the seek position, the label and the path size
+     * of these nodes per chunk, such that the search replays them without building the tree or recomputing the colours
+     * of any node.
+     */
+    class topology_cache
+    {
+    private:
+        uint64_t _bin_size{};
+        uint64_t _window_size{};
+        jst_fingerprint _jst{};
+        std::vector<cached_chunk> _chunks{};
+
+    public:
+
+        topology_cache() = default;
+        topology_cache(uint64_t const bin_size, uint64_t const window_size, jst_fingerprint const jst) noexcept :
+            _bin_size{bin_size},
+            _window_size{window_size},
+            _jst{jst}
+        {}
+
+        uint64_t bin_size() const noexcept
+        {
+            return _bin_size;
+        }
+
+        uint64_t window_size() const noexcept
+        {
+            return _window_size;
+        }
+
+        //!\brief The fingerprint of the jst the cache was built for.
+        jst_fingerprint const & jst() const noexcept
+        {
+            return _jst;
+        }
+
+        size_t chunk_count() const noexcept
+        {
+            return _chunks.size();
+        }
+
+        //!\brief Returns the cached nodes of the chunk.
+        cached_chunk const & chunk(size_t const chunk_idx) const noexcept
+        {
+            return _chunks[chunk_idx];
+        }
+
+        //!\brief Sets the cached nodes of the chunk.
+        void set_chunk(size_t const chunk_idx, cached_chunk chunk)
+        {
+            if (_chunks.size() <= chunk_idx)
+                _chunks.resize(chunk_idx + 1);
+            _chunks[chunk_idx] = std::move(chunk);
+        }
+
+        /*!\brief Whether the cache was built for the given jst and bin size.
+         *
+         * \details
+         *
+         * The window size is not checked here. It depends on the needles of a bucket, such that every bucket compares
+         * it with jstmap::topology_cache::window_size before it replays the cached nodes.
+         */
+        bool is_compatible(jst_fingerprint const & jst, uint64_t const bin_size) const noexcept
+        {
+            return _bin_size == bin_size && _jst == jst;
+        }
+
+        void save(std::filesystem::path const & cache_path) const;
+        static topology_cache load(std::filesystem::path const & cache_path);
+    };
+
+    /*!\brief Collects all filter tree nodes of a chunk whose labels can contain a window.
+     *
+     * \param[in] chunk The chunk of the rcs store.
+     * \param[in] source The source sequence of the rcs store.
+     * \param[in] window_size The window size of the filter tree.
+     */
+    template <typename chunk_t>
+    cached_chunk collect_filter_nodes(chunk_t && chunk, reference_t const & source, size_t const window_size)
+    {
+        auto filter_tree = make_filter_tree(std::forward<chunk_t>(chunk), window_size);
+
+        // Returns the position of the label in the source if the label is a slice of it.
+        auto find_in_source = [&] <typename label_t> (label_t && label) -> std::optional<uint64_t> {
+            if constexpr (std::ranges::contiguous_range<label_t> &&
+                          std::same_as<std::ranges::range_value_t<label_t>, alphabet_t>) {
+                alphabet_t const * label_data = std::ranges::data(label);
+                alphabet_t const * source_data = source.data();
+                if (std::less_equal<>{}(source_data, label_data) &&
+                    std::less_equal<>{}(label_data + std::ranges::size(label), source_data + source.size()))
+                    return static_cast<uint64_t>(label_data - source_data);
+            }
+            return std::nullopt;
+        };
+
+        cached_chunk cached{};
+        libjst::tree_traverser_base traverser{filter_tree};
+        for (auto it = traverser.begin(); it != traverser.end(); ++it) {
+            auto cargo = *it;
+            auto && label = cargo.sequence();
+            if (std::ranges::size(label) < window_size)
+                continue;
+
+            cached_filter_node node{.position = cargo.position(),
+                                    .label_size = static_cast<uint64_t>(std::ranges::size(label)),
+                                    .path_size = static_cast<uint64_t>(std::ranges::size(cargo.path_sequence()))};
+            if (std::optional<uint64_t> source_position = find_in_source(label); source_position.has_value()) {
+                node.label_begin = *source_position;
+                node.is_source_label = true;
+            } else {
+                node.label_begin = cached.labels.size();
+                std::ranges::copy(label, std::back_inserter(cached.labels));
+            }
+            cached.nodes.push_back(std::move(node));
+        }
+        return cached;
+    }
+}  // namespace jstmap
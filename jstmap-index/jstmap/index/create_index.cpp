@@ -10,6 +10,9 @@
  * \author Rene Rahn <rene.rahn AT fu-berlin.de>
  */
 
+#include <stdexcept>
+#include <string>
+
 #include <seqan3/search/views/kmer_hash.hpp>
 
 #include <libjst/sequence_tree/chunked_tree.hpp>
@@ -26,6 +29,33 @@
 
 namespace jstmap
 {
+namespace
+{
+template <typename bin_tree_t>
+void fill_bin(seqan3::interleaved_bloom_filter<> & ibf,
+              bin_tree_t && bin_tree,
+              size_t const bin_id,
+              uint8_t const kmer_size)
+{
+    size_t window_size = kmer_size - 1;
+    // make more efficient by providing a hasher.
+    auto kmer_tree = std::forward<bin_tree_t>(bin_tree) | libjst::labelled()
+                                                        | libjst::coloured()
+                                                        | libjst::trim(window_size)
+                                                        | libjst::prune_unsupported()
+                                                        | libjst::left_extend(window_size)
+                                                        | libjst::merge();
+
+    libjst::tree_traverser_base kmer_path{kmer_tree};
+    for (auto it = kmer_path.begin(); it != kmer_path.end(); ++it) {
+        auto label = *it;
+        auto hash_seq = label.sequence() | seqan3::views::kmer_hash(seqan3::ungapped{kmer_size});
+        for (uint64_t hash_value : hash_seq)
+            ibf.emplace(hash_value, seqan3::bin_index{bin_id});
+    }
+}
+} // namespace
+
 // TODO: put functionality into class, so that we can configure it.
 seqan3::interleaved_bloom_filter<> create_index(rcs_store_t const & rcs_store, index_options const & options)
 {
@@ -40,26 +70,28 @@ seqan3::interleaved_bloom_filter<> create_index(rcs_store_t const & rcs_store, i
                                            seqan3::bin_size{computed_bin_size},
                                            seqan3::hash_function_count{3}};
 
-    size_t window_size = options.kmer_size - 1;
-    for (size_t bin_id = 0; bin_id < bin_count; ++bin_id) {
-        // make more efficient by providing a hasher.
-        auto kmer_tree = forest[bin_id] | libjst::labelled()
-                                        | libjst::coloured()
-                                        | libjst::trim(window_size)
-                                        | libjst::prune_unsupported()
-                                        | libjst::left_extend(window_size)
-                                        | libjst::merge();
-
-        libjst::tree_traverser_base kmer_path{kmer_tree};
-        for (auto it = kmer_path.begin(); it != kmer_path.end(); ++it) {
-            auto label = *it;
-            auto hash_seq = label.sequence() | seqan3::views::kmer_hash(seqan3::ungapped{options.kmer_size});
-            for (uint64_t hash_value : hash_seq)
-                ibf.emplace(hash_value, seqan3::bin_index{bin_id});
-        }
-    }
+    for (size_t bin_id = 0; bin_id < bin_count; ++bin_id)
+        fill_bin(ibf, forest[bin_id], bin_id, options.kmer_size);
 
     return ibf;
 }
 
+void update_index(seqan3::interleaved_bloom_filter<> & ibf,
+                  rcs_store_t const & rcs_store,
+                  std::vector<size_t> const & bin_ids,
+                  index_options const & options)
+{
+    using namespace std::literals;
+
+    auto forest = rcs_store | libjst::chunk(options.bin_size, options.bin_overlap);
+    if (std::ranges::size(forest) != ibf.bin_count())
+        throw std::runtime_error{"The index has "s + std::to_string(ibf.bin_count()) + " bins but the jst is "s +
+                                 "partitioned into "s + std::to_string(std::ranges::size(forest)) + " bins!"s};
+
+    for (size_t bin_id : bin_ids) {
+        ibf.clear(seqan3::bin_index{bin_id});
+        fill_bin(ibf, forest[bin_id], bin_id, options.kmer_size);
+    }
+}
+
 } // namespace jstmap
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <seqan3/search/dream_index/interleaved_bloom_filter.hpp>
 
 #include <jstmap/global/jstmap_types.hpp>
@@ -22,4 +24,10 @@ namespace jstmap
 
 seqan3::interleaved_bloom_filter<> create_index(rcs_store_t const &, index_options const &);
 
+// Clears the given bins and refills them from the respective chunks of the jst.
+void update_index(seqan3::interleaved_bloom_filter<> &,
+                  rcs_store_t const &,
+                  std::vector<size_t> const &,
+                  index_options const &);
+
 } // namespace jstmap
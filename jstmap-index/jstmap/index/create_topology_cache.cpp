@@ -0,0 +1,46 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <ranges>
+
+#include <libjst/sequence_tree/chunked_tree.hpp>
+
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/index/create_topology_cache.hpp>
+
+namespace jstmap
+{
+
+topology_cache create_topology_cache(rcs_store_t const & rcs_store, index_options const & options)
+{
+    // The search partitions the jst without overlap, such that the chunks are created the same way here.
+    auto forest = rcs_store | libjst::chunk(options.bin_size);
+    std::ptrdiff_t const chunk_count = std::ranges::ssize(forest);
+
+    // The cache is only replayed for the jst it was built from.
+    topology_cache cache{options.bin_size,
+                         options.window_size,
+                         jst_fingerprint::read(jst_container_reader{options.jst_input_file})};
+    std::vector<cached_chunk> chunk_nodes(chunk_count);
+
+    #pragma omp parallel for num_threads(options.thread_count) shared(forest, chunk_nodes) schedule(dynamic)
+    for (std::ptrdiff_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx)
+        chunk_nodes[chunk_idx] = collect_filter_nodes(forest[chunk_idx], rcs_store.source(), options.window_size);
+
+    size_t node_count{};
+    size_t label_size{};
+    for (std::ptrdiff_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+        node_count += chunk_nodes[chunk_idx].nodes.size();
+        label_size += chunk_nodes[chunk_idx].labels.size();
+        cache.set_chunk(chunk_idx, std::move(chunk_nodes[chunk_idx]));
+    }
+    log_debug("Cached filter tree nodes: ", node_count);
+    log_debug("Cached label symbols: ", label_size);
+    return cache;
+}
+
+} // namespace jstmap
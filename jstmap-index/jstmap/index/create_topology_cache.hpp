@@ -0,0 +1,25 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief The method to precompute the filter tree topology of every chunk.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/topology_cache.hpp>
+#include <jstmap/index/options.hpp>
+
+namespace jstmap
+{
+
+// Collects the filter tree nodes of every chunk of the jst as they are searched with the configured window size.
+topology_cache create_topology_cache(rcs_store_t const &, index_options const &);
+
+} // namespace jstmap
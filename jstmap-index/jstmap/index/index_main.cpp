@@ -10,13 +10,17 @@
  * \author Rene Rahn <rene.rahn AT fu-berlin.de>
  */
 
+#include <thread>
+
 #include <seqan3/argument_parser/argument_parser.hpp>
 #include <seqan3/argument_parser/exceptions.hpp>
 #include <seqan3/argument_parser/validators.hpp>
 
 #include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/coordinate_index.hpp>
 #include <jstmap/global/load_jst.hpp>
 #include <jstmap/index/create_index.hpp>
+#include <jstmap/index/create_topology_cache.hpp>
 #include <jstmap/index/index_main.hpp>
 #include <jstmap/index/options.hpp>
 #include <jstmap/index/save_index.hpp>
@@ -60,6 +64,32 @@ int index_main(seqan3::argument_parser & index_parser)
                             "The kmer-size used for the ibf creation.",
                             seqan3::option_spec::standard,
                             seqan3::arithmetic_range_validator{0u, 31u});
+    index_parser.add_option(options.topology_cache_file,
+                            '\0',
+                            "topology-cache",
+                            "The output file of the precomputed filter tree topology. Requires --window-size.",
+                            seqan3::option_spec::standard,
+                            seqan3::output_file_validator{seqan3::output_file_open_options::create_new, {"topo"}});
+    index_parser.add_option(options.window_size,
+                            'w',
+                            "window-size",
+                            "The window size of the searches using the topology cache. This is the seed size of the "
+                            "pigeonhole filter, i.e. the read length divided by the number of allowed errors plus one.",
+                            seqan3::option_spec::standard,
+                            seqan3::arithmetic_range_validator{1u, 10000u});
+    index_parser.add_option(options.thread_count,
+                            't',
+                            "thread-count",
+                            "The number of threads used to create the topology cache.",
+                            seqan3::option_spec::standard,
+                            seqan3::arithmetic_range_validator{1u, std::thread::hardware_concurrency()});
+    index_parser.add_option(options.coordinate_index_file,
+                            '\0',
+                            "coordinate-index",
+                            "The output file of the index projecting the source positions onto the haplotypes, "
+                            "which is used by the linear subcommand.",
+                            seqan3::option_spec::standard,
+                            seqan3::output_file_validator{seqan3::output_file_open_options::create_new, {"cidx"}});
 
     try
     {
@@ -67,6 +97,9 @@ int index_main(seqan3::argument_parser & index_parser)
         if (options.bin_overlap >= options.bin_size)
             throw std::invalid_argument{"The bin overlap of " + std::to_string(options.bin_overlap) + " must be "
                                         "smaller than the bin size of " + std::to_string(options.bin_size) + "!"};
+        if (index_parser.is_option_set("topology-cache") != index_parser.is_option_set("window-size"))
+            throw seqan3::argument_parser_error{"The options --topology-cache and --window-size must be given "
+                                                "together!"};
     }
     catch (seqan3::argument_parser_error const & ex)
     {
@@ -106,6 +139,24 @@ int index_main(seqan3::argument_parser & index_parser)
 
         log(verbosity_level::standard, logging_level::info, "Saving index: ", options.output_file);
         save_index(ibf, options);
+
+        if (!options.topology_cache_file.empty()) {
+            log(verbosity_level::standard, logging_level::info, "Creating the topology cache with window size ",
+                                                                options.window_size);
+            topology_cache cache = create_topology_cache(jst, options);
+
+            log(verbosity_level::standard, logging_level::info, "Saving topology cache: ", options.topology_cache_file);
+            cache.save(options.topology_cache_file);
+        }
+
+        if (!options.coordinate_index_file.empty()) {
+            log(verbosity_level::standard, logging_level::info, "Creating the coordinate index");
+            coordinate_index coordinates{jst};
+
+            log(verbosity_level::standard, logging_level::info, "Saving coordinate index: ",
+                                                                options.coordinate_index_file);
+            coordinates.save(options.coordinate_index_file);
+        }
     }
     catch (std::exception const & ex)
     {
@@ -0,0 +1,43 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief The method to load the index.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <cereal/archives/binary.hpp>
+
+#include <jstmap/index/load_index.hpp>
+
+namespace jstmap
+{
+
+std::tuple<size_t, uint8_t, seqan3::interleaved_bloom_filter<>> load_index(std::filesystem::path const & index_path)
+{
+    using namespace std::literals;
+
+    std::ifstream instr{index_path};
+    if (!instr.good())
+        throw std::runtime_error{"Couldn't open path for loading the index! The path is ["s + index_path.string() + "]"s};
+
+    cereal::BinaryInputArchive inarch{instr};
+    size_t bin_size{};
+    uint8_t kmer_size{};
+    inarch(bin_size);
+    inarch(kmer_size);
+    seqan3::interleaved_bloom_filter<> ibf{};
+    ibf.serialize(inarch);
+
+    return std::tuple{bin_size, kmer_size, std::move(ibf)};
+}
+
+} // namespace jstmap
@@ -26,6 +26,10 @@ struct index_options
     size_t bin_size = 10'000; //!< The size of a bin for the index construction.
     size_t bin_overlap = 500; //!< The size of the bin overlap for the ibf construction.
     uint8_t kmer_size = 25; //!< The kmer-size to use for the ibf creation.
+    std::filesystem::path topology_cache_file{}; //!< The file path to write the filter tree topology cache to.
+    size_t window_size{0}; //!< The window size of the searches the topology cache is created for.
+    size_t thread_count{1}; //!< The number of threads used to create the topology cache.
+    std::filesystem::path coordinate_index_file{}; //!< The file path to write the haplotype coordinate index to.
 };
 
 }  // namespace jstmap
@@ -10,15 +10,23 @@
  * \author Rene Rahn <rene.rahn AT fu-berlin.de>
  */
 
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
 #include <seqan3/argument_parser/argument_parser.hpp>
 #include <seqan3/argument_parser/exceptions.hpp>
 #include <seqan3/argument_parser/validators.hpp>
 
 #include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/coordinate_index.hpp>
 #include <jstmap/global/load_jst.hpp>
-#include <jstmap/global/bam_writer.hpp>
-#include <jstmap/linear/options.hpp>
 #include <jstmap/global/tool_parser.hpp>
+#include <jstmap/linear/options.hpp>
+#include <jstmap/linear/sam_lineariser.hpp>
 
 namespace jstmap
 {
@@ -45,34 +53,102 @@ int linear_main(seqan3::argument_parser & linear_parser)
                              'o',
                              "output",
                              "The file containing the linearised mapping information. "
-                             "If not specified, the sam file is written to the standard output.",
+                             "If not specified, the records are written next to the sam file into "
+                             "<sam file stem>.haplotype_<haplotype>.sam.",
                              seqan3::option_spec::standard,
                              seqan3::output_file_validator{seqan3::output_file_open_options::open_or_create,
                                                            {"sam", "bam"}});
 
+    linear_parser.add_option(options.thread_count,
+                             't',
+                             "thread-count",
+                             "The number of threads to linearise the records with.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{1u, std::thread::hardware_concurrency()});
+    linear_parser.add_option(options.coordinate_index_file,
+                             '\0',
+                             "coordinate-index",
+                             "The coordinate index created by the index subcommand for the rcsdb. "
+                             "If not specified, the index is created from the rcsdb.",
+                             seqan3::option_spec::standard,
+                             seqan3::input_file_validator{{"cidx"}});
+    linear_parser.add_flag(options.sort_output,
+                           '\0',
+                           "sort",
+                           "Writes the records sorted by their haplotype position instead of the input order.",
+                           seqan3::option_spec::standard);
+    linear_parser.add_option(options.max_memory,
+                             '\0',
+                             "max-memory",
+                             "The memory in MiB of the records buffered for the sorted output. Larger outputs are "
+                             "sorted in runs on the disk, which are merged at the end.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{1u, 1048576u});
+
     try
     {
         linear_parser.parse();
         initialise_logging_level(options);
-        log_info("Starting linearisation of sam file");
-        // auto configure_rcsdb =
-        //     just load rcsdb
-        //     then construct rcsdb absolute position converter
-        //     then construct rcsdb coverage checker
-        // auto exec_pipeline =
-        //     when_all(configure_rcsdb, just load sam file)
-        //     then //IN: wrapped rcsdb + coverage checker
-        //         auto chunked_sam_records = sam_file | views::chunk(cs)
-        //         make_stream(chunked_sam_records)
-        //         on_stream(get_scheduler(exec)) // fork each of the following calls are executed on tp context
-        //         transform_stream chunked_sam_records | disable_uncovered(ht_idx) // check if alignment is covered by the haplotype: in variant subtree must have coverage, in reference must have coverage.
-        //         transform_stream covered_chunked_sam_records | transform(convert_to_absolute_position(ht_idx))  // conversion into absolute position of given ht_idx for aligned reads
-        //         for_each_stream write to synchronised bam file
-        // run(exec_pipeline);
+        log_debug("Rcsdb file:", options.rcsdb_file.string());
+        log_debug("Sam file:", options.sam_file.string());
+        log_debug("Output file:", options.output_file.string());
+        log_debug("Haplotype:", options.haplotype_index);
+        log_debug("Thread count:", options.thread_count);
+        log_debug("Coordinate index file:", options.coordinate_index_file.string());
+        log_debug("Sort output:", options.sort_output);
+        log_debug("Max memory:", options.max_memory, "MiB");
     } catch (seqan3::argument_parser_error const & ex) {
         log_err("Program terminates because of ", ex.what());
         return EXIT_FAILURE;
     }
+
+    try
+    {
+        using namespace std::literals;
+
+        log_info("Starting linearisation of sam file");
+        auto start = std::chrono::high_resolution_clock::now();
+        rcs_store_t rcs_store = load_jst(options.rcsdb_file);
+        if (options.haplotype_index >= rcs_store.size())
+            throw std::runtime_error{"The haplotype "s + std::to_string(options.haplotype_index) +
+                                     " exceeds the haplotype count "s + std::to_string(rcs_store.size())};
+
+        coordinate_index coordinates{};
+        if (options.coordinate_index_file.empty()) {
+            log_debug("Create coordinate index");
+            coordinates = coordinate_index{rcs_store};
+        } else {
+            log_debug("Load coordinate index");
+            coordinates = coordinate_index::load(options.coordinate_index_file);
+            if (!coordinates.is_compatible(rcs_store))
+                throw std::runtime_error{"The coordinate index ["s + options.coordinate_index_file.string() +
+                                         "] was not created for the rcsdb ["s + options.rcsdb_file.string() + "]"s};
+        }
+
+        sam_lineariser lineariser{rcs_store, coordinates, static_cast<uint32_t>(options.haplotype_index)};
+        std::filesystem::path output_file = options.output_file;
+        if (output_file.empty()) {
+            output_file = options.sam_file;
+            output_file.replace_filename(options.sam_file.stem().string() + ".haplotype_"s +
+                                         std::to_string(options.haplotype_index) + ".sam"s);
+        }
+
+        std::optional<sort_configuration> sorting{};
+        if (options.sort_output)
+            sorting = sort_configuration{.max_memory = options.max_memory << 20, .thread_count = options.thread_count};
+
+        linearisation_statistics statistics = lineariser(options.sam_file, output_file, options.thread_count, sorting);
+        auto end = std::chrono::high_resolution_clock::now();
+        log_debug("Linearisation time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
+        log_info("Linearised records:", statistics.linearised_count, " of ", statistics.record_count);
+        log_debug("Records not covered by the haplotype:", statistics.uncovered_count);
+        log_debug("Records whose mate is not covered by the haplotype:", statistics.unpaired_count);
+        if (statistics.invalid_count > 0)
+            log_warn("Skipped records without a tree position:", statistics.invalid_count);
+    } catch (std::exception const & ex) {
+        log_err("Program terminates because of ", ex.what());
+        return EXIT_FAILURE;
+    }
     log_info("Successfully finished linearisation");
     return EXIT_SUCCESS;
 }
@@ -25,6 +25,10 @@ struct linear_options : public options_base
     std::filesystem::path sam_file{}; //!< The path to the sam file containing the mapping information.
     std::filesystem::path output_file{}; //!< The path to the linearised output sam file.
     size_t haplotype_index{0}; //!< The haplotype index to linearise.
+    size_t thread_count{1}; //!< The number of threads to linearise the records with.
+    std::filesystem::path coordinate_index_file{}; //!< The path to the precomputed haplotype coordinate index.
+    size_t max_memory{1024}; //!< The memory in MiB of the buffered records of a sorted output.
+    bool sort_output{false}; //!< Whether the output is sorted by position.
 };
 
 }  // namespace jstmap
@@ -0,0 +1,238 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the linearisation of the sam records mapped against the jst.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <omp.h>
+
+#include <seqan3/io/sam_file/input.hpp>
+#include <seqan3/io/sam_file/output.hpp>
+
+#include <libjst/sequence_tree/path_descriptor.hpp>
+#include <libjst/utility/multi_invocable.hpp>
+
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/sam_tags.hpp>
+#include <jstmap/global/sorted_sam_writer.hpp>
+#include <jstmap/linear/sam_lineariser.hpp>
+
+namespace jstmap
+{
+
+sam_lineariser::sam_lineariser(rcs_store_t const & rcs_store,
+                               coordinate_index const & coordinates,
+                               uint32_t const haplotype) :
+    _coordinates{coordinates},
+    _haplotype{haplotype},
+    _reference_trees{rcs_store}
+{}
+
+linearisation_statistics sam_lineariser::operator()(std::filesystem::path const & sam_file,
+                                                    std::filesystem::path const & output_file,
+                                                    size_t const thread_count,
+                                                    std::optional<sort_configuration> const sorting,
+                                                    size_t const block_size) const
+{
+    using namespace std::literals;
+    using namespace seqan3::literals;
+
+    using field_ids_type = seqan3::fields<seqan3::field::id,
+                                          seqan3::field::flag,
+                                          seqan3::field::ref_id,
+                                          seqan3::field::ref_offset,
+                                          seqan3::field::mapq,
+                                          seqan3::field::cigar,
+                                          seqan3::field::mate,
+                                          seqan3::field::seq,
+                                          seqan3::field::tags>;
+    using valid_format_type = seqan3::type_list<seqan3::format_bam, seqan3::format_sam>;
+    using input_file_type = seqan3::sam_file_input<seqan3::sam_file_input_default_traits<>,
+                                                   field_ids_type,
+                                                   valid_format_type>;
+    using record_type = std::ranges::range_value_t<input_file_type>;
+    using output_file_type = seqan3::sam_file_output<field_ids_type, valid_format_type, std::vector<std::string>>;
+
+    input_file_type input{sam_file};
+    std::vector<std::string> reference_names{"haplotype_"s + std::to_string(_haplotype)};
+    std::vector<size_t> reference_lengths{_coordinates.haplotype_size(_haplotype)};
+    std::optional<output_file_type> output{};
+    std::unique_ptr<sorted_sam_writer> sorted_output{};
+    if (sorting.has_value()) {
+        sort_configuration configuration = *sorting;
+        configuration.has_coordinates = true; // The linearised positions are coordinates of the haplotype.
+        sorted_output = std::make_unique<sorted_sam_writer>(output_file,
+                                                            std::move(reference_names),
+                                                            std::move(reference_lengths),
+                                                            configuration);
+    } else {
+        output.emplace(output_file, std::move(reference_names), std::move(reference_lengths));
+    }
+
+    linearisation_statistics statistics{};
+    std::vector<record_type> block{};
+    std::vector<std::optional<int64_t>> block_positions{};
+    std::vector<std::optional<int64_t>> block_mate_positions{};
+    block.reserve(block_size);
+
+    // The mate is sought in the tree of the size of the mate sequence, which is stored in the `ms` tag.
+    auto mate_linear_position = [&] (record_type const & record) -> std::optional<int64_t> {
+        auto size_it = record.tags().find("ms"_tag);
+        if (!has_tree_position(record.tags(), mate_position_tags) || size_it == record.tags().end() ||
+            !record.mate_position().has_value())
+            return std::nullopt;
+
+        return linear_position(*record.mate_position(),
+                               record.tags(),
+                               static_cast<size_t>(std::get<int32_t>(size_it->second)),
+                               mate_position_tags);
+    };
+
+    auto linearise_block = [&] () {
+        block_positions.assign(block.size(), std::nullopt);
+        block_mate_positions.assign(block.size(), std::nullopt);
+        std::vector<char> is_invalid(block.size(), false);
+
+        #pragma omp parallel for num_threads(thread_count) schedule(dynamic, 64)
+        for (size_t idx = 0; idx < block.size(); ++idx) {
+            record_type const & record = block[idx];
+            seqan3::sam_flag const flag = record.flag();
+            if (static_cast<bool>(flag & seqan3::sam_flag::paired))
+                block_mate_positions[idx] = mate_linear_position(record);
+
+            if (static_cast<bool>(flag & seqan3::sam_flag::unmapped)) { // Placed at the position of its mate.
+                is_invalid[idx] = !has_tree_position(record.tags(), mate_position_tags);
+                block_positions[idx] = block_mate_positions[idx];
+                continue;
+            }
+
+            if (!has_tree_position(record.tags()) || !record.reference_position().has_value()) {
+                is_invalid[idx] = true;
+                continue;
+            }
+            block_positions[idx] = linear_position(*record.reference_position(),
+                                                   record.tags(),
+                                                   std::ranges::size(record.sequence()));
+        }
+
+        // Write the block in the order of the input.
+        for (size_t idx = 0; idx < block.size(); ++idx) {
+            if (is_invalid[idx]) {
+                ++statistics.invalid_count;
+                continue;
+            }
+            if (!block_positions[idx].has_value()) {
+                ++statistics.uncovered_count;
+                continue;
+            }
+
+            record_type & record = block[idx];
+            seqan3::sam_flag flag = record.flag();
+            int32_t const position = static_cast<int32_t>(*block_positions[idx]);
+            std::optional<int32_t> mate_reference_id{};
+            std::optional<int32_t> mate_position{};
+            int32_t template_length{};
+            if (static_cast<bool>(flag & seqan3::sam_flag::paired)) {
+                if (static_cast<bool>(flag & seqan3::sam_flag::mate_unmapped)) { // The mate is placed at the record.
+                    mate_reference_id = 0;
+                    mate_position = position;
+                } else if (block_mate_positions[idx].has_value()) {
+                    mate_reference_id = 0;
+                    mate_position = static_cast<int32_t>(*block_mate_positions[idx]);
+                    template_length = record.template_length();
+                } else {
+                    flag &= ~(seqan3::sam_flag::paired |
+                              seqan3::sam_flag::proper_pair |
+                              seqan3::sam_flag::mate_unmapped |
+                              seqan3::sam_flag::mate_on_reverse_strand |
+                              seqan3::sam_flag::first_in_pair |
+                              seqan3::sam_flag::second_in_pair);
+                    ++statistics.unpaired_count;
+                }
+            }
+
+            seqan3::sam_tag_dictionary tags = std::move(record.tags());
+            erase_match_position(tags);
+            erase_match_position(tags, mate_position_tags);
+            tags.erase("ms"_tag);
+            if (sorted_output) {
+                sorted_output->push(sorted_sam_writer::record_type{.id = std::move(record.id()),
+                                                                   .flag = flag,
+                                                                   .reference_position = position,
+                                                                   .mapping_quality = record.mapping_quality(),
+                                                                   .cigar_sequence = std::move(record.cigar_sequence()),
+                                                                   .mate_reference_id = mate_reference_id,
+                                                                   .mate_position = mate_position,
+                                                                   .template_length = template_length,
+                                                                   .sequence = std::move(record.sequence()),
+                                                                   .tags = std::move(tags)});
+            } else {
+                output->emplace_back(std::move(record.id()),
+                                     flag,
+                                     output->header().ref_ids()[0],
+                                     position,
+                                     record.mapping_quality(),
+                                     std::move(record.cigar_sequence()),
+                                     std::tuple{mate_reference_id, mate_position, template_length},
+                                     std::move(record.sequence()),
+                                     std::move(tags));
+            }
+            ++statistics.linearised_count;
+        }
+        block.clear();
+    };
+
+    for (auto && record : input) {
+        ++statistics.record_count;
+        block.push_back(std::move(record));
+        if (block.size() == block_size)
+            linearise_block();
+    }
+    linearise_block();
+
+    if (sorted_output)
+        sorted_output->finish();
+    return statistics;
+}
+
+std::optional<int64_t> sam_lineariser::linear_position(size_t const variant_index,
+                                                       seqan3::sam_tag_dictionary const & tags,
+                                                       size_t const record_size,
+                                                       tree_position_tags const & position_tags) const
+{
+    if (record_size == 0)
+        return std::nullopt;
+
+    match_position const position = decode_match_position(variant_index, tags, position_tags);
+    auto node = _reference_trees.get(record_size - 1).seek(position.tree_position);
+    auto cargo = *node;
+    if (!cargo.coverage().contains(_haplotype))
+        return std::nullopt;
+
+    bool is_alternate{};
+    position.tree_position.visit(libjst::multi_invocable{
+        [&] (libjst::alternate_path_descriptor const &) { is_alternate = true; },
+        [&] (libjst::breakpoint_end) { is_alternate = false; }
+    });
+
+    // The label of an alternate node without source span consists of the inserted sequence ending at its boundary.
+    uint64_t const path_end = libjst::position(node.high_boundary());
+    bool const ends_behind_insertion = is_alternate && libjst::position(node.low_boundary()) == path_end;
+
+    int64_t const distance_to_path_end = std::ranges::ssize(cargo.path_sequence()) - position.label_offset;
+    int64_t const linear_path_end = _coordinates.haplotype_position(_haplotype, path_end, ends_behind_insertion);
+    return std::max<int64_t>(0, linear_path_end - distance_to_path_end);
+}
+
+}  // namespace jstmap
@@ -0,0 +1,102 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the linearisation of the sam records mapped against the jst.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+#include <seqan3/io/sam_file/sam_tag_dictionary.hpp>
+
+#include <jstmap/global/coordinate_index.hpp>
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/reference_tree_cache.hpp>
+#include <jstmap/global/sam_tags.hpp>
+#include <jstmap/global/sorted_sam_writer.hpp>
+
+namespace jstmap
+{
+
+//!\brief The statistics of a linearisation.
+struct linearisation_statistics
+{
+    size_t record_count{}; //!< The number of read records.
+    size_t linearised_count{}; //!< The number of records written for the haplotype.
+    size_t uncovered_count{}; //!< The number of records whose path is not covered by the haplotype.
+    size_t invalid_count{}; //!< The number of records without a tree position.
+    size_t unpaired_count{}; //!< The number of linearised records whose mate is not covered by the haplotype.
+};
+
+/*!\brief Projects the sam records written by the jstmap::bam_writer onto the coordinates of a haplotype.
+ *
+ * \details
+ *
+ * The tree position of every record is decoded from its `ad`, `rd` and `lo` tags and sought in the sequence tree
+ * of the record size. A record is linearised, if the haplotype covers the path to the sought node. Then, the path
+ * ends at the high boundary of the node and the record begins `d` positions before the path end, where `d` is the
+ * size of the path sequence minus the label offset. The path end is converted into the coordinates of the haplotype with
+ * the jstmap::coordinate_index.
+ *
+ * The mate of a paired record is projected the same way from PNEXT, the jstmap::mate_position_tags and the size of
+ * the mate sequence stored in the `ms` tag. If the mate is not covered by the haplotype, the record is written
+ * without the mate fields and mate flags. An unmapped record is placed at the projected position of its mate.
+ *
+ * The records are read in blocks, which are linearised in parallel and written in the order of the input, unless
+ * the output is sorted by position.
+ * The tags of the tree positions are removed from the written records.
+ */
+class sam_lineariser
+{
+private:
+    coordinate_index const & _coordinates;
+    uint32_t _haplotype{};
+    reference_tree_cache _reference_trees;
+
+public:
+
+    //!\brief The default number of records linearised together.
+    static constexpr size_t default_block_size = 4096;
+
+    sam_lineariser(rcs_store_t const & rcs_store, coordinate_index const & coordinates, uint32_t haplotype);
+
+    /*!\brief Linearises all records of the sam file.
+     *
+     * \param[in] sam_file The sam or bam file written by the search.
+     * \param[in] output_file The file to write the linearised records to.
+     * \param[in] thread_count The number of threads to linearise a block with.
+     * \param[in] sorting The configuration of the output sorted by position; if not set, the input order is kept.
+     * \param[in] block_size The number of records read and linearised together.
+     */
+    linearisation_statistics operator()(std::filesystem::path const & sam_file,
+                                        std::filesystem::path const & output_file,
+                                        size_t thread_count = 1,
+                                        std::optional<sort_configuration> sorting = std::nullopt,
+                                        size_t block_size = default_block_size) const;
+
+    /*!\brief Returns the begin position of a record in the haplotype.
+     *
+     * \param[in] variant_index The variant index stored as the position of the record.
+     * \param[in] tags The tags of the record storing the tree position.
+     * \param[in] record_size The size of the record sequence.
+     * \param[in] position_tags The tags storing the tree position; the jstmap::mate_position_tags together with the
+     *                          variant index stored in PNEXT and the size of the mate project the mate.
+     *
+     * \returns The begin position or std::nullopt if the haplotype does not cover the path of the record.
+     */
+    std::optional<int64_t> linear_position(size_t variant_index,
+                                           seqan3::sam_tag_dictionary const & tags,
+                                           size_t record_size,
+                                           tree_position_tags const & position_tags = match_position_tags) const;
+};
+
+}  // namespace jstmap
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/topology_cache.hpp>
+
 namespace jstmap
 {
     template <typename base_tree_t, typename needle_list_t>
@@ -19,5 +22,9 @@ namespace jstmap
     {
         base_tree_t base_tree{};
         needle_list_t needle_list{};
+        //!\brief The precomputed filter tree nodes of the base tree; traverses the complete tree if `nullptr`.
+        cached_chunk const * cached_nodes{nullptr};
+        reference_t const * cached_source{nullptr}; //!< The source the labels of the cached nodes refer to.
+        size_t cached_window_size{}; //!< The window size the cached nodes were collected for.
     };
 }  // namespace jstmap
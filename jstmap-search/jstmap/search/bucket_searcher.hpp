@@ -12,8 +12,15 @@
 
 #pragma once
 
+#include <functional>
+
+#include <jstmap/global/filter_tree.hpp>
+#include <jstmap/global/match_position.hpp>
+#include <jstmap/search/exact_matcher.hpp>
+#include <jstmap/search/interleaved_task.hpp>
 #include <jstmap/search/pigeonhole_filter.hpp>
 #include <jstmap/search/seed_verifier.hpp>
+#include <jstmap/search/visit_filter_nodes.hpp>
 
 namespace jstmap
 {
@@ -38,20 +45,71 @@ namespace jstmap
 
         template <typename callback_t>
         constexpr void operator()(callback_t && callback) {
+            search(std::ref(callback), false).run();
+        }
+
+        /*!\brief Returns a task searching the bucket, which can be interleaved with the tasks of other buckets.
+         *
+         * \param[in] callback The callback invoked with the needle index, the match position and optionally the error
+         *                     count of every hit; stored in the task.
+         *
+         * \details
+         *
+         * The task suspends after it prefetched the label of its next node, such that the label is loaded while
+         * the other tasks are resumed with jstmap::run_interleaved. The searcher must outlive the returned task.
+         */
+        template <typename callback_t>
+        interleaved_task interleaved(callback_t callback) {
+            return search(std::move(callback), true);
+        }
+
+    private:
+
+        template <typename callback_t>
+        interleaved_task search(callback_t callback, bool const interleave) {
+            if (_error_rate == 0.0) // Without errors every needle is found directly, such that no seed needs to be verified.
+                return search_exact(std::move(callback), interleave);
+
             // instantiate pigeonhole filter.
             pigeonhole_filter filter{_bucket, _error_rate};
             // run pigeonhole filter on subtree
-            // std::cout << "Run filter\n" << std::flush;
-            filter([&] (auto && cargo, auto && finder, auto && needle_position) {
+            return filter.search([this, callback = std::move(callback)] (auto && cargo, auto && finder, auto && needle_position) mutable {
                 if (position_available(cargo, finder, needle_position)) return;
 
                 uint32_t seed_size = endPosition(finder) - beginPosition(finder);
                 seed_verifier verifier{_bucket, _error_rate, seed_size};
                 verifier(cargo, finder, needle_position, callback);
-            });
+            }, interleave);
         }
 
-    private:
+        template <typename callback_t>
+        interleaved_task search_exact(callback_t callback, bool const interleave) {
+            exact_matcher matcher{_bucket.needle_list};
+            size_t const window_size = matcher.window_size();
+            if (window_size == 0)
+                return interleaved_task{};
+
+            auto search_node = [this, matcher = std::move(matcher), callback = std::move(callback)] (auto cargo) mutable {
+                std::ptrdiff_t label_begin = path_size(cargo) - std::ranges::ssize(cargo.sequence());
+                matcher(cargo.sequence(), [&] (uint32_t needle_idx, std::ptrdiff_t begin_position) {
+                    // Occurrences within the left extension of a node were already reported for the previous node.
+                    std::ptrdiff_t global_begin_pos = label_begin + begin_position;
+                    if (_last_position[needle_idx] == global_begin_pos)
+                        return;
+
+                    _last_position[needle_idx] = global_begin_pos;
+                    detail::report_hit(callback, needle_idx, match_position{.tree_position = cargo.position(),
+                                                                            .label_offset = global_begin_pos}, 0);
+                });
+            };
+
+            bool const use_cache = _bucket.cached_nodes != nullptr && _bucket.cached_window_size == window_size;
+            return visit_filter_nodes(make_filter_tree(_bucket.base_tree, window_size),
+                                      use_cache ? _bucket.cached_nodes : nullptr,
+                                      _bucket.cached_source,
+                                      std::move(search_node),
+                                      interleave);
+        }
 
         template <typename cargo_t, typename finder_t, typename needle_hit_t>
         constexpr bool position_available(cargo_t const & cargo,
@@ -59,7 +117,7 @@ namespace jstmap
                                           needle_hit_t const & hit) noexcept
         {
             std::ptrdiff_t label_offset = std::ranges::ssize(cargo.sequence()) - beginPosition(finder);
-            std::ptrdiff_t global_begin_pos = std::ranges::ssize(cargo.path_sequence()) - label_offset - hit.offset;
+            std::ptrdiff_t global_begin_pos = path_size(cargo) - label_offset - hit.offset;
             assert(global_begin_pos >= 0);
 
             if (_last_position[hit.index] != global_begin_pos) {
@@ -0,0 +1,62 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+#include <unordered_map>
+
+#include <seqan3/alphabet/concept.hpp>
+
+#include <jstmap/search/collapse_queries.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+template <typename sequence_t>
+uint64_t hash_sequence(sequence_t const & sequence) noexcept
+{
+    // FNV-1a over the ranks of the symbols.
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto const & symbol : sequence) {
+        hash ^= seqan3::to_rank(symbol);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+} // namespace
+
+collapsed_queries collapse_queries(std::vector<search_query> queries)
+{
+    collapsed_queries collapsed{};
+    std::unordered_multimap<uint64_t, search_query::key_type> distinct_by_hash{};
+    distinct_by_hash.reserve(queries.size());
+
+    for (search_query & query : queries) {
+        auto const & sequence = query.value().sequence();
+        uint64_t const hash = hash_sequence(sequence);
+
+        auto [first, last] = distinct_by_hash.equal_range(hash);
+        auto it = std::ranges::find_if(first, last, [&] (auto const & entry) {
+            return std::ranges::equal(collapsed.queries[entry.second].value().sequence(), sequence);
+        });
+
+        if (it != last) {
+            collapsed.original_keys[it->second].push_back(query.key());
+        } else {
+            search_query::key_type distinct_key = collapsed.queries.size();
+            distinct_by_hash.emplace(hash, distinct_key);
+            collapsed.original_keys.push_back({query.key()});
+            collapsed.queries.emplace_back(distinct_key, std::move(query).value());
+        }
+    }
+    return collapsed;
+}
+
+} // namespace jstmap
@@ -0,0 +1,50 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the collapsing of queries with identical sequences.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <jstmap/global/search_query.hpp>
+
+namespace jstmap
+{
+
+//!\brief The distinct queries together with the keys of all original queries sharing their sequence.
+struct collapsed_queries
+{
+    using key_type = search_query::key_type;
+
+    //!\brief One query per distinct sequence, whose key is its index within this list.
+    std::vector<search_query> queries{};
+    //!\brief The keys of the original queries per distinct query.
+    std::vector<std::vector<key_type>> original_keys{};
+
+    //!\brief The number of original queries with the sequence of the given distinct query.
+    size_t multiplicity(key_type const key) const noexcept
+    {
+        return original_keys[key].size();
+    }
+};
+
+/*!\brief Collapses the queries with identical sequences.
+ *
+ * \param[in] queries The queries to collapse.
+ *
+ * \details
+ *
+ * The sequences are hashed and identical sequences are merged into the distinct query that saw the sequence first.
+ * The distinct queries keep the order of their first occurrence.
+ */
+collapsed_queries collapse_queries(std::vector<search_query> queries);
+
+} // namespace jstmap
@@ -0,0 +1,214 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a bit-parallel edit distance aligner computing unit cost CIGARs.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+#include <seqan3/alphabet/cigar/cigar.hpp>
+#include <seqan3/alphabet/concept.hpp>
+
+namespace jstmap
+{
+    //!\brief The unit cost alignment of a query within a reference segment.
+    struct edit_alignment
+    {
+        int32_t edit_distance{}; //!< The number of errors of the alignment.
+        std::ptrdiff_t begin_position{}; //!< The first aligned position of the segment.
+        std::ptrdiff_t end_position{}; //!< The position behind the last aligned position of the segment.
+        std::vector<seqan3::cigar> cigar_sequence{}; //!< The CIGAR of the aligned query.
+    };
+
+    /*!\brief Aligns a query to a reference segment with the minimal number of edits.
+     *
+     * \details
+     *
+     * The query is aligned globally, while the leading and trailing positions of the reference segment are free.
+     * The distances are computed with the bit-vector algorithm of Myers in blocks of 64 query positions, as described
+     * by Hyyrö, and the vertical difference vectors of every column are kept for the traceback.
+     * Every entry of the matrix is recovered from the column vectors by counting their bits, such that the traceback
+     * never needs the complete matrix. The reference segment is restricted to the band of the verified match, i.e. it
+     * covers the query plus the allowed errors on both sides, which keeps the number of stored columns small.
+     *
+     * The aligner keeps its buffers between the calls and is not thread-safe.
+     */
+    class edit_distance_aligner
+    {
+    private:
+        using word_t = uint64_t;
+
+        static constexpr size_t _word_size = 64;
+        static constexpr word_t _high_bit = word_t{1} << (_word_size - 1);
+
+        std::vector<word_t> _peq{}; //!< The match vectors per symbol rank and block.
+        std::vector<word_t> _pv{}; //!< The positive vertical deltas per column and block.
+        std::vector<word_t> _mv{}; //!< The negative vertical deltas per column and block.
+        size_t _block_count{};
+
+    public:
+
+        /*!\brief Computes the unit cost alignment of the query within the segment.
+         *
+         * \param[in] query The query to align completely.
+         * \param[in] segment The reference segment with free leading and trailing positions.
+         *
+         * \returns The jstmap::edit_alignment with a CIGAR of 'M', 'I' and 'D' operations.
+         */
+        template <std::ranges::random_access_range query_t, std::ranges::random_access_range segment_t>
+        edit_alignment operator()(query_t const & query, segment_t const & segment)
+        {
+            using symbol_t = std::ranges::range_value_t<query_t>;
+            static constexpr size_t sigma = seqan3::alphabet_size<symbol_t>;
+
+            size_t const query_size = std::ranges::size(query);
+            size_t const segment_size = std::ranges::size(segment);
+            if (query_size == 0)
+                return edit_alignment{};
+
+            _block_count = (query_size + _word_size - 1) / _word_size;
+
+            // Initialise the match vectors of the query.
+            _peq.assign(sigma * _block_count, word_t{});
+            for (size_t row = 0; row < query_size; ++row)
+                _peq[seqan3::to_rank(query[row]) * _block_count + row / _word_size] |= word_t{1} << (row % _word_size);
+
+            // Column 0 has the distance of the row to the empty segment prefix.
+            _pv.assign((segment_size + 1) * _block_count, ~word_t{});
+            _mv.assign((segment_size + 1) * _block_count, word_t{});
+
+            for (size_t column = 1; column <= segment_size; ++column) {
+                word_t const * eq = _peq.data() + seqan3::to_rank(segment[column - 1]) * _block_count;
+                word_t const * pv_in = _pv.data() + (column - 1) * _block_count;
+                word_t const * mv_in = _mv.data() + (column - 1) * _block_count;
+                word_t * pv_out = _pv.data() + column * _block_count;
+                word_t * mv_out = _mv.data() + column * _block_count;
+
+                int horizontal_delta = 0; // the first row is 0 in every column.
+                for (size_t block = 0; block < _block_count; ++block) {
+                    pv_out[block] = pv_in[block];
+                    mv_out[block] = mv_in[block];
+                    horizontal_delta = advance_block(pv_out[block], mv_out[block], eq[block], horizontal_delta);
+                }
+            }
+
+            // The alignment ends in the column with the smallest distance in the last row.
+            size_t end_column{};
+            int32_t edit_distance = distance(query_size, 0);
+            for (size_t column = 1; column <= segment_size; ++column) {
+                if (int32_t const column_distance = distance(query_size, column); column_distance < edit_distance) {
+                    edit_distance = column_distance;
+                    end_column = column;
+                }
+            }
+
+            edit_alignment alignment{.edit_distance = edit_distance,
+                                     .end_position = static_cast<std::ptrdiff_t>(end_column)};
+            trace_back(query, segment, query_size, end_column, alignment);
+            return alignment;
+        }
+
+    private:
+
+        //!\brief Advances a block of 64 rows by one column and returns the horizontal delta of its last row.
+        static int advance_block(word_t & pv, word_t & mv, word_t eq, int const horizontal_delta_in) noexcept
+        {
+            word_t const xv = eq | mv;
+            if (horizontal_delta_in < 0)
+                eq |= word_t{1};
+            word_t const xh = (((eq & pv) + pv) ^ pv) | eq;
+            word_t ph = mv | ~(xh | pv);
+            word_t mh = pv & xh;
+
+            int horizontal_delta_out = 0;
+            if (ph & _high_bit)
+                horizontal_delta_out = 1;
+            else if (mh & _high_bit)
+                horizontal_delta_out = -1;
+
+            ph <<= 1;
+            mh <<= 1;
+            if (horizontal_delta_in < 0)
+                mh |= word_t{1};
+            else if (horizontal_delta_in > 0)
+                ph |= word_t{1};
+
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            return horizontal_delta_out;
+        }
+
+        //!\brief The distance of the query prefix of length `row` to the best suffix of the segment prefix of length `column`.
+        int32_t distance(size_t const row, size_t const column) const noexcept
+        {
+            word_t const * pv = _pv.data() + column * _block_count;
+            word_t const * mv = _mv.data() + column * _block_count;
+            int32_t value{};
+            size_t const full_blocks = row / _word_size;
+            for (size_t block = 0; block < full_blocks; ++block)
+                value += std::popcount(pv[block]) - std::popcount(mv[block]);
+
+            if (size_t const remaining_rows = row % _word_size; remaining_rows > 0) {
+                word_t const mask = (word_t{1} << remaining_rows) - 1;
+                value += std::popcount(pv[full_blocks] & mask) - std::popcount(mv[full_blocks] & mask);
+            }
+            return value;
+        }
+
+        template <typename query_t, typename segment_t>
+        void trace_back(query_t const & query,
+                        segment_t const & segment,
+                        size_t row,
+                        size_t column,
+                        edit_alignment & alignment) const
+        {
+            std::vector<char> operations{};
+            operations.reserve(row + column);
+            int32_t value = alignment.edit_distance;
+            while (row > 0) {
+                if (column > 0) {
+                    int32_t const substitution_cost = (seqan3::to_rank(query[row - 1]) ==
+                                                       seqan3::to_rank(segment[column - 1])) ? 0 : 1;
+                    if (int32_t diagonal = distance(row - 1, column - 1); diagonal + substitution_cost == value) {
+                        operations.push_back('M');
+                        value = diagonal;
+                        --row;
+                        --column;
+                        continue;
+                    }
+                }
+
+                if (int32_t vertical = distance(row - 1, column); vertical + 1 == value) {
+                    operations.push_back('I');
+                    value = vertical;
+                    --row;
+                } else {
+                    operations.push_back('D');
+                    value = distance(row, column - 1);
+                    --column;
+                }
+            }
+            alignment.begin_position = column;
+
+            // Run length encode the operations in the order of the query.
+            for (auto it = operations.rbegin(); it != operations.rend();) {
+                auto run_end = std::find_if(it, operations.rend(), [op = *it] (char const other) { return other != op; });
+                alignment.cigar_sequence.emplace_back(static_cast<uint32_t>(std::distance(it, run_end)),
+                                                      seqan3::cigar::operation{}.assign_char(*it));
+                it = run_end;
+            }
+        }
+    };
+}  // namespace jstmap
@@ -0,0 +1,191 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a matcher finding all needles of a list exactly in a single scan.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <vector>
+
+#include <seqan3/alphabet/concept.hpp>
+
+namespace jstmap
+{
+    /*!\brief Finds exact occurrences of multiple needles in one pass over the haystack.
+     *
+     * \tparam needle_list_t The type of the needle list; must be a random access range of nucleotide sequences.
+     *
+     * \details
+     *
+     * All needles are indexed by the 2-bit encoded q-gram of their prefix, where q is the length of the shortest needle,
+     * but at most 32. The haystack is scanned once with a rolling q-gram code and every needle sharing the q-gram is
+     * compared at the position the q-gram implies for the needle begin. A needle with an ambiguous base in its prefix is
+     * indexed by its first q-gram without an ambiguous base instead. Only needles without any such q-gram are compared
+     * at every position.
+     */
+    template <std::ranges::random_access_range needle_list_t>
+    class exact_matcher
+    {
+    private:
+        using code_t = uint64_t;
+
+        //!\brief A needle indexed by the code of its q-gram starting at the given offset.
+        struct qgram_entry
+        {
+            code_t code{};
+            uint32_t needle_idx{};
+            uint32_t offset{};
+
+            constexpr friend auto operator<=>(qgram_entry const &, qgram_entry const &) noexcept = default;
+        };
+
+        static constexpr uint8_t _invalid_code = 4;
+
+        needle_list_t const & _needle_list;
+        std::vector<qgram_entry> _qgram_index{};
+        std::vector<uint32_t> _unencoded_needles{};
+        size_t _qgram_size{};
+        size_t _window_size{};
+
+    public:
+
+        exact_matcher() = delete;
+        explicit exact_matcher(needle_list_t const & needle_list) : _needle_list{needle_list}
+        {
+            if (std::ranges::empty(_needle_list))
+                return;
+
+            _qgram_size = 32;
+            for (auto && needle : _needle_list) {
+                _qgram_size = std::min<size_t>(_qgram_size, std::ranges::size(needle));
+                _window_size = std::max<size_t>(_window_size, std::ranges::size(needle));
+            }
+
+            if (_qgram_size == 0) // an empty needle can not be searched.
+                return;
+
+            for (uint32_t needle_idx = 0; needle_idx < std::ranges::size(_needle_list); ++needle_idx) {
+                if (auto entry = index_entry(needle_idx); entry.has_value())
+                    _qgram_index.push_back(*entry);
+                else
+                    _unencoded_needles.push_back(needle_idx);
+            }
+            std::ranges::sort(_qgram_index);
+        }
+
+        //!\brief The length of the longest needle.
+        size_t window_size() const noexcept
+        {
+            return _window_size;
+        }
+
+        /*!\brief Reports all exact occurrences of the needles within the haystack.
+         *
+         * \param[in] haystack The sequence to search.
+         * \param[in] callback The callback invoked with the needle index and the begin position of every occurrence.
+         */
+        template <std::ranges::random_access_range haystack_t, typename callback_t>
+        constexpr void operator()(haystack_t && haystack, callback_t && callback) const
+        {
+            std::ptrdiff_t const haystack_size = std::ranges::ssize(haystack);
+            if (_qgram_size == 0 || haystack_size < static_cast<std::ptrdiff_t>(_qgram_size))
+                return;
+
+            auto haystack_begin = std::ranges::begin(haystack);
+            code_t const mask = (_qgram_size == 32) ? ~code_t{0} : (code_t{1} << (2 * _qgram_size)) - 1;
+            code_t code{};
+            size_t valid_count{}; // the number of preceding symbols without an ambiguous base.
+
+            for (std::ptrdiff_t position = 0; position < haystack_size; ++position) {
+                uint8_t symbol_code = to_code(haystack_begin[position]);
+                if (symbol_code == _invalid_code) {
+                    valid_count = 0;
+                } else {
+                    code = ((code << 2) | symbol_code) & mask;
+                    ++valid_count;
+                }
+
+                std::ptrdiff_t begin_position = position + 1 - _qgram_size;
+                if (begin_position < 0)
+                    continue;
+
+                if (valid_count >= _qgram_size) {
+                    auto candidates = std::ranges::equal_range(_qgram_index, code, std::less<>{}, &qgram_entry::code);
+                    for (qgram_entry const & candidate : candidates)
+                        if (begin_position >= static_cast<std::ptrdiff_t>(candidate.offset))
+                            verify(haystack, begin_position - candidate.offset, candidate.needle_idx, callback);
+                }
+
+                for (uint32_t needle_idx : _unencoded_needles)
+                    verify(haystack, begin_position, needle_idx, callback);
+            }
+        }
+
+    private:
+
+        //!\brief Returns the entry of the first q-gram of the needle without an ambiguous base.
+        std::optional<qgram_entry> index_entry(uint32_t const needle_idx) const noexcept
+        {
+            auto && needle = _needle_list[needle_idx];
+            size_t const needle_size = std::ranges::size(needle);
+            size_t valid_count{};
+            code_t code{};
+            for (size_t position = 0; position < needle_size; ++position) {
+                uint8_t symbol_code = to_code(needle[position]);
+                if (symbol_code == _invalid_code) {
+                    valid_count = 0;
+                    continue;
+                }
+
+                code = (code << 2) | symbol_code;
+                if (++valid_count == _qgram_size) {
+                    code_t const mask = (_qgram_size == 32) ? ~code_t{0} : (code_t{1} << (2 * _qgram_size)) - 1;
+                    return qgram_entry{.code = code & mask,
+                                       .needle_idx = needle_idx,
+                                       .offset = static_cast<uint32_t>(position + 1 - _qgram_size)};
+                }
+            }
+            return std::nullopt;
+        }
+
+        template <typename haystack_t, typename callback_t>
+        constexpr void verify(haystack_t && haystack,
+                              std::ptrdiff_t const begin_position,
+                              uint32_t const needle_idx,
+                              callback_t && callback) const
+        {
+            auto && needle = _needle_list[needle_idx];
+            std::ptrdiff_t const needle_size = std::ranges::ssize(needle);
+            if (begin_position + needle_size > std::ranges::ssize(haystack))
+                return;
+
+            auto haystack_it = std::ranges::next(std::ranges::begin(haystack), begin_position);
+            if (std::ranges::equal(needle, std::ranges::subrange{haystack_it, haystack_it + needle_size}))
+                callback(needle_idx, begin_position);
+        }
+
+        template <typename symbol_t>
+        static constexpr uint8_t to_code(symbol_t const & symbol) noexcept
+        {
+            switch (seqan3::to_char(symbol))
+            {
+                case 'A': return 0;
+                case 'C': return 1;
+                case 'G': return 2;
+                case 'T': return 3;
+                default: return _invalid_code;
+            }
+        }
+    };
+}  // namespace jstmap
@@ -0,0 +1,129 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a resumable task to interleave the traversal of multiple trees.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace jstmap
+{
+    /*!\brief A lazily started coroutine that can be suspended between two visited nodes.
+     *
+     * \details
+     *
+     * A task suspends at every jstmap::interleave_point, after it requested the memory of its next node.
+     * Resuming several tasks in turn with jstmap::run_interleaved lets the memory accesses of one task overlap with the
+     * work of the other tasks.
+     * An exception thrown by the coroutine is rethrown by the call to jstmap::interleaved_task::resume.
+     */
+    class interleaved_task
+    {
+    public:
+
+        struct promise_type
+        {
+            std::exception_ptr exception{};
+
+            interleaved_task get_return_object() noexcept
+            {
+                return interleaved_task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            std::suspend_always final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+        };
+
+    private:
+
+        std::coroutine_handle<promise_type> _handle{};
+
+        explicit interleaved_task(std::coroutine_handle<promise_type> handle) noexcept : _handle{handle}
+        {}
+
+    public:
+
+        interleaved_task() = default; //!< A task without work, which is done.
+        interleaved_task(interleaved_task const &) = delete;
+        interleaved_task(interleaved_task && other) noexcept : _handle{std::exchange(other._handle, nullptr)}
+        {}
+        interleaved_task & operator=(interleaved_task const &) = delete;
+        interleaved_task & operator=(interleaved_task && other) noexcept
+        {
+            interleaved_task tmp{std::move(other)};
+            std::swap(_handle, tmp._handle);
+            return *this;
+        }
+        ~interleaved_task()
+        {
+            if (_handle)
+                _handle.destroy();
+        }
+
+        bool done() const noexcept
+        {
+            return !_handle || _handle.done();
+        }
+
+        //!\brief Continues the task until the next interleave point or its end.
+        void resume()
+        {
+            _handle.resume();
+            if (_handle.done() && _handle.promise().exception)
+                std::rethrow_exception(_handle.promise().exception);
+        }
+
+        //!\brief Runs the task to completion.
+        void run()
+        {
+            while (!done())
+                resume();
+        }
+    };
+
+    /*!\brief Suspends the awaiting task if interleaving is enabled.
+     *
+     * \details
+     *
+     * Without interleaving the awaiter never suspends, such that a task run by jstmap::interleaved_task::run
+     * does not pay for the switch between the coroutine and its caller at every node.
+     */
+    struct interleave_point
+    {
+        bool enabled{}; //!< Whether the task yields to the other interleaved tasks.
+
+        constexpr bool await_ready() const noexcept { return !enabled; }
+        constexpr void await_suspend(std::coroutine_handle<>) const noexcept {}
+        constexpr void await_resume() const noexcept {}
+    };
+
+    //!\brief Resumes the tasks in round robin order until all of them are done.
+    inline void run_interleaved(std::vector<interleaved_task> & tasks)
+    {
+        std::vector<interleaved_task *> active_tasks{};
+        active_tasks.reserve(tasks.size());
+        for (interleaved_task & task : tasks)
+            if (!task.done())
+                active_tasks.push_back(&task);
+
+        while (!active_tasks.empty()) {
+            for (interleaved_task * task : active_tasks)
+                task->resume();
+
+            std::erase_if(active_tasks, [] (interleaved_task const * task) { return task->done(); });
+        }
+    }
+}  // namespace jstmap
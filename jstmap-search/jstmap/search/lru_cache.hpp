@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a cache evicting the least recently used entry.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace jstmap
+{
+    /*!\brief A cache of fixed capacity, which evicts the least recently used entry when it is full.
+     *
+     * \tparam key_t The key type; must be totally ordered.
+     * \tparam value_t The type of the cached values.
+     *
+     * \details
+     *
+     * The cache is not thread-safe; every thread uses its own cache.
+     */
+    template <typename key_t, typename value_t>
+    class lru_cache
+    {
+    private:
+        using entry_list_t = std::list<std::pair<key_t, value_t>>;
+
+        entry_list_t _entries{}; //!< The entries ordered from the most to the least recently used.
+        std::map<key_t, typename entry_list_t::iterator> _index{};
+        size_t _capacity{};
+
+    public:
+
+        explicit lru_cache(size_t const capacity) : _capacity{std::max<size_t>(capacity, 1)}
+        {}
+
+        size_t size() const noexcept
+        {
+            return _entries.size();
+        }
+
+        size_t capacity() const noexcept
+        {
+            return _capacity;
+        }
+
+        /*!\brief Returns the cached value of the key and creates it on a miss.
+         *
+         * \param[in] key The key to look up.
+         * \param[in] make_value The callable creating the value of a missing key.
+         *
+         * \details
+         *
+         * The returned reference is valid until the entry is evicted, i.e. until `capacity` other keys were accessed.
+         */
+        template <typename value_factory_t>
+        value_t & get_or_emplace(key_t const & key, value_factory_t && make_value)
+        {
+            if (auto it = _index.find(key); it != _index.end()) {
+                _entries.splice(_entries.begin(), _entries, it->second);
+                return it->second->second;
+            }
+
+            if (_entries.size() == _capacity) {
+                _index.erase(_entries.back().first);
+                _entries.pop_back();
+            }
+
+            _entries.emplace_front(key, make_value());
+            _index.emplace(key, _entries.begin());
+            return _entries.front().second;
+        }
+
+        void clear() noexcept
+        {
+            _entries.clear();
+            _index.clear();
+        }
+    };
+}  // namespace jstmap
@@ -10,6 +10,10 @@
  * \author Rene Rahn <rene.rahn AT fu-berlin.de>
  */
 
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
 #include <seqan3/utility/views/slice.hpp>
 #include <seqan3/core/debug_stream.hpp>
 
@@ -19,40 +23,89 @@
 
 namespace jstmap
 {
-    search_match match_aligner::operator()(match_position pos) const
+    std::vector<search_match> match_alignment_queue::align_batch(size_t const first, size_t const last)
     {
-        auto node = _reference_tree.seek(pos.tree_position);
-        auto cargo = *node;
-        auto ref_sequence = cargo.path_sequence();
+        // Extract the reference segments and the haplotypes of the batch.
+        std::vector<reference_t> ref_segments{};
+        std::vector<std::vector<uint8_t>> haplotype_sets{};
+        ref_segments.reserve(last - first);
+        haplotype_sets.reserve(last - first);
+        std::ptrdiff_t max_error_count{};
+        for (size_t idx = first; idx < last; ++idx) {
+            alignment_job const & job = _jobs[idx];
+            std::ptrdiff_t const query_size = std::ranges::ssize(*job.query);
+            std::ptrdiff_t const errors = _aligner.error_count(query_size);
+            max_error_count = std::max(max_error_count, errors);
+
+            size_t const window_size = query_size - 1;
+            node_key_type const node_key{window_size, job.position.tree_position};
+            cached_node const & cached = _node_cache.get_or_emplace(node_key, [&] () {
+                node_type node = _aligner.reference_tree(window_size).seek(job.position.tree_position);
+                std::vector<uint8_t> haplotypes = encode_haplotype_set((*node).coverage());
+                return cached_node{.node = std::move(node), .haplotypes = std::move(haplotypes)};
+            });
+            haplotype_sets.push_back(cached.haplotypes);
+            auto cargo = *cached.node;
+            auto ref_sequence = cargo.path_sequence();
+
+            std::ptrdiff_t begin_position = std::max<std::ptrdiff_t>(0, job.position.label_offset - errors);
+            std::ptrdiff_t end_position = std::min(job.position.label_offset + query_size + errors,
+                                                   std::ranges::ssize(ref_sequence));
 
-        std::ptrdiff_t errors = std::ceil(_error_rate * std::ranges::ssize(_query_sequence));
-        std::ptrdiff_t begin_position = std::max<std::ptrdiff_t>(0, pos.label_offset - errors);
-        std::ptrdiff_t end_position = std::min(pos.label_offset + std::ranges::ssize(_query_sequence) + errors,
-                                               std::ranges::ssize(ref_sequence));
+            reference_t & ref_segment = ref_segments.emplace_back();
+            std::ranges::copy(ref_sequence | seqan3::views::slice(begin_position, end_position),
+                              std::back_inserter(ref_segment));
+        }
+
+        std::vector<search_match> aligned_matches = (_aligner.mode() == alignment_mode::edit)
+                                                  ? align_batch_edit(first, ref_segments)
+                                                  : align_batch_affine(first, ref_segments, max_error_count);
+
+        for (size_t batch_idx = 0; batch_idx < aligned_matches.size(); ++batch_idx)
+            aligned_matches[batch_idx].set_haplotypes(std::move(haplotype_sets[batch_idx]));
+        return aligned_matches;
+    }
+
+    std::vector<search_match> match_alignment_queue::align_batch_affine(size_t const first,
+                                                                        std::vector<reference_t> const & ref_segments,
+                                                                        std::ptrdiff_t const max_error_count)
+    {
+        size_t const last = first + ref_segments.size();
+        std::vector<std::tuple<record_sequence_t const &, reference_t const &>> sequence_pairs{};
+        sequence_pairs.reserve(last - first);
+        for (size_t idx = first; idx < last; ++idx)
+            sequence_pairs.emplace_back(*_jobs[idx].query, ref_segments[idx - first]);
 
         auto align_config = match_aligner::get_alignment_config(
             seqan3::match_score{4},
             seqan3::mismatch_score{-5},
             seqan3::align_cfg::open_score{-10},
-            seqan3::align_cfg::extension_score{-1}
+            seqan3::align_cfg::extension_score{-1},
+            static_cast<int32_t>(3 * max_error_count)
         );
 
-        auto ref_segment = ref_sequence | seqan3::views::slice(begin_position, end_position);
-        auto results = seqan3::align_pairwise(std::tie(_query_sequence, ref_segment), align_config);
-        auto pairwise_align_result = *results.begin();
-        return search_match{std::move(pos), alignment_result{std::move(pairwise_align_result)}};
+        std::vector<search_match> aligned_matches(last - first);
+        for (auto && result : seqan3::align_pairwise(sequence_pairs, align_config)) {
+            size_t const batch_idx = result.sequence1_id();
+            aligned_matches[batch_idx] = search_match{std::move(_jobs[first + batch_idx].position),
+                                                      alignment_result{std::move(result)}};
+        }
+        return aligned_matches;
     }
 
-    match_aligner::ref_tree_type match_aligner::init(rcs_store_t const & rcs_store) {
-        size_t window_size = std::ranges::size(_query_sequence) - 1;
-        return rcs_store | libjst::make_volatile()
-                         | libjst::labelled()
-                        //  | libjst::coloured()
-                         | libjst::trim(window_size)
-                        //  | libjst::prune()
-                         | libjst::left_extend(window_size)
-                         | libjst::merge()
-                         | libjst::seek();
+    std::vector<search_match> match_alignment_queue::align_batch_edit(size_t const first,
+                                                                      std::vector<reference_t> const & ref_segments)
+    {
+        std::vector<search_match> aligned_matches{};
+        aligned_matches.reserve(ref_segments.size());
+        for (size_t batch_idx = 0; batch_idx < ref_segments.size(); ++batch_idx) {
+            alignment_job & job = _jobs[first + batch_idx];
+            edit_alignment alignment = _edit_aligner(*job.query, ref_segments[batch_idx]);
+            aligned_matches.emplace_back(std::move(job.position),
+                                         alignment_result{-alignment.edit_distance,
+                                                          std::move(alignment.cigar_sequence)});
+        }
+        return aligned_matches;
     }
 
 }  // namespace jstmap
@@ -12,91 +12,82 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <seqan3/alignment/configuration/align_config_band.hpp>
 #include <seqan3/alignment/configuration/align_config_gap_cost_affine.hpp>
 #include <seqan3/alignment/configuration/align_config_scoring_scheme.hpp>
 #include <seqan3/alignment/configuration/align_config_method.hpp>
+#include <seqan3/alignment/configuration/align_config_vectorised.hpp>
 #include <seqan3/alignment/scoring/nucleotide_scoring_scheme.hpp>
 
-#include <libspm/std/tag_invoke.hpp>
-
-#include <libjst/sequence_tree/coloured_tree.hpp>
-#include <libjst/sequence_tree/labelled_tree.hpp>
-#include <libjst/sequence_tree/left_extend_tree.hpp>
-#include <libjst/sequence_tree/merge_tree.hpp>
-#include <libjst/sequence_tree/prune_tree.hpp>
-#include <libjst/sequence_tree/seekable_tree.hpp>
-#include <libjst/sequence_tree/trim_tree.hpp>
-#include <libjst/sequence_tree/volatile_tree.hpp>
-
+#include <jstmap/global/haplotype_set.hpp>
 #include <jstmap/global/match_position.hpp>
+#include <jstmap/global/reference_tree_cache.hpp>
 #include <jstmap/global/search_match.hpp>
+#include <jstmap/search/edit_distance_aligner.hpp>
+#include <jstmap/search/lru_cache.hpp>
+#include <jstmap/search/options.hpp>
 #include <jstmap/search/type_alias.hpp>
 
 namespace jstmap
 {
 
-    namespace detail {
-        namespace _defer {
-            template <auto & cpo, typename ...args_t>
-            struct _cpo  {
-                constexpr auto operator()() const
-                    noexcept(std::is_nothrow_invocable_v<std::tag_t<cpo>, args_t...>)
-                    -> std::invoke_result_t<std::tag_t<cpo>, args_t...> {
-                    return std::invoke(cpo, std::declval<args_t>()...);
-                }
-            };
-
-            template <auto & cpo, typename ...args_t>
-            inline constexpr _cpo<cpo, args_t...> defer;
-        } // namespace _defer
-
-        using _defer::defer;
-
-        template <auto & cpo>
-        using instantiate_t = std::invoke_result_t<std::tag_t<cpo>>;
-
-    } // namespace detail
+    /*!\brief Provides the reference trees and the alignment configuration to align the queries at their matches.
+     *
+     * \details
+     *
+     * A single aligner is shared by all threads of a run. It keeps one reference tree per window size, i.e. per query
+     * size, which is created by the first thread that requests it. The matches are aligned by a
+     * jstmap::match_alignment_queue, which every thread owns.
+     */
+    class match_aligner {
+    public:
 
-    template <typename rcs_store_t, auto & ...tree_cpos>
-    using composed_tree_t =
-        std::remove_cvref_t<
-            decltype((std::declval<rcs_store_t>() | ... | std::declval<detail::instantiate_t<tree_cpos>>()))
-        >;
+        using ref_tree_type = reference_tree_cache::tree_type;
 
-    class match_aligner {
+    private:
 
-        using ref_tree_type = composed_tree_t<rcs_store_t const &,
-                                                libjst::make_volatile,
-                                                libjst::labelled,
-                                                // libjst::coloured,
-                                                detail::defer<libjst::trim, size_t>,
-                                                // libjst::prune,
-                                                detail::defer<libjst::left_extend, size_t>,
-                                                libjst::merge,
-                                                libjst::seek
-                                             >;
-
-        record_sequence_t const & _query_sequence;
-        ref_tree_type _reference_tree;
+        reference_tree_cache _reference_trees;
         double _error_rate{};
+        alignment_mode _mode{};
 
     public:
 
         explicit match_aligner(rcs_store_t const & rcs_store,
-                               record_sequence_t const & query_sequence,
-                               double error_rate = 0.03) :
-            _query_sequence{query_sequence},
-            _reference_tree{init(rcs_store)},
-            _error_rate{error_rate}
+                               double error_rate = 0.03,
+                               alignment_mode mode = alignment_mode::affine) :
+            _reference_trees{rcs_store},
+            _error_rate{error_rate},
+            _mode{mode}
         {}
 
-        search_match operator()(match_position pos) const;
+        //!\brief Returns the reference tree for the window size; thread-safe and valid for the lifetime of the aligner.
+        ref_tree_type const & reference_tree(size_t const window_size) const
+        {
+            return _reference_trees.get(window_size);
+        }
 
-    private:
+        //!\brief The method used to align the matches.
+        alignment_mode mode() const noexcept
+        {
+            return _mode;
+        }
+
+        //!\brief The number of errors allowed for a query of the given size.
+        std::ptrdiff_t error_count(std::ptrdiff_t const query_size) const noexcept
+        {
+            return static_cast<std::ptrdiff_t>(std::ceil(_error_rate * query_size));
+        }
 
         template <typename match_score_t, typename mismatch_score_t,
                   typename gap_open_t, typename gap_extension_t>
-        static auto get_alignment_config(match_score_t ms, mismatch_score_t mms, gap_open_t go, gap_extension_t ge) noexcept {
+        static auto get_alignment_config(match_score_t ms, mismatch_score_t mms, gap_open_t go, gap_extension_t ge,
+                                         int32_t const band_size) noexcept {
             return  seqan3::align_cfg::method_global{
                         seqan3::align_cfg::free_end_gaps_sequence1_leading{false},
                         seqan3::align_cfg::free_end_gaps_sequence2_leading{true},
@@ -104,9 +95,112 @@ namespace jstmap
                         seqan3::align_cfg::free_end_gaps_sequence2_trailing{true}
                     }
                     | seqan3::align_cfg::scoring_scheme{seqan3::nucleotide_scoring_scheme{ms,mms}}
-                    | seqan3::align_cfg::gap_cost_affine{go, ge};
+                    | seqan3::align_cfg::gap_cost_affine{go, ge}
+                    | seqan3::align_cfg::band_fixed_size{seqan3::align_cfg::lower_diagonal{-band_size},
+                                                         seqan3::align_cfg::upper_diagonal{band_size}}
+                    | seqan3::align_cfg::vectorised{};
+        }
+
+    };
+
+    /*!\brief Aligns the queued matches in batches.
+     *
+     * \details
+     *
+     * Aligning the queue extracts the reference segments of up to `batch_size` matches and computes their alignments
+     * together with the vectorised and banded alignment of seqan3, which aligns multiple sequence pairs in the lanes
+     * of one SIMD vector.
+     * The reference segment of a match covers the query extended by the number of errors allowed for the query on
+     * both sides. Hence, the query starts within the first `2e` positions of the segment, and the band spans `3e`
+     * diagonals on both sides of the main diagonal, where `e` is the maximal error count within the batch.
+     *
+     * In the jstmap::alignment_mode::edit mode, the matches are aligned with the jstmap::edit_distance_aligner instead,
+     * which computes the unit cost CIGAR within the same segment and skips the affine dynamic programming.
+     *
+     * The nodes sought for the segments are kept in a cache of the most recently used tree positions, such that
+     * matches sharing a node, e.g. the matches of different queries in the same region, seek the tree only once.
+     * The coverage of the sought node, i.e. the haplotypes sharing the path to the node, is intersected by the coloured
+     * tree during the seek and is attached to the aligned matches as encoded by jstmap::encode_haplotype_set.
+     * A queue is not thread-safe; every thread uses its own queue of the shared aligner.
+     */
+    class match_alignment_queue {
+    private:
+
+        using ref_tree_type = match_aligner::ref_tree_type;
+        using node_type = decltype(std::declval<ref_tree_type const &>().seek(std::declval<libjst::seek_position>()));
+        using node_key_type = std::pair<size_t, libjst::seek_position>; // window size and tree position.
+
+        struct cached_node {
+            node_type node;
+            std::vector<uint8_t> haplotypes{}; //!< The encoded coverage of the path to the node.
+        };
+
+        struct alignment_job {
+            record_sequence_t const * query{};
+            match_position position{};
+            size_t id{};
+        };
+
+        match_aligner const & _aligner;
+        size_t _batch_size{};
+        std::vector<alignment_job> _jobs{};
+        lru_cache<node_key_type, cached_node> _node_cache;
+        edit_distance_aligner _edit_aligner{};
+
+    public:
+
+        //!\brief The default number of matches aligned together.
+        static constexpr size_t default_batch_size = 4096;
+        //!\brief The default number of cached tree nodes.
+        static constexpr size_t default_cache_capacity = 1024;
+
+        explicit match_alignment_queue(match_aligner const & aligner,
+                                       size_t const batch_size = default_batch_size,
+                                       size_t const cache_capacity = default_cache_capacity) :
+            _aligner{aligner},
+            _batch_size{std::max<size_t>(batch_size, 1)},
+            _node_cache{cache_capacity}
+        {}
+
+        /*!\brief Queues the match of a query.
+         *
+         * \param[in] query The query sequence; must stay valid until the match was aligned.
+         * \param[in] position The match position of the query.
+         * \param[in] id The identifier passed to the callback together with the aligned match.
+         */
+        void add(record_sequence_t const & query, match_position position, size_t const id)
+        {
+            _jobs.push_back(alignment_job{.query = &query, .position = std::move(position), .id = id});
+        }
+
+        //!\brief The number of queued matches.
+        size_t size() const noexcept
+        {
+            return _jobs.size();
         }
 
-        ref_tree_type init(rcs_store_t const & rcs_store);
+        /*!\brief Aligns all queued matches and clears the queue.
+         *
+         * \param[in] callback The callback invoked with the identifier and the jstmap::search_match of every match.
+         */
+        template <typename callback_t>
+        void align(callback_t && callback)
+        {
+            for (size_t first = 0; first < _jobs.size(); first += _batch_size) {
+                size_t const last = std::min(first + _batch_size, _jobs.size());
+                std::vector<search_match> aligned_matches = align_batch(first, last);
+                for (size_t idx = first; idx < last; ++idx)
+                    callback(_jobs[idx].id, std::move(aligned_matches[idx - first]));
+            }
+            _jobs.clear();
+        }
+
+    private:
+
+        std::vector<search_match> align_batch(size_t const first, size_t const last);
+        std::vector<search_match> align_batch_affine(size_t const first,
+                                                     std::vector<reference_t> const & ref_segments,
+                                                     std::ptrdiff_t const max_error_count);
+        std::vector<search_match> align_batch_edit(size_t const first, std::vector<reference_t> const & ref_segments);
     };
 }  // namespace jstmap
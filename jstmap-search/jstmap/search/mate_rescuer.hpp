@@ -0,0 +1,143 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the rescue of a mate within the insert size window of its partner.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <ranges>
+
+#include <seqan3/alphabet/concept.hpp>
+
+#include <libspm/matcher/myers_matcher_restorable.hpp>
+#include <libjst/sequence_tree/coloured_tree.hpp>
+#include <libjst/sequence_tree/labelled_tree.hpp>
+#include <libjst/sequence_tree/merge_tree.hpp>
+#include <libjst/sequence_tree/prune_tree.hpp>
+#include <libjst/sequence_tree/seekable_tree.hpp>
+#include <libjst/sequence_tree/volatile_tree.hpp>
+#include <libjst/traversal/tree_traverser_base.hpp>
+
+#include <jstmap/global/match_position.hpp>
+#include <jstmap/search/seed_extension_tree.hpp>
+#include <jstmap/search/seed_node_wrapper.hpp>
+
+namespace jstmap
+{
+    //!\brief Returns the reverse complement of a nucleotide sequence.
+    template <typename sequence_t>
+    sequence_t reverse_complement(sequence_t const & sequence)
+    {
+        using symbol_t = std::ranges::range_value_t<sequence_t>;
+        sequence_t result{};
+        for (auto it = std::ranges::rbegin(sequence); it != std::ranges::rend(sequence); ++it) {
+            char complement{};
+            switch (seqan3::to_char(*it))
+            {
+                case 'A': complement = 'T'; break;
+                case 'C': complement = 'G'; break;
+                case 'G': complement = 'C'; break;
+                case 'T': complement = 'A'; break;
+                default: complement = 'N';
+            }
+            result.push_back(seqan3::assign_char_to(complement, symbol_t{}));
+        }
+        return result;
+    }
+
+    /*!\brief Searches a mate within the insert size window behind a match of its partner.
+     *
+     * \tparam base_tree_t The type of the tree to search in.
+     *
+     * \details
+     *
+     * Instead of mapping the mate globally, it is only searched in the window of the maximal insert size that starts at
+     * the match of its partner. The window is traversed with the bounded jstmap::seed_extension_tree, which covers all
+     * haplotype paths leaving the partner's match, and the mate is searched with the restorable matcher of Myers,
+     * whose state is restored with the jstmap::extension_state_manager when the traversal returns to a branch.
+     * The mate is expected on the opposite strand, i.e. the given mate must already be reverse complemented.
+     * Only the window downstream of the partner's match is searched, such that a mate located in front of its partner
+     * is not rescued. The rescuer holds no state of a mate and can be shared by all reads and threads.
+     */
+    template <typename base_tree_t>
+    class mate_rescuer
+    {
+    private:
+        base_tree_t const & _base_tree;
+        double _error_rate{};
+        uint32_t _max_insert_size{};
+
+    public:
+        mate_rescuer(base_tree_t const & base_tree, double error_rate, uint32_t max_insert_size) :
+            _base_tree{base_tree},
+            _error_rate{error_rate},
+            _max_insert_size{max_insert_size}
+        {}
+
+        /*!\brief Reports every occurrence of the mate within the insert size window of the anchor.
+         *
+         * \param[in] mate The reverse complemented mate sequence.
+         * \param[in] anchor The match position of the partner.
+         * \param[in] callback The callback invoked with the jstmap::match_position of the begin of every rescued mate
+         *                     and the template length, i.e. the distance from the begin of the anchor to the end of
+         *                     the mate along the haplotype path.
+         */
+        template <typename mate_t, typename callback_t>
+        void operator()(mate_t const & mate, match_position anchor, callback_t && callback) const
+        {
+            std::ptrdiff_t const mate_size = std::ranges::ssize(mate);
+            if (mate_size == 0 || mate_size > static_cast<std::ptrdiff_t>(_max_insert_size))
+                return;
+
+            uint32_t const error_count = static_cast<uint32_t>(std::floor(_error_rate * mate_size));
+            spm::restorable_myers_matcher matcher{mate, static_cast<size_t>(error_count)};
+
+            auto rescue_tree = _base_tree | libjst::make_volatile()
+                                          | libjst::labelled()
+                                          | libjst::coloured()
+                                          | libjst::prune()
+                                          | libjst::merge()
+                                          | libjst::seek()
+                                          | jstmap::extend_from(std::move(anchor), _max_insert_size);
+
+            libjst::tree_traverser_base rescue_traverser{rescue_tree};
+            extension_state_manager manager{matcher};
+            rescue_traverser.subscribe(manager);
+
+            // The end positions of one occurrence lie within the error count of each other and are reported once.
+            std::ptrdiff_t last_begin_position = -static_cast<std::ptrdiff_t>(_max_insert_size);
+            // The label of the root begins with the anchor; all paths of the window extend the path to the root.
+            std::optional<std::ptrdiff_t> anchor_begin{};
+            for (auto cargo : rescue_traverser) {
+                if (!std::ranges::empty(cargo.sequence())) // The matcher keeps its state on empty labels.
+                    manager.save_state();
+
+                std::ptrdiff_t const label_begin = std::ranges::ssize(cargo.path_sequence()) -
+                                                   std::ranges::ssize(cargo.sequence());
+                if (!anchor_begin.has_value())
+                    anchor_begin = label_begin;
+
+                matcher(cargo.sequence(), [&] (auto && finder) {
+                    std::ptrdiff_t const begin_position = std::max<std::ptrdiff_t>(0,
+                                                                label_begin + endPosition(finder) - mate_size);
+                    if (std::abs(begin_position - last_begin_position) <= static_cast<std::ptrdiff_t>(error_count))
+                        return;
+
+                    last_begin_position = begin_position;
+                    callback(match_position{.tree_position = cargo.position(), .label_offset = begin_position},
+                             begin_position + mate_size - *anchor_begin);
+                });
+            }
+        }
+    };
+}  // namespace jstmap
@@ -12,19 +12,43 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <string_view>
+#include <unordered_map>
 
 namespace jstmap
 {
 
+//!\brief The method used to align the queries at their matches.
+enum class alignment_mode
+{
+    affine, //!< Global alignment with affine gap costs.
+    edit //!< Alignment with unit costs, which only computes the edit distance and the CIGAR.
+};
+
+//!\brief The names of the alignment modes on the command line.
+inline std::unordered_map<std::string_view, alignment_mode> enumeration_names(alignment_mode)
+{
+    return {{"affine", alignment_mode::affine}, {"edit", alignment_mode::edit}};
+}
+
 struct search_options
 {
     std::filesystem::path jst_input_file_path{}; //!< The file path to the journaled sequence tree.
     std::filesystem::path query_input_file_path{}; //!< The file path containing the queries.
+    std::filesystem::path mate_input_file_path{}; //!< The file path containing the mates of the queries.
     std::filesystem::path index_input_file_path{}; //!< The file path containing the ibf index.
     std::filesystem::path map_output_file_path{}; //!< The file path to write the alignment map file to.
+    std::filesystem::path topology_cache_file_path{}; //!< The file path containing the filter tree topology cache.
     float error_rate{0.0}; //!< The error rate to use for mapping the reads.
     size_t thread_count{1}; //!< The number of threads to use for the program.
+    size_t interleave_count{1}; //!< The number of buckets searched interleaved by every thread.
+    alignment_mode alignment{alignment_mode::affine}; //!< The method used to align the matches.
+    uint32_t max_insert_size{1000}; //!< The maximal distance between the begin of a query and the end of its mate.
+    size_t max_memory{1024}; //!< The memory in MiB of the buffered records of a sorted output.
+    bool sort_output = false; //!< Determines wether the output is sorted by position; defaults to `false`.
+    bool best_only = false; //!< Determines wether only the hits with the fewest errors are reported; defaults to `false`.
     bool is_quite = false; //!< Determines wether to log additional information; defaults to `false`.
     bool is_verbose = false; //!< Determines wether to log verbose information; defaults to `false`.
 };
@@ -0,0 +1,67 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <seqan3/alphabet/concept.hpp>
+
+#include <jstmap/search/order_queries.hpp>
+
+namespace jstmap
+{
+
+uint64_t query_minimiser(record_sequence_t const & sequence)
+{
+    // Shuffles the k-mer codes, such that low complexity k-mers like poly-A do not become the minimiser of every query.
+    constexpr uint64_t seed = 0x8F3F73B5CF1C9ADEull;
+    constexpr uint64_t mask = (uint64_t{1} << (2 * query_minimiser_size)) - 1;
+
+    uint64_t minimiser = std::numeric_limits<uint64_t>::max();
+    uint64_t code{};
+    size_t valid_count{};
+    for (auto const & symbol : sequence) {
+        uint64_t symbol_code{};
+        switch (seqan3::to_char(symbol))
+        {
+            case 'A': symbol_code = 0; break;
+            case 'C': symbol_code = 1; break;
+            case 'G': symbol_code = 2; break;
+            case 'T': symbol_code = 3; break;
+            default: valid_count = 0; continue;
+        }
+
+        code = ((code << 2) | symbol_code) & mask;
+        if (++valid_count >= query_minimiser_size)
+            minimiser = std::min(minimiser, code ^ (seed & mask));
+    }
+    return minimiser;
+}
+
+void order_by_minimiser(search_queries_type & queries)
+{
+    if (queries.size() < 2)
+        return;
+
+    std::vector<std::pair<uint64_t, size_t>> sort_keys{};
+    sort_keys.reserve(queries.size());
+    for (size_t idx = 0; idx < queries.size(); ++idx)
+        sort_keys.emplace_back(query_minimiser(queries[idx].value().sequence()), idx);
+
+    std::ranges::sort(sort_keys);
+
+    search_queries_type ordered_queries{};
+    ordered_queries.reserve(queries.size());
+    for (auto [minimiser, idx] : sort_keys)
+        ordered_queries.push_back(std::move(queries[idx]));
+
+    queries = std::move(ordered_queries);
+}
+
+} // namespace jstmap
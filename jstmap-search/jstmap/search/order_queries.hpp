@@ -0,0 +1,40 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the ordering of the queries of a bucket by their minimiser.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <jstmap/search/type_alias.hpp>
+
+namespace jstmap
+{
+
+//!\brief The k-mer size used to compute the minimiser of a query.
+inline constexpr uint8_t query_minimiser_size = 16;
+
+// Returns the smallest hash of all k-mers of the sequence without an ambiguous base, or the maximal value if there is
+// no such k-mer.
+uint64_t query_minimiser(record_sequence_t const &);
+
+/*!\brief Orders the queries of the bucket by their minimiser.
+ *
+ * \details
+ *
+ * Queries sharing a minimiser share a long substring, such that they are likely to hit the same q-grams of the
+ * matcher and to verify the same seeds. Placing them next to each other in the needle list makes the lookups of the
+ * matcher and the per-needle state of the searcher access neighbouring memory. Queries with the same minimiser keep
+ * their relative order.
+ */
+void order_by_minimiser(search_queries_type &);
+
+} // namespace jstmap
@@ -12,15 +12,12 @@
 
 #pragma once
 
-#include <libspm/matcher/pigeonhole_matcher.hpp>
-#include <libjst/sequence_tree/labelled_tree.hpp>
-#include <libjst/sequence_tree/coloured_tree.hpp>
-#include <libjst/sequence_tree/left_extend_tree.hpp>
-#include <libjst/sequence_tree/merge_tree.hpp>
-#include <libjst/sequence_tree/prune_tree.hpp>
-#include <libjst/sequence_tree/seekable_tree.hpp>
-#include <libjst/sequence_tree/trim_tree.hpp>
-#include <libjst/traversal/tree_traverser_base.hpp>
+#include <functional>
+
+#include <jstmap/global/filter_tree.hpp>
+#include <jstmap/search/interleaved_task.hpp>
+#include <jstmap/search/qgram_seed_table.hpp>
+#include <jstmap/search/visit_filter_nodes.hpp>
 
 namespace jstmap
 {
@@ -42,28 +39,38 @@ namespace jstmap
 
         template <typename callback_t>
         constexpr void operator()(callback_t && callback) const {
-            spm::pigeonhole_matcher filter{_bucket.needle_list, _error_rate};
-
-            assert(spm::window_size(filter) > 0);
-            // std::cout << "spm::window_size(filter) = " << spm::window_size(filter) << "\n";
+            search(std::ref(callback), false).run();
+        }
 
-            auto filter_tree = _bucket.base_tree | libjst::labelled()
-                                                 | libjst::coloured()
-                                                 | libjst::trim(spm::window_size(filter) - 1)
-                                                 | libjst::prune()
-                                                 | libjst::left_extend(spm::window_size(filter) - 1)
-                                                 | libjst::merge()
-                                                 | libjst::seek();
+        /*!\brief Returns a task filtering the bucket, which suspends before every node if `interleave` is `true`.
+         *
+         * \param[in] callback The callback invoked with the cargo, the seed finder and the seed hit; stored in the task.
+         * \param[in] interleave Whether the task can be interleaved with other tasks.
+         *
+         * \details
+         *
+         * The bucket must outlive the returned task.
+         */
+        template <typename callback_t>
+        interleaved_task search(callback_t callback, bool const interleave) const {
+            qgram_seed_table seed_table{_bucket.needle_list, _error_rate};
+            size_t const window_size = seed_table.window_size();
+            if (window_size == 0)
+                return interleaved_task{};
 
-            libjst::tree_traverser_base traverser{filter_tree};
-            for (auto it = traverser.begin(); it != traverser.end(); ++it) {
-                auto seed_cargo = *it;
-                // std::cout << "First sequence\n";
-                filter(seed_cargo.sequence(), [&] (auto const & seed_finder) {
-                    // std::cout << "Found seed\n";
-                    callback(seed_cargo, seed_finder, filter.position());
+            auto filter_node = [seed_table = std::move(seed_table), callback = std::move(callback)] (auto seed_cargo) mutable {
+                seed_table(seed_cargo.sequence(), [&] (seed_finder const & finder, seed_hit const & hit) {
+                    callback(seed_cargo, finder, hit);
                 });
-            }
+            };
+
+            // Replay the precomputed topology if it was collected for the same window size.
+            bool const use_cache = _bucket.cached_nodes != nullptr && _bucket.cached_window_size == window_size;
+            return visit_filter_nodes(make_filter_tree(_bucket.base_tree, window_size),
+                                      use_cache ? _bucket.cached_nodes : nullptr,
+                                      _bucket.cached_source,
+                                      std::move(filter_node),
+                                      interleave);
         }
     };
 }  // namespace jstmap
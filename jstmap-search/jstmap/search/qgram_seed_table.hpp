@@ -0,0 +1,295 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides an open addressing q-gram table for the pigeonhole seeds of a needle list.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+#include <seqan3/alphabet/concept.hpp>
+
+namespace jstmap
+{
+    //!\brief The seed of a needle matching a window of the haystack.
+    struct seed_hit
+    {
+        uint32_t index{}; //!< The index of the needle.
+        uint32_t offset{}; //!< The begin position of the seed within the needle.
+        uint32_t count{}; //!< The length of the seed.
+    };
+
+    //!\brief The location of a seed within the searched haystack.
+    struct seed_finder
+    {
+        std::ptrdiff_t begin_position{}; //!< The first position of the seed.
+        std::ptrdiff_t end_position{}; //!< The position behind the last position of the seed.
+
+        friend constexpr std::ptrdiff_t beginPosition(seed_finder const & finder) noexcept
+        {
+            return finder.begin_position;
+        }
+
+        friend constexpr std::ptrdiff_t endPosition(seed_finder const & finder) noexcept
+        {
+            return finder.end_position;
+        }
+    };
+
+    /*!\brief Finds the pigeonhole seeds of multiple needles in a haystack.
+     *
+     * \tparam needle_list_t The type of the needle list; must be a random access range of nucleotide sequences.
+     *
+     * \details
+     *
+     * Every needle with `e` allowed errors is split into `e + 1` non-overlapping seeds of the same length, such that
+     * every occurrence with at most `e` errors contains at least one of the seeds exactly.
+     * The seeds are stored in a flat table with open addressing and linear probing, which is keyed by the 2-bit code
+     * of the first 32 bases of the seed. Each slot refers to the consecutive list of seeds sharing the code.
+     *
+     * A haystack is searched in three passes over the window codes of the haystack.
+     * The first pass computes the rolling codes, the second pass hashes all codes, and the third pass prefetches the slots
+     * of the upcoming windows, probes the slots and collects all hits, which are verified and reported together at the end.
+     * Separating the passes removes the loop carried dependency of the rolling code from the hashing loop, which can be
+     * vectorised by the compiler, and hides the latency of the random table accesses behind the prefetches.
+     * Seeds and windows with an ambiguous base are not encoded, since they can not be matched exactly.
+     */
+    template <std::ranges::random_access_range needle_list_t>
+    class qgram_seed_table
+    {
+    private:
+        using code_t = uint64_t;
+
+        struct slot_t
+        {
+            code_t code{};
+            uint32_t first{}; //!< The index of the first seed with this code.
+            uint32_t count{}; //!< The number of seeds with this code; 0 for empty slots.
+        };
+
+        struct window_hit_t
+        {
+            std::ptrdiff_t begin_position{};
+            uint32_t seed_index{};
+        };
+
+        static constexpr uint8_t _invalid_code = 4;
+        static constexpr size_t _max_code_size = 32;
+        static constexpr size_t _prefetch_distance = 16;
+
+        needle_list_t const & _needle_list;
+        std::vector<slot_t> _slots{};
+        std::vector<seed_hit> _seeds{};
+        size_t _seed_size{};
+        size_t _code_size{};
+        int _shift{};
+
+        mutable std::vector<code_t> _window_codes{};
+        mutable std::vector<uint8_t> _window_valid{};
+        mutable std::vector<size_t> _window_slots{};
+        mutable std::vector<window_hit_t> _window_hits{};
+
+    public:
+
+        qgram_seed_table() = delete;
+        qgram_seed_table(needle_list_t const & needle_list, double const error_rate) : _needle_list{needle_list}
+        {
+            if (std::ranges::empty(_needle_list))
+                return;
+
+            _seed_size = std::numeric_limits<size_t>::max();
+            for (auto && needle : _needle_list) {
+                size_t const needle_size = std::ranges::size(needle);
+                _seed_size = std::min(_seed_size, needle_size / (error_count(needle_size, error_rate) + 1));
+            }
+
+            if (_seed_size == 0)
+                return;
+
+            _code_size = std::min(_seed_size, _max_code_size);
+            build(error_rate);
+        }
+
+        //!\brief The length of the seeds.
+        size_t window_size() const noexcept
+        {
+            return _seed_size;
+        }
+
+        /*!\brief Reports every exact occurrence of a seed in the haystack.
+         *
+         * \param[in] haystack The sequence to search.
+         * \param[in] callback The callback invoked with the jstmap::seed_finder and the jstmap::seed_hit of each occurrence.
+         */
+        template <std::ranges::random_access_range haystack_t, typename callback_t>
+        void operator()(haystack_t && haystack, callback_t && callback) const
+        {
+            std::ptrdiff_t const haystack_size = std::ranges::ssize(haystack);
+            if (_seeds.empty() || haystack_size < static_cast<std::ptrdiff_t>(_seed_size))
+                return;
+
+            auto haystack_begin = std::ranges::begin(haystack);
+            std::ptrdiff_t const window_count = haystack_size - _code_size + 1;
+
+            // Pass 1: the rolling codes of all windows; windows with an ambiguous base get an invalid code.
+            code_t const mask = (_code_size == _max_code_size) ? ~code_t{0} : (code_t{1} << (2 * _code_size)) - 1;
+            _window_codes.resize(window_count);
+            _window_valid.assign(window_count, false);
+            code_t code{};
+            size_t valid_count{};
+            for (std::ptrdiff_t position = 0; position < haystack_size; ++position) {
+                uint8_t symbol_code = to_code(haystack_begin[position]);
+                valid_count = (symbol_code == _invalid_code) ? 0 : valid_count + 1;
+                code = ((code << 2) | (symbol_code & 0b11)) & mask;
+                std::ptrdiff_t begin_position = position + 1 - _code_size;
+                if (begin_position >= 0) {
+                    _window_codes[begin_position] = code;
+                    _window_valid[begin_position] = valid_count >= _code_size;
+                }
+            }
+
+            // Pass 2: hash all codes independent of each other.
+            _window_slots.resize(window_count);
+            for (std::ptrdiff_t window = 0; window < window_count; ++window)
+                _window_slots[window] = hash(_window_codes[window]);
+
+            // Pass 3: prefetch the slots of the upcoming windows, probe the table and collect the hits.
+            _window_hits.clear();
+            for (std::ptrdiff_t window = 0; window < window_count; ++window) {
+                if (window + _prefetch_distance < static_cast<size_t>(window_count))
+                    __builtin_prefetch(_slots.data() + _window_slots[window + _prefetch_distance]);
+
+                if (!_window_valid[window] || window + _seed_size > static_cast<size_t>(haystack_size))
+                    continue;
+
+                slot_t const * slot = find(_window_codes[window], _window_slots[window]);
+                if (slot == nullptr)
+                    continue;
+
+                for (uint32_t seed_index = slot->first; seed_index < slot->first + slot->count; ++seed_index)
+                    _window_hits.push_back(window_hit_t{.begin_position = window, .seed_index = seed_index});
+            }
+
+            // Verify the bases behind the encoded prefix and report the hits.
+            for (window_hit_t const & hit : _window_hits) {
+                seed_hit const & seed = _seeds[hit.seed_index];
+                if (_seed_size > _code_size) {
+                    auto && needle = _needle_list[seed.index];
+                    auto needle_it = std::ranges::next(std::ranges::begin(needle), seed.offset + _code_size);
+                    auto haystack_it = std::ranges::next(haystack_begin, hit.begin_position + _code_size);
+                    if (!std::ranges::equal(needle_it, needle_it + (_seed_size - _code_size),
+                                            haystack_it, haystack_it + (_seed_size - _code_size)))
+                        continue;
+                }
+                callback(seed_finder{.begin_position = hit.begin_position,
+                                     .end_position = hit.begin_position + static_cast<std::ptrdiff_t>(_seed_size)},
+                         seed);
+            }
+        }
+
+    private:
+
+        static size_t error_count(size_t const needle_size, double const error_rate) noexcept
+        {
+            return static_cast<size_t>(std::floor(needle_size * error_rate));
+        }
+
+        void build(double const error_rate)
+        {
+            std::vector<std::pair<code_t, seed_hit>> coded_seeds{};
+            for (uint32_t needle_idx = 0; needle_idx < std::ranges::size(_needle_list); ++needle_idx) {
+                auto && needle = _needle_list[needle_idx];
+                size_t const seed_count = error_count(std::ranges::size(needle), error_rate) + 1;
+                for (size_t seed_idx = 0; seed_idx < seed_count; ++seed_idx) {
+                    uint32_t const offset = seed_idx * _seed_size;
+                    auto seed_begin = std::ranges::next(std::ranges::begin(needle), offset);
+                    if (auto code = encode(std::ranges::subrange{seed_begin, seed_begin + _code_size}); code.has_value())
+                        coded_seeds.emplace_back(*code, seed_hit{.index = needle_idx,
+                                                                 .offset = offset,
+                                                                 .count = static_cast<uint32_t>(_seed_size)});
+                }
+            }
+
+            std::ranges::sort(coded_seeds, [] (auto const & lhs, auto const & rhs) {
+                return std::tie(lhs.first, lhs.second.index, lhs.second.offset) <
+                       std::tie(rhs.first, rhs.second.index, rhs.second.offset);
+            });
+
+            // Allocate at least twice as many slots as seeds to keep the probe sequences short.
+            size_t const slot_count = std::bit_ceil(std::max<size_t>(16, coded_seeds.size() * 2));
+            _shift = 64 - std::countr_zero(slot_count);
+            _slots.assign(slot_count, slot_t{});
+            _seeds.reserve(coded_seeds.size());
+
+            size_t slot_idx{};
+            for (size_t idx = 0; idx < coded_seeds.size(); ++idx) {
+                auto const & [code, seed] = coded_seeds[idx];
+                if (idx == 0 || coded_seeds[idx - 1].first != code) {
+                    slot_idx = hash(code);
+                    while (_slots[slot_idx].count != 0)
+                        slot_idx = (slot_idx + 1) & (slot_count - 1);
+                    _slots[slot_idx] = slot_t{.code = code, .first = static_cast<uint32_t>(_seeds.size()), .count = 0};
+                }
+                ++_slots[slot_idx].count;
+                _seeds.push_back(seed);
+            }
+        }
+
+        slot_t const * find(code_t const code, size_t slot_idx) const noexcept
+        {
+            while (_slots[slot_idx].count != 0) {
+                if (_slots[slot_idx].code == code)
+                    return &_slots[slot_idx];
+                slot_idx = (slot_idx + 1) & (_slots.size() - 1);
+            }
+            return nullptr;
+        }
+
+        size_t hash(code_t const code) const noexcept
+        {
+            // Fibonacci hashing spreads neighbouring codes over the complete table.
+            return (code * 0x9E3779B97F4A7C15ull) >> _shift;
+        }
+
+        template <typename symbol_t>
+        static constexpr uint8_t to_code(symbol_t const & symbol) noexcept
+        {
+            switch (seqan3::to_char(symbol))
+            {
+                case 'A': return 0;
+                case 'C': return 1;
+                case 'G': return 2;
+                case 'T': return 3;
+                default: return _invalid_code;
+            }
+        }
+
+        template <typename qgram_t>
+        static constexpr std::optional<code_t> encode(qgram_t && qgram) noexcept
+        {
+            code_t code{};
+            for (auto && symbol : qgram) {
+                uint8_t symbol_code = to_code(symbol);
+                if (symbol_code == _invalid_code)
+                    return std::nullopt;
+                code = (code << 2) | symbol_code;
+            }
+            return code;
+        }
+    };
+}  // namespace jstmap
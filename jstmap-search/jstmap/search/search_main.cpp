@@ -15,6 +15,10 @@
 #include <filesystem>
 #include <functional>
 #include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
 #include <omp.h>
 
 #include <seqan3/argument_parser/argument_parser.hpp>
@@ -29,12 +33,20 @@
 #include <jstmap/global/all_matches.hpp>
 #include <jstmap/global/application_logger.hpp>
 #include <jstmap/global/bam_writer.hpp>
+#include <jstmap/global/compact_match_position.hpp>
+#include <jstmap/global/hit_collector.hpp>
 #include <jstmap/global/jstmap_types.hpp>
 #include <jstmap/global/load_jst.hpp>
+#include <jstmap/global/mapping_summary.hpp>
 #include <jstmap/global/search_matches.hpp>
+#include <jstmap/global/topology_cache.hpp>
+#include <jstmap/search/collapse_queries.hpp>
 #include <jstmap/search/filter_queries.hpp>
+#include <jstmap/search/interleaved_task.hpp>
 #include <jstmap/search/match_aligner.hpp>
+#include <jstmap/search/mate_rescuer.hpp>
 #include <jstmap/search/load_queries.hpp>
+#include <jstmap/search/order_queries.hpp>
 #include <jstmap/search/search_main.hpp>
 #include <jstmap/search/bucket_searcher.hpp>
 #include <jstmap/search/bucket.hpp>
@@ -44,6 +56,14 @@
 namespace jstmap
 {
 
+//!\brief A mate rescued behind a match of its read.
+struct rescued_mate
+{
+    match_position position{}; //!< The match position of the mate.
+    size_t anchor{}; //!< The index of the read match the mate was rescued from.
+    int32_t template_length{}; //!< The distance from the begin of the read match to the end of the mate.
+};
+
 int search_main(seqan3::argument_parser & search_parser)
 {
     search_options options{};
@@ -76,6 +96,13 @@ int search_main(seqan3::argument_parser & search_parser)
                              "The prebuilt index to speedup the search.",
                              seqan3::option_spec::standard,
                              seqan3::input_file_validator{{"ibf"}});
+    search_parser.add_option(options.topology_cache_file_path,
+                             '\0',
+                             "topology-cache",
+                             "The filter tree topology precomputed by the index command. Used if the jst, the bin size "
+                             "and the seed size of the reads match the cache.",
+                             seqan3::option_spec::standard,
+                             seqan3::input_file_validator{{"topo"}});
     search_parser.add_option(options.error_rate,
                              'e',
                              "error-rate",
@@ -88,6 +115,51 @@ int search_main(seqan3::argument_parser & search_parser)
                              "The number of threads to use for the search.",
                              seqan3::option_spec::standard,
                              seqan3::arithmetic_range_validator{1u, std::thread::hardware_concurrency()});
+    search_parser.add_option(options.interleave_count,
+                             '\0',
+                             "interleave-count",
+                             "The number of buckets every thread searches interleaved to hide the memory latency of "
+                             "the tree traversal.",
+                             seqan3::option_spec::advanced,
+                             seqan3::arithmetic_range_validator{1u, 64u});
+    search_parser.add_flag(options.best_only,
+                           '\0',
+                           "best-only",
+                           "Reports only the hits of a read with the fewest errors.",
+                           seqan3::option_spec::standard);
+    search_parser.add_option(options.mate_input_file_path,
+                             '\0',
+                             "mate",
+                             "The file with the mates of the reads in the same order. Only the reads are mapped, while "
+                             "their mates are rescued within the insert size window behind every match of the read. "
+                             "A mate in front of its read is not rescued and written as unmapped record, and a pair "
+                             "whose read has no hit is not written at all.",
+                             seqan3::option_spec::standard,
+                             seqan3::input_file_validator{{"fa", "fasta"}});
+    search_parser.add_option(options.max_insert_size,
+                             '\0',
+                             "max-insert-size",
+                             "The maximal distance between the begin of a read and the end of its mate.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{1u, 1000000u});
+    search_parser.add_option(options.alignment,
+                             '\0',
+                             "alignment",
+                             "The alignment of the matches: affine computes the global alignment with affine gap costs, "
+                             "edit only computes the edit distance and the unit cost CIGAR, which is considerably faster.",
+                             seqan3::option_spec::standard);
+    search_parser.add_flag(options.sort_output,
+                           '\0',
+                           "sort",
+                           "Writes the records sorted by their position instead of the order of the reads.",
+                           seqan3::option_spec::standard);
+    search_parser.add_option(options.max_memory,
+                             '\0',
+                             "max-memory",
+                             "The memory in MiB of the records buffered for the sorted output. Larger outputs are "
+                             "sorted in runs on the disk, which are merged at the end.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{1u, 1048576u});
 
     try
     {
@@ -100,10 +172,17 @@ int search_main(seqan3::argument_parser & search_parser)
 
         log_debug("References file:", options.jst_input_file_path.string());
         log_debug("Query file:", options.query_input_file_path.string());
+        log_debug("Mate file:", options.mate_input_file_path.string());
+        log_debug("Max insert size:", options.max_insert_size);
         log_debug("Output file:", options.map_output_file_path.string());
         log_debug("Index file:", options.index_input_file_path.string());
         log_debug("Error rate:", options.error_rate);
         log_debug("Thread count:", options.thread_count);
+        log_debug("Interleave count:", options.interleave_count);
+        log_debug("Best only:", options.best_only);
+        log_debug("Alignment mode:", (options.alignment == alignment_mode::edit) ? "edit" : "affine");
+        log_debug("Sort output:", options.sort_output);
+        log_debug("Max memory:", options.max_memory, "MiB");
     }
     catch (seqan3::argument_parser_error const & ex)
     {
@@ -125,27 +204,38 @@ int search_main(seqan3::argument_parser & search_parser)
                         return search_query{query_idx++, std::move(record)};
                      })
                      | seqan3::ranges::to<std::vector>();
+
+        // The mates are searched on the opposite strand of their reads.
+        std::vector<std::string> mate_ids{};
+        std::vector<record_sequence_t> mate_sequences{};
+        if (!options.mate_input_file_path.empty()) {
+            using namespace std::literals;
+
+            std::vector mate_records = load_queries(options.mate_input_file_path);
+            if (mate_records.size() != queries.size())
+                throw std::runtime_error{"The mate file contains "s + std::to_string(mate_records.size()) +
+                                         " reads, but the read file contains "s + std::to_string(queries.size())};
+
+            mate_ids.reserve(mate_records.size());
+            mate_sequences.reserve(mate_records.size());
+            for (sequence_record_t & mate_record : mate_records) {
+                mate_ids.push_back(std::move(mate_record.id()));
+                mate_sequences.push_back(reverse_complement(mate_record.sequence()));
+            }
+        }
+        bool const is_paired = !mate_sequences.empty();
         auto end = std::chrono::high_resolution_clock::now();
         log_debug("Read count", queries.size());
         log_debug("Loading time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
 
-        log_debug("Load reference database");
-        start = std::chrono::high_resolution_clock::now();
-        rcs_store_t rcs_store = load_jst(options.jst_input_file_path);
-        // For debug purposes!
-
-        // rcs_store_t rcs_store{reference_t{rcs_store_tmp.source().begin(), rcs_store_tmp.source().end()}, rcs_store_tmp.size()};
-        // auto it_end = rcs_store_tmp.variants().end() - 1;
-        // auto it = it_end - 1;
-        // for (; it != it_end; ++it) {
-        //     rcs_store.add(*it);
-        // }
-
-        end = std::chrono::high_resolution_clock::now();
-        log_info("Loading time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
-
-        // Now we want to handle the bins as well.
+        // Identical reads are searched only once and their matches are assigned to every copy afterwards.
+        std::vector<std::string> read_ids{};
+        read_ids.reserve(queries.size());
+        std::ranges::for_each(queries, [&] (search_query const & query) { read_ids.push_back(query.value().id()); });
+        collapsed_queries collapsed = collapse_queries(std::move(queries));
+        log_info("Distinct read count: ", collapsed.queries.size());
 
+        // Filter the queries first, such that only the chunks with candidate queries need to be loaded.
         start = std::chrono::high_resolution_clock::now();
         size_t bin_size{std::numeric_limits<size_t>::max()};
         std::vector<search_queries_type> search_queries{};
@@ -154,26 +244,51 @@ int search_main(seqan3::argument_parser & search_parser)
         {
             log_debug("No prefilter enabled");
             search_queries.resize(1);
-            search_queries[0] = queries;
+            search_queries[0] = collapsed.queries;
         }
         else
         {
             log_debug("Applying IBF prefilter");
-            std::tie(bin_size, search_queries) = filter_queries(queries, options);
+            std::tie(bin_size, search_queries) = filter_queries(collapsed.queries, options);
             log_debug("Bin size:", bin_size);
             log_debug("Bucket count:", search_queries.size());
-            // auto bucket_sizes = bucket_list | std::views::transform([](auto const & bucket) {
-            //     return std::ranges::size(bucket);
-            // });
-            // auto non_empty_buckets = bucket_sizes | std::views::filter([](size_t const s) { return s > 0;});
-            // log_debug("Non-empty bucket count:", std::ranges::distance(non_empty_buckets.begin(), non_empty_buckets.end()));
-            // size_t candidates = std::accumulate(bucket_sizes.begin(), bucket_sizes.end(), 0);
-            // log_debug("Candidate count:", candidates);
-            // log_debug("Bucket sizes:", bucket_sizes);
         }
+
+        // Neighbouring needles share their minimiser to improve the memory locality of the seeding.
+        #pragma omp parallel for num_threads(options.thread_count) shared(search_queries) schedule(dynamic)
+        for (size_t bin_idx = 0; bin_idx < search_queries.size(); ++bin_idx)
+            order_by_minimiser(search_queries[bin_idx]);
         end = std::chrono::high_resolution_clock::now();
         log_info("Filter time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
 
+        log_debug("Load reference database");
+        start = std::chrono::high_resolution_clock::now();
+        rcs_store_t rcs_store = [&] () {
+            // The topology cache was collected over the coverages of all variants.
+            if (options.index_input_file_path.empty() || !options.topology_cache_file_path.empty())
+                return load_jst(options.jst_input_file_path);
+
+            // Only the chunks of non-empty buckets are loaded, extended by the longest query reaching into the next chunk.
+            size_t max_query_size{};
+            std::ranges::for_each(collapsed.queries, [&] (search_query const & query) {
+                max_query_size = std::max(max_query_size, std::ranges::size(query.value().sequence()));
+            });
+
+            // The mates are rescued in the insert size window behind the matches of their reads.
+            if (is_paired)
+                max_query_size = std::max<size_t>(max_query_size, options.max_insert_size);
+
+            std::vector<std::pair<uint64_t, uint64_t>> source_ranges{};
+            for (size_t bin_idx = 0; bin_idx < search_queries.size(); ++bin_idx)
+                if (!search_queries[bin_idx].empty())
+                    source_ranges.emplace_back(bin_idx * bin_size, (bin_idx + 1) * bin_size + max_query_size);
+
+            log_debug("Non-empty bucket count:", source_ranges.size());
+            return load_jst(options.jst_input_file_path, source_ranges);
+        }();
+        end = std::chrono::high_resolution_clock::now();
+        log_info("Loading time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
+
         // #TODO: add later
         // std::cout << "bin_size = " << bin_size << "\n";
         // start = std::chrono::high_resolution_clock::now();
@@ -207,48 +322,85 @@ int search_main(seqan3::argument_parser & search_parser)
         //                    | seqan3::ranges::to<std::vector>();
 
 
-        using match_positions_t = std::vector<match_position>;
+        // The matches are buffered in their compact encoding by the hit collector of every thread.
+        using match_positions_t = hit_collector::match_positions_type;
         using bucket_matches_t = std::unordered_map<size_t, match_positions_t>;
-        using thread_local_bucket_matches_t = std::vector<bucket_matches_t>;
-        thread_local_bucket_matches_t thread_local_matches{};
-        thread_local_matches.resize(options.thread_count);
+        std::vector<hit_collector> thread_local_hits(options.thread_count, hit_collector{options.best_only});
 
         // now where do we get the chunk size from?
         auto chunked_rcms = rcs_store | libjst::chunk(bin_size);
 
+        topology_cache cache{};
+        if (!options.topology_cache_file_path.empty()) {
+            cache = topology_cache::load(options.topology_cache_file_path);
+            jst_fingerprint const jst = jst_fingerprint::read(jst_container_reader{options.jst_input_file_path});
+            if (!cache.is_compatible(jst, bin_size) ||
+                cache.chunk_count() != static_cast<size_t>(std::ranges::size(chunked_rcms))) {
+                log_warn("The topology cache does not match the jst and is ignored");
+                cache = topology_cache{};
+            }
+        }
+
         size_t bucket_counts{};
         std::ranges::for_each(search_queries, [&] (auto const & bucket) {
             bucket_counts += bucket.size();
         });
         log_info("Total bucket count: ", bucket_counts);
 
-        // parallelising this?
-        // go over the bins in dynamic fashion
-        #pragma omp parallel for num_threads(options.thread_count) shared(chunked_rcms, thread_local_matches, search_queries, options) schedule(dynamic)
-        for (std::ptrdiff_t bin_idx = 0; bin_idx < std::ranges::ssize(chunked_rcms); ++bin_idx)
+        auto make_bucket = [&] (size_t const bin_idx) {
+            return bucket{.base_tree = chunked_rcms[bin_idx],
+                          .needle_list = search_queries[bin_idx] | std::views::transform([] (search_query const & query) {
+                                return std::views::all(query.value().sequence());
+                          }),
+                          .cached_nodes = (cache.chunk_count() > 0) ? &cache.chunk(bin_idx) : nullptr,
+                          .cached_source = &rcs_store.source(),
+                          .cached_window_size = cache.window_size()};
+        };
+
+        auto make_callback = [&] (size_t const bin_idx, hit_collector & local_hits) {
+            return [&bucket_queries = search_queries[bin_idx], &local_hits]
+                   (std::ptrdiff_t query_idx, match_position const & position, uint32_t const error_count) {
+                local_hits.record(bucket_queries[query_idx].key(), position, error_count);
+            };
+        };
+
+        // Only the non-empty buckets are searched.
+        std::vector<size_t> bin_indices{};
+        size_t const bin_count = std::min<size_t>(search_queries.size(), std::ranges::size(chunked_rcms));
+        for (size_t bin_idx = 0; bin_idx < bin_count; ++bin_idx)
+            if (!search_queries[bin_idx].empty())
+                bin_indices.push_back(bin_idx);
+
+        // Every thread searches groups of buckets, whose traversals are interleaved if more than one bucket is grouped.
+        size_t const interleave_count = options.interleave_count;
+        std::ptrdiff_t const group_count = (bin_indices.size() + interleave_count - 1) / interleave_count;
+        #pragma omp parallel for num_threads(options.thread_count) shared(chunked_rcms, thread_local_hits, search_queries, options) schedule(dynamic)
+        for (std::ptrdiff_t group_idx = 0; group_idx < group_count; ++group_idx)
         { // parallel region
-            auto const & bucket_queries = search_queries[bin_idx];
-            if (bucket_queries.empty())
+            hit_collector & local_hits = thread_local_hits[omp_get_thread_num()];
+            size_t const group_begin = group_idx * interleave_count;
+            size_t const group_end = std::min(group_begin + interleave_count, bin_indices.size());
+
+            if (interleave_count == 1) {
+                size_t const bin_idx = bin_indices[group_begin];
+                log_debug("Local search in bucket: ", bin_idx);
+                bucket_searcher searcher{make_bucket(bin_idx), options.error_rate};
+                searcher(make_callback(bin_idx, local_hits));
                 continue;
+            }
 
-            bucket_matches_t & local_matches = thread_local_matches[omp_get_thread_num()];
-            // Step 1: distribute search:
-            log_debug("Local search in bucket: ", bin_idx);
-            bucket current_bucket{.base_tree = chunked_rcms[bin_idx],
-                                  .needle_list = bucket_queries | std::views::transform([] (search_query const & query) {
-                                        return std::views::all(query.value().sequence());
-                                   })};
-            // std::cout << "std::ranges::size(current_bucket.base_tree.data().source()) = " <<
-            //              std::ranges::size(current_bucket.base_tree.data().source()) << "\n";
-            // Step 4: apply matching
-            log_debug("Initiate searcher");
-            bucket_searcher searcher{std::move(current_bucket), options.error_rate};
-            // searcher([] () { std::cout << "Found match!\n"; });
-            // ATTENTION!!! Not thread safe!
-            searcher([&] (std::ptrdiff_t query_idx, match_position position) {
-                // log_debug("Record match for query ", query_idx, " at ", position);
-                local_matches[bucket_queries[query_idx].key()].push_back(std::move(position));
-            });
+            // The tasks refer to their searchers, which must not be relocated.
+            using searcher_t = decltype(bucket_searcher{make_bucket(0), options.error_rate});
+            std::vector<searcher_t> searchers{};
+            searchers.reserve(group_end - group_begin);
+            std::vector<interleaved_task> tasks{};
+            tasks.reserve(group_end - group_begin);
+            for (size_t idx = group_begin; idx < group_end; ++idx) {
+                log_debug("Local search in bucket: ", bin_indices[idx]);
+                searchers.emplace_back(make_bucket(bin_indices[idx]), options.error_rate);
+                tasks.push_back(searchers.back().interleaved(make_callback(bin_indices[idx], local_hits)));
+            }
+            run_interleaved(tasks);
         }
 
         end = std::chrono::high_resolution_clock::now();
@@ -257,22 +409,108 @@ int search_main(seqan3::argument_parser & search_parser)
         // Step 5: postprocess matches
         start = std::chrono::high_resolution_clock::now();
 
-        // std::vector<search_matches> aligned_matches_list{};
-        // aligned_matches_list.reserve(query_matches.size());
-        size_t match_count{};
-        std::ranges::for_each(thread_local_matches, [&] (bucket_matches_t const & _bucket_matches) {
-            for (auto const & match_positions : _bucket_matches) {
-                match_count += match_positions.second.size();
+        // The hits of a read found on several haplotype paths through the same locus count once for its strata.
+        std::unordered_map<size_t, mapping_summary> distinct_summaries = summarise_hits(thread_local_hits);
+
+        match_position_arena match_arena{};
+        bucket_matches_t distinct_matches{};
+        std::ranges::for_each(thread_local_hits, [&] (hit_collector const & local_hits) {
+            for (auto const & [distinct_key, hits] : local_hits.hits()) {
+                // A thread whose best hits are worse than the best hits of another thread holds no best hits.
+                if (options.best_only && hits.strata.best_error_count() > distinct_summaries[distinct_key].best_error_count())
+                    continue;
+
+                match_positions_t & target = distinct_matches[distinct_key];
+                for (compact_match_position const & position : hits.positions)
+                    target.push_back(match_arena.adopt(position, local_hits.arena()));
             }
         });
-            // search_matches aligned_matches{std::move(query_match).query()};
-            // match_aligner aligner{rcs_store, aligned_matches.query().value().sequence()};
 
-            // for (match_position pos : query_match.matches()) {
-            //     aligned_matches.record_match(aligner(std::move(pos)));
-            // }
-            // aligned_matches_list.push_back(std::move(aligned_matches));
+        // The distinct query of every read.
+        std::vector<size_t> distinct_keys(read_ids.size());
+        for (size_t distinct_key = 0; distinct_key < collapsed.original_keys.size(); ++distinct_key)
+            for (size_t key : collapsed.original_keys[distinct_key])
+                distinct_keys[key] = distinct_key;
+
+        // The mate of every read is rescued within the insert size window behind each match of the read.
+        std::vector<std::vector<rescued_mate>> rescued_mates(mate_sequences.size());
+        mate_rescuer const rescuer{rcs_store, options.error_rate, options.max_insert_size};
+        #pragma omp parallel for num_threads(options.thread_count) shared(rescued_mates, distinct_matches, mate_sequences) schedule(dynamic)
+        for (size_t key = 0; key < mate_sequences.size(); ++key) {
+            auto it = distinct_matches.find(distinct_keys[key]);
+            if (it == distinct_matches.end())
+                continue;
+
+            for (size_t anchor = 0; anchor < it->second.size(); ++anchor) {
+                auto record_rescue = [&] (match_position rescued_position, std::ptrdiff_t const template_length) {
+                    rescued_mates[key].push_back(rescued_mate{.position = std::move(rescued_position),
+                                                              .anchor = anchor,
+                                                              .template_length = static_cast<int32_t>(template_length)});
+                };
+                rescuer(mate_sequences[key], match_arena.decode(it->second[anchor]), record_rescue);
+            }
+        }
+
+        // The matches of all distinct queries followed by the rescued mates of all reads are numbered consecutively,
+        // where the matches of a distinct query and the rescues of a read begin at their offsets. The number of a match
+        // is the identifier of its alignment job, such that its alignment is stored at the index of its match position
+        // or rescue independent of the order in which the queues align their jobs.
+        std::vector<size_t> matched_keys{};
+        matched_keys.reserve(distinct_matches.size());
+        size_t match_count{};
+        std::vector<size_t> match_begins(collapsed.queries.size() + 1);
+        for (auto const & [distinct_key, match_positions] : distinct_matches) {
+            matched_keys.push_back(distinct_key);
+            match_begins[distinct_key + 1] = match_positions.size();
+            match_count += match_positions.size() * collapsed.multiplicity(distinct_key);
+        }
+        std::partial_sum(match_begins.begin(), match_begins.end(), match_begins.begin());
+
+        size_t const mate_offset = match_begins.back();
+        std::vector<size_t> rescue_begins(rescued_mates.size() + 1);
+        for (size_t key = 0; key < rescued_mates.size(); ++key)
+            rescue_begins[key + 1] = rescue_begins[key] + rescued_mates[key].size();
+        size_t const rescued_count = rescue_begins.back();
+        match_count += rescued_count;
+
+        // The reference trees are shared by all threads; every thread aligns its distinct queries in its own queue,
+        // which is aligned in batches whenever it is full.
+        std::vector<search_match> aligned_matches(mate_offset + rescued_count);
+        match_aligner aligner{rcs_store, options.error_rate, options.alignment};
+        #pragma omp parallel num_threads(options.thread_count) shared(aligner, aligned_matches, distinct_matches, matched_keys, rescued_mates)
+        {
+            match_alignment_queue queue{aligner};
+            auto record_alignment = [&] (size_t const id, search_match match) {
+                aligned_matches[id] = std::move(match);
+            };
+
+            #pragma omp for schedule(dynamic)
+            for (size_t idx = 0; idx < matched_keys.size(); ++idx) {
+                size_t const distinct_key = matched_keys[idx];
+                match_positions_t const & match_positions = distinct_matches.at(distinct_key);
+                for (size_t anchor = 0; anchor < match_positions.size(); ++anchor) {
+                    queue.add(collapsed.queries[distinct_key].value().sequence(),
+                              match_arena.decode(match_positions[anchor]),
+                              match_begins[distinct_key] + anchor);
+                    if (queue.size() >= match_alignment_queue::default_batch_size)
+                        queue.align(record_alignment);
+                }
+            }
+
+            #pragma omp for schedule(dynamic)
+            for (size_t key = 0; key < rescued_mates.size(); ++key) {
+                for (size_t rescue = 0; rescue < rescued_mates[key].size(); ++rescue) {
+                    queue.add(mate_sequences[key], rescued_mates[key][rescue].position,
+                              mate_offset + rescue_begins[key] + rescue);
+                    if (queue.size() >= match_alignment_queue::default_batch_size)
+                        queue.align(record_alignment);
+                }
+            }
+            queue.align(record_alignment);
+        }
         std::cout << "match_count: " << match_count << "\n";
+        if (is_paired)
+            log_info("Rescued mate count: ", rescued_count);
 
         end = std::chrono::high_resolution_clock::now();
         log_info("Aligning time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
@@ -281,10 +519,81 @@ int search_main(seqan3::argument_parser & search_parser)
 
         // Step 6: finalise
         start = std::chrono::high_resolution_clock::now();
-        // bam_writer writer{rcs_store, options.map_output_file_path};
-        // std::ranges::for_each(aligned_matches_list, [&] (search_matches const & matches) {
-        //     writer.write_matches(matches);
-        // });
+        // The matches of a distinct query are written for every read sharing its sequence in the order of the reads.
+        // The mate of a read is written behind it on the reverse strand. The primary records of a read and its mate
+        // point to each other and get the template length if the primary mate was rescued behind the primary read.
+        // A mate that was not rescued is written as unmapped record at the position of its read.
+        // PNEXT only holds the variant index of the mate, whose complete tree position is stored in the mate tags.
+        seqan3::sam_flag const read_flag = is_paired ? (seqan3::sam_flag::paired |
+                                                        seqan3::sam_flag::first_in_pair |
+                                                        seqan3::sam_flag::mate_on_reverse_strand)
+                                                     : seqan3::sam_flag::none;
+        seqan3::sam_flag const mate_flag = seqan3::sam_flag::paired |
+                                           seqan3::sam_flag::second_in_pair |
+                                           seqan3::sam_flag::on_reverse_strand;
+
+        std::optional<sort_configuration> sorting{};
+        if (options.sort_output)
+            sorting = sort_configuration{.max_memory = options.max_memory << 20, .thread_count = options.thread_count};
+
+        auto alignments_in = [&] (size_t const first, size_t const last) {
+            return std::span<search_match const>{aligned_matches}.subspan(first, last - first);
+        };
+
+        bam_writer writer{rcs_store, options.map_output_file_path, sorting};
+        for (size_t key = 0; key < read_ids.size(); ++key) {
+            std::span<search_match const> const query_alignments = alignments_in(match_begins[distinct_keys[key]],
+                                                                                 match_begins[distinct_keys[key] + 1]);
+            if (query_alignments.empty())
+                continue;
+
+            sequence_record_t record{};
+            record.id() = read_ids[key];
+            record.sequence() = collapsed.queries[distinct_keys[key]].value().sequence();
+            search_matches query_matches{search_query{key, std::move(record)}};
+            std::ranges::for_each(query_alignments, [&] (search_match const & match) { query_matches.record_match(match); });
+            uint8_t const mapping_quality = distinct_summaries[distinct_keys[key]].mapping_quality();
+
+            if (!is_paired) {
+                writer.write_matches(query_matches, read_flag, mapping_quality);
+                continue;
+            }
+
+            size_t const read_primary = bam_writer::primary_index(query_alignments);
+            match_position const & read_position = query_alignments[read_primary].position();
+            size_t const read_size = std::ranges::size(collapsed.queries[distinct_keys[key]].value().sequence());
+            sequence_record_t mate_record{};
+            mate_record.id() = mate_ids[key];
+            mate_record.sequence() = mate_sequences[key];
+            search_query mate_query{key, std::move(mate_record)};
+
+            std::span<search_match const> const mate_alignments = alignments_in(mate_offset + rescue_begins[key],
+                                                                                mate_offset + rescue_begins[key + 1]);
+            if (mate_alignments.empty()) {
+                bam_writer::mate_info const unmapped_mate{.tree_position = read_position, .sequence_size = read_size};
+                writer.write_matches(query_matches, read_flag | seqan3::sam_flag::mate_unmapped, mapping_quality,
+                                     unmapped_mate);
+                writer.write_unmapped(mate_query, mate_flag, unmapped_mate);
+                continue;
+            }
+
+            size_t const mate_primary = bam_writer::primary_index(mate_alignments);
+            rescued_mate const & primary_rescue = rescued_mates[key][mate_primary];
+            int32_t const template_length = (primary_rescue.anchor == read_primary) ? primary_rescue.template_length : 0;
+            match_position const & mate_position = mate_alignments[mate_primary].position();
+            writer.write_matches(query_matches, read_flag, mapping_quality,
+                                 bam_writer::mate_info{.tree_position = mate_position,
+                                                       .template_length = template_length,
+                                                       .sequence_size = std::ranges::size(mate_sequences[key])});
+
+            search_matches mate_matches{std::move(mate_query)};
+            std::ranges::for_each(mate_alignments, [&] (search_match const & match) { mate_matches.record_match(match); });
+            writer.write_matches(mate_matches, mate_flag, bam_writer::unknown_mapping_quality,
+                                 bam_writer::mate_info{.tree_position = read_position,
+                                                       .template_length = -template_length,
+                                                       .sequence_size = read_size});
+        }
+        writer.finish();
         end = std::chrono::high_resolution_clock::now();
         log_info("Writing time:", std::chrono::duration_cast<std::chrono::seconds>(end - start).count(), "s");
     }
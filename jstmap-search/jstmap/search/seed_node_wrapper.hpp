@@ -12,51 +12,93 @@
 
 #pragma once
 
+#include <cassert>
 #include <functional>
+#include <limits>
 
 #include <jstmap/global/match_position.hpp>
+#include <jstmap/search/state_stack_pool.hpp>
 
 namespace jstmap
 {
+    /*!\brief Saves and restores the state of an extender while the extension tree is traversed.
+     *
+     * \details
+     *
+     * The states are kept in the thread local jstmap::state_stack_pool, which is reused by all extensions of the same
+     * extender type. A push only copies the best match of the current path. The state of the extender is copied
+     * once the extender is about to modify it on the new branch, i.e. on the first call to save_state after the push.
+     * A branch that is left before the extender was invoked does not need to be restored.
+     */
     template <typename extender_t>
     class extension_state_manager {
     private:
 
         using best_path_match_t = std::pair<match_position, int32_t>;
         using matcher_state_t = spm::matcher_state_t<extender_t>;
-        using state_t = std::pair<matcher_state_t, best_path_match_t>;
-        using state_stack_t = std::stack<state_t>;
 
+        struct frame_t
+        {
+            matcher_state_t state{};
+            best_path_match_t best_match{};
+            bool is_saved{};
+        };
+
+        using state_stack_t = state_stack_pool<frame_t>;
 
         extender_t & _extender;
-        state_stack_t _states{};
+        state_stack_t & _states;
+        size_t _base_size{};
 
     public:
 
-        constexpr explicit extension_state_manager(extender_t & extender) noexcept :
+        constexpr explicit extension_state_manager(extender_t & extender) :
             _extender{extender},
-            _states{}
+            _states{thread_local_state_stack_pool<frame_t>()},
+            _base_size{_states.size()}
+        {
+            frame_t & root = _states.push();
+            root.best_match = best_path_match_t{match_position{}, std::numeric_limits<int32_t>::lowest()};
+            root.is_saved = true; // The root state is never restored.
+        }
+
+        extension_state_manager(extension_state_manager const &) = delete;
+        extension_state_manager & operator=(extension_state_manager const &) = delete;
+
+        ~extension_state_manager()
         {
-            _states.emplace(matcher_state_t{},
-                            best_path_match_t{match_position{}, std::numeric_limits<int32_t>::lowest()});
+            _states.shrink(_base_size);
         }
 
         constexpr void notify_push() {
-            _states.emplace(_extender.capture(), _states.top().second);
+            best_path_match_t best_match = _states.top().best_match;
+            frame_t & frame = _states.push();
+            frame.best_match = std::move(best_match);
+            frame.is_saved = false;
         }
 
         constexpr void notify_pop() {
-            assert(!_states.empty());
-            _extender.restore(_states.top().first);
+            assert(_states.size() > _base_size + 1);
+            if (frame_t const & frame = _states.top(); frame.is_saved)
+                _extender.restore(frame.state);
             _states.pop();
         }
 
-        constexpr state_t & top() noexcept {
-            return _states.top();
+        //!\brief Saves the state of the extender for the current branch before it is modified for the first time.
+        constexpr void save_state() {
+            if (frame_t & frame = _states.top(); !frame.is_saved) {
+                frame.state = _extender.capture();
+                frame.is_saved = true;
+            }
+        }
+
+        //!\brief The best match found on the current path.
+        constexpr best_path_match_t & best_match() noexcept {
+            return _states.top().best_match;
         }
 
-        constexpr state_t const & top() const noexcept {
-            return _states.top();
+        constexpr best_path_match_t const & best_match() const noexcept {
+            return _states.top().best_match;
         }
 
         // constexpr void print_state() const noexcept {
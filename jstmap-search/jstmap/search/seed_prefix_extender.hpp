@@ -79,7 +79,7 @@ namespace jstmap
 
             // now reverse position!
             std::ptrdiff_t distance_to_end = std::ranges::ssize(seed_cargo.sequence()) - (beginPosition(seed_finder) - 1);
-            std::ptrdiff_t global_start_offset = std::ranges::ssize(seed_cargo.path_sequence()) - distance_to_end;
+            std::ptrdiff_t global_start_offset = path_size(seed_cargo) - distance_to_end;
             auto breakend_it = std::ranges::next(_base_tree.data().variants().begin(), prefix_position.get_variant_index());
             // TODO: what if breakend it high deletion breakend or low deletion breakend?
             // std::ptrdiff_t variant_position = libjst::position(*breakend_it);
@@ -207,11 +207,14 @@ namespace jstmap
             // size_t counter{};
             for (auto cargo : prefix_traverser) {
                 seed_prefix_node_cargo prefix_cargo{std::move(cargo), _reverse_tree};
+                if (!std::ranges::empty(prefix_cargo.sequence())) // The extender keeps its state on empty labels.
+                    manager.save_state();
+
                 extender(prefix_cargo.sequence(), [&] (auto const & prefix_finder) {
                     // ++counter;
-                    auto [best_position, best_score] = manager.top().second;
+                    auto [best_position, best_score] = manager.best_match();
                     if (int32_t score = getScore(extender.capture()); score > best_score) {
-                        manager.top().second =
+                        manager.best_match() =
                             std::pair{match_position{.tree_position = prefix_cargo.position(),
                                                      .label_offset = reference_size -
                                                         to_path_position(endPosition(prefix_finder), prefix_cargo)},
@@ -219,7 +222,7 @@ namespace jstmap
                     }
                 });
                 if (cargo.is_leaf()) {
-                    auto [best_position, best_score] = manager.top().second;
+                    auto [best_position, best_score] = manager.best_match();
                     if (-best_score <= static_cast<decltype(best_score)>(_error_count))
                         callback(std::move(best_position), -best_score);
                 }
@@ -229,7 +232,7 @@ namespace jstmap
     private:
         template <typename position_t, typename cargo_t>
         constexpr auto to_path_position(position_t local_position, cargo_t const & cargo) const noexcept {
-            return std::ranges::ssize(cargo.path_sequence()) -
+            return path_size(cargo) -
                    (std::ranges::ssize(cargo.sequence()) - local_position);
         }
     };
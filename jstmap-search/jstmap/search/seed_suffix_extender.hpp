@@ -61,7 +61,7 @@ namespace jstmap
 
             std::ptrdiff_t distance_to_end = std::ranges::ssize(seed_cargo.sequence()) - endPosition(seed_finder);
             match_position start{.tree_position = seed_cargo.position(),
-                                 .label_offset = std::ranges::ssize(seed_cargo.path_sequence()) - distance_to_end};
+                                 .label_offset = path_size(seed_cargo) - distance_to_end};
             // log_info("Generate tree at: ", start);
 
             auto extend_tree = _base_tree | libjst::labelled()
@@ -76,16 +76,19 @@ namespace jstmap
             suffix_traverser.subscribe(manager);
             // size_t counter{};
             for (auto cargo : suffix_traverser) {
+                if (!std::ranges::empty(cargo.sequence())) // The extender keeps its state on empty labels.
+                    manager.save_state();
+
                 extender(cargo.sequence(), [&] (auto && suffix_finder) {
-                    auto [best_position, best_score] = manager.top().second;
+                    auto [best_position, best_score] = manager.best_match();
                     if (int32_t score = getScore(extender.capture()); score > best_score) {
-                        manager.top().second = std::pair{match_position{.tree_position = cargo.position(),
+                        manager.best_match() = std::pair{match_position{.tree_position = cargo.position(),
                                                                         .label_offset = endPosition(suffix_finder)},
                                                          score};
                     }
                 });
                 if (cargo.is_leaf()) {
-                    auto [best_position, best_score] = manager.top().second;
+                    auto [best_position, best_score] = manager.best_match();
                     if (-best_score <= static_cast<decltype(best_score)>(_error_count))
                         callback(std::move(best_position), -best_score);
                 }
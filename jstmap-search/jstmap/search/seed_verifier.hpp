@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <concepts>
+#include <cstdint>
 #include <ranges>
 
 #include <libjst/sequence_tree/seek_position.hpp>
@@ -25,6 +27,28 @@
 
 namespace jstmap
 {
+    namespace detail
+    {
+        /*!\brief Reports a verified hit together with its error count if the callback accepts it.
+         *
+         * \details
+         *
+         * Callbacks that only take the needle index and the match position are supported as well, such that callers
+         * not interested in the error count do not need to change.
+         */
+        template <typename callback_t>
+        constexpr void report_hit(callback_t && callback,
+                                  std::ptrdiff_t const needle_idx,
+                                  match_position position,
+                                  uint32_t const error_count)
+        {
+            if constexpr (std::invocable<callback_t &, std::ptrdiff_t, match_position, uint32_t>)
+                callback(needle_idx, std::move(position), error_count);
+            else
+                callback(needle_idx, std::move(position));
+        }
+    } // namespace detail
+
     template <typename bucket_t>
     class seed_verifier
     {
@@ -53,8 +77,7 @@ namespace jstmap
             std::ranges::subrange needle_suffix{std::ranges::next(std::ranges::begin(needle), suffix_start),
                                                 std::ranges::end(needle)};
             seed_suffix_extender suffix_extender{_bucket.base_tree, std::move(needle_suffix), max_errors};
-            suffix_extender(seed_cargo, seed_finder, [&] (match_position end_position,
-                                                          [[maybe_unused]] int32_t suffix_errors) {
+            suffix_extender(seed_cargo, seed_finder, [&] (match_position end_position, int32_t suffix_errors) {
                 assert(suffix_errors >= 0);
                 assert(static_cast<uint32_t>(suffix_errors) <= max_errors);
                 // log_debug("Found valid suffix at: ", end_position);
@@ -64,10 +87,11 @@ namespace jstmap
                                                     std::ranges::next(std::ranges::begin(needle), needle_hit.offset)};
                 seed_prefix_extender prefix_extender{_bucket.base_tree, std::move(needle_prefix), max_errors - suffix_errors};
                 prefix_extender(seed_cargo, seed_finder, [&] (match_position begin_position,
-                                                              [[maybe_unused]] int32_t total_errors){
+                                                              int32_t prefix_errors){
                     // log_debug("Extend prefix at: ", seed_cargo.position());
                     begin_position.tree_position = join(begin_position.tree_position, end_position.tree_position);
-                    callback(needle_hit.index, std::move(begin_position));
+                    detail::report_hit(callback, needle_hit.index, std::move(begin_position),
+                                       static_cast<uint32_t>(suffix_errors + prefix_errors));
                 });
             });
         }
@@ -0,0 +1,99 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides a flat stack reusing the storage of its popped elements.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace jstmap
+{
+    /*!\brief A stack storing its elements contiguously, which keeps popped elements for later pushes.
+     *
+     * \tparam state_t The type of the stored elements; must be default constructible and copy assignable.
+     *
+     * \details
+     *
+     * Popping an element only decrements the size of the stack. A later push returns the kept element, such that
+     * copy assigning a new state reuses the storage the element already owns. Once the stack reached its maximal depth,
+     * pushing and popping does not allocate memory anymore.
+     */
+    template <typename state_t>
+    class state_stack_pool
+    {
+    private:
+        std::vector<state_t> _slots{};
+        size_t _size{};
+
+    public:
+
+        state_stack_pool() = default;
+
+        size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        //!\brief Pushes an element and returns it; the element may still hold the value of a previously popped state.
+        state_t & push()
+        {
+            if (_size == _slots.size())
+                _slots.emplace_back();
+            return _slots[_size++];
+        }
+
+        void pop() noexcept
+        {
+            assert(!empty());
+            --_size;
+        }
+
+        state_t & top() noexcept
+        {
+            assert(!empty());
+            return _slots[_size - 1];
+        }
+
+        state_t const & top() const noexcept
+        {
+            assert(!empty());
+            return _slots[_size - 1];
+        }
+
+        //!\brief Pops all elements above the given size.
+        void shrink(size_t const size) noexcept
+        {
+            assert(size <= _size);
+            _size = size;
+        }
+    };
+
+    /*!\brief Returns the pool of the calling thread for the given state type.
+     *
+     * \details
+     *
+     * The pool is shared by all users of the same state type within a thread, which must push and pop their states in
+     * stack order, i.e. a nested user must release its states before the enclosing user continues.
+     */
+    template <typename state_t>
+    state_stack_pool<state_t> & thread_local_state_stack_pool() noexcept
+    {
+        static thread_local state_stack_pool<state_t> pool{};
+        return pool;
+    }
+}  // namespace jstmap
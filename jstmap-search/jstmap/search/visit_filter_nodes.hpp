@@ -0,0 +1,100 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the traversal of the filter tree nodes of a bucket.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include <libjst/traversal/tree_traverser_base.hpp>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/topology_cache.hpp>
+#include <jstmap/search/interleaved_task.hpp>
+
+namespace jstmap
+{
+    /*!\brief Requests the first cache lines of the label of a node.
+     *
+     * \param[in] cargo The cargo of the node.
+     *
+     * \details
+     *
+     * Only labels that are contiguous in memory or whose first symbol is an lvalue can be prefetched; for all other
+     * labels this function does nothing.
+     */
+    template <typename cargo_t>
+    void prefetch_label(cargo_t const & cargo) noexcept
+    {
+        auto && label = cargo.sequence();
+        using label_t = decltype(label);
+
+        if (std::ranges::empty(label))
+            return;
+
+        if constexpr (std::ranges::contiguous_range<label_t>) {
+            constexpr std::ptrdiff_t cache_line_size = 64;
+            constexpr std::ptrdiff_t max_prefetch_size = 4 * cache_line_size;
+            char const * label_data = reinterpret_cast<char const *>(std::ranges::data(label));
+            std::ptrdiff_t const label_size = std::ranges::ssize(label) * sizeof(std::ranges::range_value_t<label_t>);
+            for (std::ptrdiff_t offset = 0; offset < std::min(label_size, max_prefetch_size); offset += cache_line_size)
+                __builtin_prefetch(label_data + offset);
+        } else if constexpr (std::is_lvalue_reference_v<std::ranges::range_reference_t<label_t>>) {
+            __builtin_prefetch(std::addressof(*std::ranges::begin(label)));
+        }
+    }
+
+    /*!\brief Visits the nodes of a filter tree in a resumable task.
+     *
+     * \param[in] filter_tree The filter tree to traverse; stored in the task.
+     * \param[in] cached_nodes The precomputed nodes of the filter tree; the complete tree is traversed if `nullptr`.
+     * \param[in] source The source the labels of the cached nodes refer to; must not be `nullptr` if nodes are cached.
+     * \param[in] visit_node The callable invoked with the cargo of every node; stored in the task.
+     * \param[in] interleave Whether the task suspends before visiting a node.
+     *
+     * \details
+     *
+     * The task moves to the next node and prefetches its label before it suspends at a jstmap::interleave_point.
+     * When several tasks are interleaved, the label is loaded while the other tasks visit their nodes.
+     * The cached nodes are replayed without building the filter tree. Their labels are slices of the source or of the
+     * labels stored with the nodes, and their cargo provides the size of the path sequence instead of the sequence,
+     * see jstmap::path_size. The cached nodes and the source must outlive the task.
+     */
+    template <typename filter_tree_t, typename node_visitor_t>
+    interleaved_task visit_filter_nodes(filter_tree_t filter_tree,
+                                        cached_chunk const * cached_nodes,
+                                        reference_t const * source,
+                                        node_visitor_t visit_node,
+                                        bool const interleave)
+    {
+        if (cached_nodes != nullptr) {
+            for (cached_filter_node const & node : cached_nodes->nodes) {
+                cached_node_cargo cargo = cached_nodes->cargo(node, *source);
+                prefetch_label(cargo);
+                co_await interleave_point{interleave};
+                visit_node(cargo);
+            }
+            co_return;
+        }
+
+        libjst::tree_traverser_base traverser{filter_tree};
+        for (auto it = traverser.begin(); it != traverser.end(); ++it) {
+            auto cargo = *it;
+            prefetch_label(cargo);
+            co_await interleave_point{interleave};
+            visit_node(cargo);
+        }
+    }
+}  // namespace jstmap
@@ -167,6 +167,9 @@ int simulate_main(seqan3::argument_parser & simulate_parser)
 
         log_debug("Initiate simulation");
         // read_sampler sampler{rcs_store};
+        // All sampled reads are aligned by the same aligner, which builds the reference tree once.
+        match_aligner aligner{rcs_store, options.error_rate};
+        match_alignment_queue alignment_queue{aligner};
 
         auto simulation = execute::make_sender([] (auto const & data) { return read_sampler{data}; }, rcs_store)
                         | execute::then([&] (auto && sampler) {
@@ -195,11 +198,13 @@ int simulate_main(seqan3::argument_parser & simulate_parser)
                             return execute::transform_stream(matched_search_query_stream, [&] (auto && sample) {
                                 // transfer ownership!
                                 search_matches aligned_matches{std::move(sample).query()};
-                                match_aligner aligner{rcs_store, aligned_matches.query().value().sequence()};
 
-                                for (match_position pos : sample.matches()) {
-                                    aligned_matches.record_match(aligner(std::move(pos)));
-                                }
+                                for (match_position pos : sample.matches())
+                                    alignment_queue.add(aligned_matches.query().value().sequence(), std::move(pos), 0);
+
+                                alignment_queue.align([&] (size_t, search_match match) {
+                                    aligned_matches.record_match(std::move(match));
+                                });
                                 return aligned_matches;
                             });
                         })
@@ -0,0 +1,33 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the options of the update subcommand.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <filesystem>
+
+#include <jstmap/global/options_base.hpp>
+
+namespace jstmap
+{
+
+struct update_options : public options_base
+{
+    std::filesystem::path jst_input_file{}; //!< The file path to the jst to update.
+    std::filesystem::path vcf_file{}; //!< The file path to the vcf file containing the new records or samples.
+    std::filesystem::path output_file{}; //!< The file path to write the updated jst to.
+    std::filesystem::path index_input_file{}; //!< The file path to the ibf built for the jst to update.
+    std::filesystem::path index_output_file{}; //!< The file path to write the updated ibf to.
+    size_t bin_overlap = 500; //!< The bin overlap the ibf was created with.
+    bool append_samples{false}; //!< Whether the vcf file contains new samples instead of updated records.
+};
+
+}  // namespace jstmap
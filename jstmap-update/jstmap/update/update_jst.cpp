@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the function to merge a vcf file into an existing jst.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <seqan/vcf_io.h>
+
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/for_each_variant.hpp>
+#include <jstmap/create/stripped_vcf_record.hpp>
+#include <jstmap/create/variant_filter.hpp>
+#include <jstmap/update/update_jst.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+// Variants are identified by their low breakend and deletion size, and among those by their insertion.
+using variant_key_t = std::pair<uint32_t, uint32_t>;
+using variant_map_t = std::map<variant_key_t, std::vector<std::pair<reference_t, coverage_t>>>;
+
+template <typename domain_t>
+coverage_t make_coverage(std::vector<uint32_t> const & ids, domain_t const & domain)
+{
+    coverage_t coverage{domain};
+    for (uint32_t id : ids)
+        coverage.insert(coverage.end(), id);
+    coverage.optimise();
+    return coverage;
+}
+
+template <typename domain_t>
+coverage_t merge_coverages(coverage_t const & first, coverage_t const & second, domain_t const & domain)
+{
+    std::vector<uint32_t> ids{};
+    ids.reserve(first.size() + second.size());
+    std::ranges::set_union(first, second, std::back_inserter(ids));
+    return make_coverage(ids, domain);
+}
+
+// Replaces the genotypes of the first `replaced_count` haplotypes and keeps the carriers of all other haplotypes.
+template <typename domain_t>
+coverage_t replace_coverage(coverage_t const & stored,
+                            coverage_t const & updated,
+                            uint32_t const replaced_count,
+                            domain_t const & domain)
+{
+    std::vector<uint32_t> kept_ids{};
+    std::ranges::copy_if(stored, std::back_inserter(kept_ids), [&] (uint32_t const id) {
+        return id >= replaced_count;
+    });
+
+    std::vector<uint32_t> ids{};
+    ids.reserve(kept_ids.size() + updated.size());
+    std::ranges::set_union(updated, kept_ids, std::back_inserter(ids));
+    return make_coverage(ids, domain);
+}
+} // namespace
+
+jst_update update_jst(rcs_store_t const & rcs_store, update_options const & options)
+{
+    using namespace std::literals;
+
+    seqan2::VcfFileIn vcf_file{options.vcf_file.c_str()};
+    seqan2::VcfHeader vcf_header{};
+    seqan2::readHeader(vcf_header, vcf_file);
+
+    uint32_t const stored_haplotype_count = rcs_store.size();
+    uint32_t const vcf_haplotype_count = seqan2::length(seqan2::sampleNames(seqan2::context(vcf_file))) * sample_ploidy;
+    uint32_t haplotype_offset{0};
+    uint32_t haplotype_count = stored_haplotype_count;
+
+    if (options.append_samples) {
+        haplotype_offset = stored_haplotype_count;
+        haplotype_count += vcf_haplotype_count;
+    } else if (vcf_haplotype_count > stored_haplotype_count) {
+        throw std::runtime_error{"The vcf file contains "s + std::to_string(vcf_haplotype_count) + " haplotypes but "s +
+                                 "the jst only covers "s + std::to_string(stored_haplotype_count) + "! Use "s +
+                                 "--new-samples to append the samples of the vcf file."s};
+    }
+    log_info("Haplotype count: ", stored_haplotype_count, " -> ", haplotype_count);
+
+    jst_update update{.rcs_store = rcs_store_t{reference_t{rcs_store.source().begin(), rcs_store.source().end()},
+                                               haplotype_count}};
+    auto const domain = update.rcs_store.variants().coverage_domain();
+
+    // ----------------------------------------------------------------------------
+    // Collect the stored variants within the extended coverage domain.
+    // ----------------------------------------------------------------------------
+
+    variant_map_t variants{};
+    size_t stored_variant_count{};
+    for_each_variant(rcs_store, [&] (auto low, auto high, auto const & alt_sequence, auto const & coverage) {
+        std::vector<uint32_t> ids(std::ranges::begin(coverage), std::ranges::end(coverage));
+        coverage_t extended_coverage = make_coverage(ids, domain);
+
+        variants[variant_key_t{static_cast<uint32_t>(low), static_cast<uint32_t>(high - low)}].emplace_back(
+            reference_t{std::ranges::begin(alt_sequence), std::ranges::end(alt_sequence)},
+            std::move(extended_coverage));
+        ++stored_variant_count;
+    });
+    log_info("Stored variants: ", stored_variant_count);
+
+    // ----------------------------------------------------------------------------
+    // Merge the vcf records.
+    // ----------------------------------------------------------------------------
+
+    // An updated record without carriers still replaces the genotypes, i.e. removes the carriers of the vcf samples.
+    variant_filter const filter{.keep_uncarried = !options.append_samples};
+    variant_stat stat{};
+    size_t modified_count{};
+    size_t added_count{};
+    while (!seqan2::atEnd(vcf_file)) {
+        stripped_vcf_record record{vcf_file, domain, stat, haplotype_offset, filter};
+        record.for_each_alternative(update.rcs_store.source(), [&] (normalised_allele && allele, coverage_t && coverage) {
+            auto & alleles = variants[variant_key_t{allele.position, allele.deletion_size}];
+            auto it = std::ranges::find(alleles, allele.insertion, [] (auto const & entry) -> reference_t const & {
+                return entry.first;
+            });
+
+            if (it == alleles.end() && coverage.empty()) { // an unknown variant without carriers.
+                return;
+            } else if (it == alleles.end()) {
+                alleles.emplace_back(std::move(allele.insertion), std::move(coverage));
+                ++added_count;
+            } else if (options.append_samples) { // new haplotypes carry a known variant.
+                it->second = merge_coverages(it->second, coverage, domain);
+                ++modified_count;
+            } else { // the updated call replaces the previous genotypes of the haplotypes in the vcf file.
+                it->second = replace_coverage(it->second, coverage, vcf_haplotype_count, domain);
+                ++modified_count;
+            }
+            update.changed_regions.emplace_back(allele.position, allele.position + allele.deletion_size);
+        });
+    }
+
+    log_info("#Added variants: ", added_count);
+    log_info("#Modified variants: ", modified_count);
+    log_info("#Skipped alternatives: ", stat.skipped_count);
+
+    // ----------------------------------------------------------------------------
+    // Rebuild the store in breakpoint order.
+    // ----------------------------------------------------------------------------
+
+    size_t conflict_count{};
+    for (auto & [key, alleles] : variants) {
+        for (auto & [insertion, coverage] : alleles) {
+            if (coverage.empty())
+                continue;
+
+            variant_t variant{libjst::breakpoint{key.first, key.second}, std::move(insertion), std::move(coverage)};
+            if (!update.rcs_store.variants().has_conflicts(variant))
+                update.rcs_store.add(std::move(variant));
+            else
+                ++conflict_count;
+        }
+    }
+    log_info("#Conflicting alternatives: ", conflict_count);
+
+    return update;
+}
+
+}  // namespace jstmap
@@ -0,0 +1,43 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the function to merge a vcf file into an existing jst.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/update/options.hpp>
+
+namespace jstmap
+{
+
+struct jst_update
+{
+    rcs_store_t rcs_store; //!< The updated store.
+    std::vector<std::pair<uint32_t, uint32_t>> changed_regions{}; //!< The source intervals of all added or modified variants.
+};
+
+/*!\brief Merges the records of a vcf file into the variants of the store.
+ *
+ * \details
+ *
+ * If the samples are appended, the haplotypes of the vcf file are added behind the stored haplotypes and become
+ * carriers of the new and the known variants they carry. Otherwise, the vcf file contains updated calls for the first
+ * haplotypes of the store: the genotypes of a recalled variant replace the stored genotypes of these haplotypes, such
+ * that a record genotyped without alternative alleles removes their carriers, and a variant without carriers left is
+ * removed. Stored variants that are absent from the vcf file are not recalled and keep all their carriers, including
+ * the stored genotypes of the haplotypes of the vcf file.
+ */
+jst_update update_jst(rcs_store_t const &, update_options const &);
+
+}  // namespace jstmap
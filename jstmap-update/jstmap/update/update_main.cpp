@@ -0,0 +1,159 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/rrahn/just_map/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides the main entry point of the just_map updater.
+ * \author Rene Rahn <rene.rahn AT fu-berlin.de>
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <seqan3/argument_parser/argument_parser.hpp>
+#include <seqan3/argument_parser/exceptions.hpp>
+#include <seqan3/argument_parser/validators.hpp>
+
+#include <jstmap/global/application_logger.hpp>
+#include <jstmap/global/load_jst.hpp>
+#include <jstmap/global/tool_parser.hpp>
+#include <jstmap/create/serialise_jst.hpp>
+#include <jstmap/index/create_index.hpp>
+#include <jstmap/index/load_index.hpp>
+#include <jstmap/index/save_index.hpp>
+#include <jstmap/update/options.hpp>
+#include <jstmap/update/update_jst.hpp>
+#include <jstmap/update/update_main.hpp>
+
+namespace jstmap
+{
+
+namespace
+{
+// Returns the sorted ids of all bins containing a kmer that overlaps one of the changed regions.
+std::vector<size_t> affected_bins(std::vector<std::pair<uint32_t, uint32_t>> const & changed_regions,
+                                  index_options const & options,
+                                  size_t const bin_count)
+{
+    std::vector<size_t> bin_ids{};
+    if (bin_count == 0)
+        return bin_ids;
+
+    size_t const left_margin = options.kmer_size + options.bin_overlap;
+    for (auto [low, high] : changed_regions) {
+        size_t first_bin = (low > left_margin) ? (low - left_margin) / options.bin_size : 0;
+        size_t last_bin = std::min<size_t>(high / options.bin_size, bin_count - 1);
+        for (size_t bin_id = first_bin; bin_id <= last_bin; ++bin_id)
+            bin_ids.push_back(bin_id);
+    }
+
+    std::ranges::sort(bin_ids);
+    auto [first, last] = std::ranges::unique(bin_ids);
+    bin_ids.erase(first, last);
+    return bin_ids;
+}
+} // namespace
+
+int update_main(seqan3::argument_parser & update_parser)
+{
+    update_options options{};
+    add_base_options(update_parser, options);
+
+    update_parser.add_positional_option(options.jst_input_file,
+                                        "The jst to update.",
+                                        seqan3::input_file_validator{{"jst"}});
+    update_parser.add_positional_option(options.vcf_file,
+                                        "The vcf file with the records to merge into the jst.",
+                                        seqan3::input_file_validator{{"vcf"}});
+    update_parser.add_positional_option(options.output_file,
+                                        "The output file of the updated jst.",
+                                        seqan3::output_file_validator{seqan3::output_file_open_options::create_new,
+                                                                      {"jst"}});
+    update_parser.add_flag(options.append_samples,
+                           '\0',
+                           "new-samples",
+                           "The vcf file contains new samples that are appended to the haplotypes of the jst. "
+                           "Otherwise, the vcf file contains updated records for the samples of the jst, which "
+                           "replace their genotypes; variants absent from the vcf file keep their carriers.");
+    update_parser.add_option(options.index_input_file,
+                             'i',
+                             "index",
+                             "The index built for the jst. Only the bins affected by the update are rebuilt.",
+                             seqan3::option_spec::standard,
+                             seqan3::input_file_validator{{"ibf"}});
+    update_parser.add_option(options.index_output_file,
+                             '\0',
+                             "index-output",
+                             "The output file of the updated index. Required if an index is given.",
+                             seqan3::option_spec::standard,
+                             seqan3::output_file_validator{seqan3::output_file_open_options::create_new, {"ibf"}});
+    update_parser.add_option(options.bin_overlap,
+                             'o',
+                             "bin-overlap",
+                             "The bin overlap the index was created with.",
+                             seqan3::option_spec::standard,
+                             seqan3::arithmetic_range_validator{0u, 1000u});
+
+    try
+    {
+        update_parser.parse();
+        initialise_logging_level(options);
+        if (update_parser.is_option_set("index") != update_parser.is_option_set("index-output"))
+            throw seqan3::argument_parser_error{"The options --index and --index-output must be given together!"};
+    }
+    catch (seqan3::argument_parser_error const & ex)
+    {
+        log_err(ex.what());
+        return -1;
+    }
+
+    auto duration = [] (auto const & start) {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() -
+                    start).count();
+    };
+
+    int error_code = 0;
+    try
+    {
+        log_info("Start jst update");
+        auto start = std::chrono::high_resolution_clock::now();
+        rcs_store_t rcs_store = load_jst(options.jst_input_file);
+        log_debug("Loading time: ", duration(start), " s");
+
+        start = std::chrono::high_resolution_clock::now();
+        jst_update update = update_jst(rcs_store, options);
+        log_debug("Merging time: ", duration(start), " s");
+
+        start = std::chrono::high_resolution_clock::now();
+        serialise(update.rcs_store, options.output_file);
+        log_debug("Serialising time: ", duration(start), " s");
+
+        if (!options.index_input_file.empty()) {
+            start = std::chrono::high_resolution_clock::now();
+            auto [bin_size, kmer_size, ibf] = load_index(options.index_input_file);
+            index_options ibf_options{.output_file = options.index_output_file,
+                                      .bin_size = bin_size,
+                                      .bin_overlap = options.bin_overlap,
+                                      .kmer_size = kmer_size};
+
+            std::vector<size_t> bin_ids = affected_bins(update.changed_regions, ibf_options, ibf.bin_count());
+            log_info("Rebuilding ", bin_ids.size(), " of ", ibf.bin_count(), " index bins");
+            update_index(ibf, update.rcs_store, bin_ids, ibf_options);
+            save_index(ibf, ibf_options);
+            log_debug("Index update time: ", duration(start), " s");
+        }
+    }
+    catch (std::exception const & ex)
+    {
+        log_err("While updating the jst: ", ex.what());
+        error_code = -1;
+    }
+    log_info("Stop jst update");
+    return error_code;
+}
+
+} // namespace jstmap
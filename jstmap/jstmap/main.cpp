@@ -16,6 +16,7 @@
 #include <jstmap/search/search_main.hpp> // Pulls in the search sub-command.
 #include <jstmap/simulate/simulate_main.hpp> // Pulls in the search sub-command.
 #include <jstmap/linear/linear_main.hpp> // Pulls in the linear sub-command.
+#include <jstmap/update/update_main.hpp> // Pulls in the update sub-command.
 // #include <jstmap/view/view_main.hpp> // Pulls in the view sub-command.
 
 namespace jstmap
@@ -29,6 +30,7 @@ struct tool_names
     inline static const std::string linear{"linear"};
     inline static const std::string search{"search"};
     inline static const std::string simulate{"simulate"};
+    inline static const std::string update{"update"};
     inline static const std::string view{"view"};
 
     static std::string subparser_name_for(std::string_view subcommand)
@@ -48,6 +50,7 @@ int main(int const argc, char * const argv[])
                                            jstmap::tool_names::linear,
                                            jstmap::tool_names::search,
                                            jstmap::tool_names::simulate,
+                                           jstmap::tool_names::update,
                                            jstmap::tool_names::view}};
 
     jstmap_parser.info.description.push_back("The famous population mapper based on journaled string trees.");
@@ -70,6 +73,8 @@ int main(int const argc, char * const argv[])
             return jstmap::simulate_main(selected_parser);
         else if (selected_parser.info.app_name == jstmap::tool_names::subparser_name_for(jstmap::tool_names::linear))
             return jstmap::linear_main(selected_parser);
+        else if (selected_parser.info.app_name == jstmap::tool_names::subparser_name_for(jstmap::tool_names::update))
+            return jstmap::update_main(selected_parser);
         // else if (selected_parser.info.app_name == jstmap::tool_names::subparser_name_for(jstmap::tool_names::view))
         //     return jstmap::view_main(selected_parser);
         else
@@ -0,0 +1,70 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <jstmap/create/normalise_allele.hpp>
+
+using spm::operator""_dna5;
+
+struct normalise_allele_test : public ::testing::Test
+{
+    //                                    0123456789
+    jstmap::reference_t const source = "ACGTTTTCAG"_dna5;
+};
+
+TEST_F(normalise_allele_test, snv)
+{
+    jstmap::normalised_allele allele = jstmap::normalise_allele(source, 2, "G", "A");
+    EXPECT_EQ(allele.position, 2u);
+    EXPECT_EQ(allele.deletion_size, 1u);
+    EXPECT_EQ(allele.insertion, "A"_dna5);
+}
+
+TEST_F(normalise_allele_test, padded_mnv)
+{
+    jstmap::normalised_allele allele = jstmap::normalise_allele(source, 1, "CGTT", "CAAT");
+    EXPECT_EQ(allele.position, 2u);
+    EXPECT_EQ(allele.deletion_size, 2u);
+    EXPECT_EQ(allele.insertion, "AA"_dna5);
+}
+
+TEST_F(normalise_allele_test, deletion_in_repeat)
+{
+    // Deleting the last T of the T-run must be aligned to the first T of the run.
+    jstmap::normalised_allele allele = jstmap::normalise_allele(source, 5, "TTC", "TC");
+    EXPECT_EQ(allele.position, 3u);
+    EXPECT_EQ(allele.deletion_size, 1u);
+    EXPECT_TRUE(allele.insertion.empty());
+}
+
+TEST_F(normalise_allele_test, insertion_in_repeat)
+{
+    jstmap::normalised_allele allele = jstmap::normalise_allele(source, 6, "T", "TTT");
+    EXPECT_EQ(allele.position, 3u);
+    EXPECT_EQ(allele.deletion_size, 0u);
+    EXPECT_EQ(allele.insertion, "TT"_dna5);
+}
+
+TEST_F(normalise_allele_test, padded_insertion)
+{
+    // Both the leading and the trailing padding are removed.
+    jstmap::normalised_allele allele = jstmap::normalise_allele(source, 1, "CG", "CGTG");
+    EXPECT_EQ(allele.position, 2u);
+    EXPECT_EQ(allele.deletion_size, 0u);
+    EXPECT_EQ(allele.insertion, "GT"_dna5);
+}
+
+TEST_F(normalise_allele_test, identity)
+{
+    EXPECT_TRUE(jstmap::normalise_allele(source, 3, "TT", "TT").is_identity());
+}
+
+TEST_F(normalise_allele_test, out_of_range)
+{
+    EXPECT_THROW(jstmap::normalise_allele(source, 9, "GA", "G"), std::runtime_error);
+}
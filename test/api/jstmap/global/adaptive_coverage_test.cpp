@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+
+#include <jstmap/global/adaptive_coverage.hpp>
+
+using coverage_t = jstmap::adaptive_coverage<uint32_t>;
+
+struct adaptive_coverage_test : public ::testing::Test
+{
+    coverage_t::domain_type domain{};
+
+    coverage_t make_coverage(std::vector<uint32_t> const & ids) const
+    {
+        coverage_t coverage{domain};
+        for (uint32_t id : ids)
+            coverage.insert(coverage.end(), id);
+        coverage.optimise();
+        return coverage;
+    }
+
+    static std::vector<uint32_t> to_vector(coverage_t const & coverage)
+    {
+        return std::vector<uint32_t>(coverage.begin(), coverage.end());
+    }
+
+    static std::vector<uint32_t> iota(uint32_t first, uint32_t last, uint32_t step = 1)
+    {
+        std::vector<uint32_t> ids{};
+        for (; first < last; first += step)
+            ids.push_back(first);
+        return ids;
+    }
+};
+
+TEST_F(adaptive_coverage_test, select_representation)
+{
+    EXPECT_EQ(make_coverage({3, 500, 2000}).kind(), jstmap::coverage_kind::sparse);
+    EXPECT_EQ(make_coverage(iota(0, 1000, 2)).kind(), jstmap::coverage_kind::dense);
+    EXPECT_EQ(make_coverage(iota(100, 900)).kind(), jstmap::coverage_kind::runs);
+    EXPECT_TRUE(make_coverage({}).empty());
+}
+
+TEST_F(adaptive_coverage_test, iterate)
+{
+    for (auto ids : {std::vector<uint32_t>{3, 500, 2000}, iota(0, 1000, 2), iota(100, 900)}) {
+        coverage_t coverage = make_coverage(ids);
+        EXPECT_EQ(coverage.size(), ids.size());
+        EXPECT_EQ(to_vector(coverage), ids);
+        for (uint32_t id : ids)
+            EXPECT_TRUE(coverage.contains(id));
+        EXPECT_FALSE(coverage.contains(ids.back() + 1));
+    }
+}
+
+TEST_F(adaptive_coverage_test, intersection_and_difference)
+{
+    std::vector<uint32_t> several_runs = iota(10, 70);
+    std::ranges::copy(iota(130, 500), std::back_inserter(several_runs));
+    std::ranges::copy(iota(899, 1200), std::back_inserter(several_runs));
+    std::vector<std::vector<uint32_t>> const inputs{{3, 101, 500, 998}, {0, 63, 64, 899, 1199},
+                                                    iota(0, 1000, 2), iota(1, 1500, 3),
+                                                    iota(100, 900), several_runs};
+
+    for (auto const & first : inputs) {
+        for (auto const & second : inputs) {
+            std::vector<uint32_t> expected_intersection{};
+            std::ranges::set_intersection(first, second, std::back_inserter(expected_intersection));
+            std::vector<uint32_t> expected_difference{};
+            std::ranges::set_difference(first, second, std::back_inserter(expected_difference));
+
+            coverage_t lhs = make_coverage(first);
+            coverage_t rhs = make_coverage(second);
+            EXPECT_EQ(to_vector(libjst::coverage_intersection(lhs, rhs)), expected_intersection);
+            EXPECT_EQ(to_vector(libjst::coverage_difference(lhs, rhs)), expected_difference);
+            EXPECT_EQ(to_vector(lhs.and_not(rhs)), expected_difference);
+        }
+    }
+}
+
+TEST_F(adaptive_coverage_test, results_keep_natural_representation)
+{
+    coverage_t runs = make_coverage(iota(100, 900));
+    coverage_t other_runs = make_coverage(iota(500, 1500));
+    coverage_t dense = make_coverage(iota(0, 1000, 2));
+    coverage_t sparse = make_coverage({3, 101, 500, 998});
+
+    EXPECT_EQ(libjst::coverage_intersection(runs, other_runs).kind(), jstmap::coverage_kind::runs);
+    EXPECT_EQ(libjst::coverage_difference(runs, other_runs).kind(), jstmap::coverage_kind::runs);
+    EXPECT_EQ(libjst::coverage_difference(runs, sparse).kind(), jstmap::coverage_kind::runs);
+    EXPECT_EQ(libjst::coverage_intersection(runs, dense).kind(), jstmap::coverage_kind::dense);
+    EXPECT_EQ(libjst::coverage_intersection(runs, sparse).kind(), jstmap::coverage_kind::sparse);
+    EXPECT_TRUE(libjst::coverage_intersection(sparse, make_coverage({4, 5})).empty());
+}
+
+TEST_F(adaptive_coverage_test, serialise)
+{
+    for (auto ids : {std::vector<uint32_t>{3, 500, 2000}, iota(0, 1000, 2), iota(100, 900)}) {
+        coverage_t expected = make_coverage(ids);
+        std::stringstream buffer{};
+        {
+            cereal::BinaryOutputArchive output_archive{buffer};
+            expected.save(output_archive);
+        }
+        coverage_t actual{};
+        {
+            cereal::BinaryInputArchive input_archive{buffer};
+            actual.load(input_archive);
+        }
+        EXPECT_EQ(actual.kind(), expected.kind());
+        EXPECT_EQ(actual, expected);
+    }
+}
@@ -0,0 +1,76 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <jstmap/global/compact_match_position.hpp>
+
+struct compact_match_position_test : public ::testing::Test
+{
+    static jstmap::match_position alternate_position(size_t const step_count)
+    {
+        jstmap::match_position position{.label_offset = 42};
+        position.tree_position.initiate_alternate_node(7);
+        for (size_t step = 1; step < step_count; ++step)
+            position.tree_position.next_alternate_node(step % 3 == 0);
+        return position;
+    }
+};
+
+TEST_F(compact_match_position_test, reference_node)
+{
+    jstmap::match_position position{.label_offset = 1'000'000};
+    position.tree_position.reset(13, libjst::breakpoint_end::high);
+
+    jstmap::match_position_arena arena{};
+    jstmap::compact_match_position compact = arena.encode(position);
+
+    EXPECT_EQ(compact.variant_index(), 13u);
+    EXPECT_EQ(compact.label_offset(), 1'000'000);
+    EXPECT_FALSE(compact.is_alternate());
+    EXPECT_FALSE(compact.is_spilled());
+    EXPECT_EQ(arena.decode(compact), position);
+}
+
+TEST_F(compact_match_position_test, inline_descriptor)
+{
+    jstmap::match_position position = alternate_position(64);
+
+    jstmap::match_position_arena arena{};
+    jstmap::compact_match_position compact = arena.encode(position);
+
+    EXPECT_TRUE(compact.is_alternate());
+    EXPECT_FALSE(compact.is_spilled());
+    EXPECT_EQ(arena.spilled_word_count(), 0u);
+    EXPECT_EQ(arena.decode(compact), position);
+}
+
+TEST_F(compact_match_position_test, spilled_descriptor)
+{
+    jstmap::match_position position = alternate_position(130);
+
+    jstmap::match_position_arena arena{};
+    jstmap::compact_match_position compact = arena.encode(position);
+
+    EXPECT_TRUE(compact.is_spilled());
+    EXPECT_EQ(arena.spilled_word_count(), 3u);
+    EXPECT_EQ(arena.decode(compact), position);
+}
+
+TEST_F(compact_match_position_test, adopt)
+{
+    jstmap::match_position_arena source{};
+    jstmap::compact_match_position short_compact = source.encode(alternate_position(10));
+    jstmap::compact_match_position long_compact = source.encode(alternate_position(100));
+
+    jstmap::match_position_arena target{};
+    target.encode(alternate_position(200)); // occupies the first words of the target.
+
+    EXPECT_EQ(target.adopt(short_compact, source), short_compact);
+    jstmap::compact_match_position adopted = target.adopt(long_compact, source);
+    EXPECT_EQ(target.decode(adopted), alternate_position(100));
+}
@@ -0,0 +1,116 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <seqan3/test/tmp_filename.hpp>
+
+#include <jstmap/global/coordinate_index.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::make_store;
+
+struct coordinate_index_test : public ::testing::Test
+{
+    seqan3::test::tmp_filename tmp_file{"coordinates.cidx"};
+};
+
+TEST_F(coordinate_index_test, substitution)
+{
+    jstmap::rcs_store_t rcs_store = make_store();
+    jstmap::coordinate_index index{rcs_store};
+
+    // Only the insertion and the deletion are indexed, once for every haplotype carrying them.
+    EXPECT_EQ(index.entry_count(), 3u);
+    EXPECT_EQ(index.offset(0, 0), 0);
+    EXPECT_EQ(index.offset(0, 3), 0);
+    EXPECT_EQ(index.offset(0, 17), 0);
+    EXPECT_EQ(index.haplotype_size(0), 18u);
+}
+
+TEST_F(coordinate_index_test, insertion)
+{
+    jstmap::rcs_store_t rcs_store = make_store();
+    jstmap::coordinate_index index{rcs_store};
+
+    EXPECT_EQ(index.offset(1, 5), 0);
+    EXPECT_EQ(index.offset(1, 6), 0);
+    EXPECT_EQ(index.offset(1, 6, true), 2);
+    EXPECT_EQ(index.offset(1, 7), 2);
+    EXPECT_EQ(index.offset(1, 11), 2);
+    EXPECT_EQ(index.offset(1, 12), -1);
+    EXPECT_EQ(index.haplotype_position(1, 7), 9u);
+}
+
+TEST_F(coordinate_index_test, deletion)
+{
+    jstmap::rcs_store_t rcs_store = make_store();
+    jstmap::coordinate_index index{rcs_store};
+
+    EXPECT_EQ(index.offset(3, 9), 0);
+    EXPECT_EQ(index.offset(3, 11), 0);
+    EXPECT_EQ(index.offset(3, 12), -3);
+    EXPECT_EQ(index.offset(3, 12, true), -3);
+    EXPECT_EQ(index.offset(3, 18), -3);
+}
+
+TEST_F(coordinate_index_test, uncovered)
+{
+    jstmap::rcs_store_t rcs_store = make_store();
+    jstmap::coordinate_index index{rcs_store};
+
+    EXPECT_EQ(index.offset(2, 6, true), 0);
+    EXPECT_EQ(index.offset(2, 12), 0);
+}
+
+TEST_F(coordinate_index_test, insertion_in_front_of_deletion)
+{
+    using jstmap::test::make_coverage;
+    using jstmap::test::to_sequence;
+
+    jstmap::rcs_store_t rcs_store{to_sequence("ACGTACGTAC"), 2};
+    auto domain = rcs_store.variants().coverage_domain();
+    rcs_store.add(jstmap::variant_t{libjst::breakpoint{4, 2}, to_sequence(""), make_coverage({0}, domain)});
+    rcs_store.add(jstmap::variant_t{libjst::breakpoint{4, 0}, to_sequence("TT"), make_coverage({0, 1}, domain)});
+    jstmap::coordinate_index index{rcs_store};
+
+    EXPECT_EQ(index.offset(0, 4), 0);
+    EXPECT_EQ(index.offset(0, 4, true), 2);
+    EXPECT_EQ(index.offset(0, 6), 0);
+    EXPECT_EQ(index.offset(1, 6), 2);
+    EXPECT_EQ(index.haplotype_size(0), 10u);
+    EXPECT_EQ(index.haplotype_size(1), 12u);
+}
+
+TEST_F(coordinate_index_test, haplotype_size)
+{
+    jstmap::rcs_store_t rcs_store = make_store();
+    jstmap::coordinate_index index{rcs_store};
+
+    ASSERT_EQ(index.haplotype_count(), rcs_store.size());
+    for (uint32_t haplotype = 0; haplotype < rcs_store.size(); ++haplotype)
+        EXPECT_EQ(index.haplotype_size(haplotype), std::ranges::size(rcs_store.sequence_at(haplotype)));
+}
+
+TEST_F(coordinate_index_test, save_and_load)
+{
+    jstmap::rcs_store_t rcs_store = make_store();
+    jstmap::coordinate_index expected{rcs_store};
+    expected.save(tmp_file.get_path());
+
+    jstmap::coordinate_index actual = jstmap::coordinate_index::load(tmp_file.get_path());
+    EXPECT_TRUE(actual.is_compatible(rcs_store));
+    for (uint32_t haplotype = 0; haplotype < rcs_store.size(); ++haplotype) {
+        for (uint64_t position = 0; position <= 18; ++position) {
+            EXPECT_EQ(actual.offset(haplotype, position), expected.offset(haplotype, position));
+            EXPECT_EQ(actual.offset(haplotype, position, true), expected.offset(haplotype, position, true));
+        }
+    }
+}
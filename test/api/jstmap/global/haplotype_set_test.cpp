@@ -0,0 +1,68 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <jstmap/global/adaptive_coverage.hpp>
+#include <jstmap/global/haplotype_set.hpp>
+
+using bytes_t = std::vector<uint8_t>;
+
+TEST(haplotype_set_test, encode)
+{
+    EXPECT_EQ(jstmap::encode_haplotype_set(std::vector<uint32_t>{}), bytes_t{});
+    EXPECT_EQ(jstmap::encode_haplotype_set(std::vector<uint32_t>{5}), (bytes_t{0, 5})); // sparse
+    EXPECT_EQ(jstmap::encode_haplotype_set(std::vector<uint32_t>{0, 1, 2, 3, 7, 9, 10}),
+              (bytes_t{2, 0, 0b1000'1111, 0b0000'0110})); // dense
+}
+
+TEST(haplotype_set_test, encode_coverage)
+{
+    using coverage_t = jstmap::adaptive_coverage<uint32_t>;
+    coverage_t coverage{coverage_t::domain_type{}};
+    for (uint32_t id = 100; id < 200; ++id)
+        coverage.insert(coverage.end(), id);
+    coverage.insert(coverage.end(), 250);
+    coverage.optimise();
+
+    EXPECT_EQ(jstmap::encode_haplotype_set(coverage), (bytes_t{1, 100, 99, 50, 0})); // runs
+}
+
+TEST(haplotype_set_test, bounded_size)
+{
+    std::vector<uint32_t> scattered_ids{};
+    for (uint32_t id = 0; id < 20'000; id += 2)
+        scattered_ids.push_back(id);
+
+    bytes_t encoded = jstmap::encode_haplotype_set(scattered_ids);
+    EXPECT_EQ(encoded.front(), static_cast<uint8_t>(jstmap::haplotype_set_kind::dense));
+    EXPECT_LE(encoded.size(), 20'000u / 8 + 3);
+    EXPECT_EQ(jstmap::decode_haplotype_set(encoded), scattered_ids);
+}
+
+TEST(haplotype_set_test, decode)
+{
+    EXPECT_EQ(jstmap::decode_haplotype_set(bytes_t{}), std::vector<uint32_t>{});
+    for (std::vector<uint32_t> ids : {std::vector<uint32_t>{5},
+                                      std::vector<uint32_t>{0, 1, 2, 3, 7, 9, 10},
+                                      std::vector<uint32_t>{3, 500, 2000, 4'000'000'000}}) {
+        EXPECT_EQ(jstmap::decode_haplotype_set(jstmap::encode_haplotype_set(ids)), ids);
+    }
+}
+
+TEST(haplotype_set_test, decode_malformed)
+{
+    EXPECT_THROW(jstmap::decode_haplotype_set(bytes_t{7}), std::invalid_argument); // unknown representation
+    EXPECT_THROW(jstmap::decode_haplotype_set(bytes_t{0, 0x80}), std::invalid_argument); // truncated
+    EXPECT_THROW(jstmap::decode_haplotype_set(bytes_t{1, 0xff, 0xff, 0xff, 0xff, 0x0f, 5}), // run behind 32 bits
+                 std::invalid_argument);
+    EXPECT_THROW(jstmap::decode_haplotype_set(bytes_t{0, 0xff, 0xff, 0xff, 0xff, 0x0f, 0}), // id behind 32 bits
+                 std::invalid_argument);
+}
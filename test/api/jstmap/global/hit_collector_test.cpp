@@ -0,0 +1,128 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <jstmap/global/hit_collector.hpp>
+
+struct hit_collector_test : public ::testing::Test
+{
+    static jstmap::match_position reference_position(size_t const variant_index, std::ptrdiff_t const label_offset)
+    {
+        jstmap::match_position position{.label_offset = label_offset};
+        position.tree_position.reset(variant_index, libjst::breakpoint_end::high);
+        return position;
+    }
+
+    // A position on the alternate path of the variant, which branches at every step into the given direction.
+    static jstmap::match_position alternate_position(size_t const variant_index,
+                                                     std::ptrdiff_t const label_offset,
+                                                     std::vector<bool> const & steps)
+    {
+        jstmap::match_position position{.label_offset = label_offset};
+        position.tree_position.initiate_alternate_node(variant_index);
+        for (bool step : steps)
+            position.tree_position.next_alternate_node(step);
+        return position;
+    }
+};
+
+TEST_F(hit_collector_test, same_locus_on_several_paths)
+{
+    jstmap::hit_collector collector{};
+    collector.record(0, alternate_position(4, 10, {}), 0);
+    collector.record(0, alternate_position(4, 10, {true}), 0);
+    collector.record(0, alternate_position(4, 10, {false, true}), 0);
+    EXPECT_EQ(collector.hits().at(0).positions.size(), 3u);
+
+    std::vector<jstmap::hit_collector> collectors{};
+    collectors.push_back(std::move(collector));
+    auto summaries = jstmap::summarise_hits(collectors);
+    EXPECT_EQ(summaries.at(0).best_count(), 1u);
+    EXPECT_EQ(summaries.at(0).mapping_quality(), jstmap::mapping_summary::max_mapping_quality);
+}
+
+TEST_F(hit_collector_test, distinct_loci)
+{
+    jstmap::hit_collector collector{};
+    collector.record(0, reference_position(4, 10), 0);
+    collector.record(0, reference_position(4, 11), 0);
+    collector.record(0, alternate_position(4, 10, {}), 0);
+    collector.record(1, reference_position(4, 10), 2);
+
+    std::vector<jstmap::hit_collector> collectors{};
+    collectors.push_back(std::move(collector));
+    auto summaries = jstmap::summarise_hits(collectors);
+    EXPECT_EQ(summaries.at(0).best_count(), 2u); // The reference and the alternate node of variant 4 share locus 10.
+    EXPECT_EQ(summaries.at(0).mapping_quality(), 3u);
+    EXPECT_EQ(summaries.at(1).best_error_count(), 2u);
+    EXPECT_EQ(summaries.at(1).best_count(), 1u);
+}
+
+TEST_F(hit_collector_test, same_locus_in_several_threads)
+{
+    std::vector<jstmap::hit_collector> collectors(2);
+    collectors[0].record(0, reference_position(7, 3), 1);
+    collectors[1].record(0, reference_position(7, 3), 0);
+    collectors[1].record(0, reference_position(9, 3), 1);
+
+    auto summaries = jstmap::summarise_hits(collectors);
+    EXPECT_EQ(summaries.at(0).best_error_count(), 0u);
+    EXPECT_EQ(summaries.at(0).best_count(), 1u);
+    EXPECT_EQ(summaries.at(0).second_error_count(), 1u);
+    EXPECT_EQ(summaries.at(0).second_count(), 1u);
+}
+
+TEST_F(hit_collector_test, best_only)
+{
+    jstmap::hit_collector collector{true};
+    collector.record(0, reference_position(1, 0), 2);
+    collector.record(0, reference_position(2, 0), 1);
+    collector.record(0, reference_position(3, 0), 2);
+    collector.record(0, reference_position(4, 0), 1);
+
+    auto const & hits = collector.hits().at(0);
+    EXPECT_EQ(hits.strata.best_error_count(), 1u);
+    ASSERT_EQ(hits.positions.size(), 2u);
+    EXPECT_EQ(collector.arena().decode(hits.positions[0]), reference_position(2, 0));
+    EXPECT_EQ(collector.arena().decode(hits.positions[1]), reference_position(4, 0));
+
+    // The dropped positions still count for the strata.
+    std::vector<jstmap::hit_collector> collectors{};
+    collectors.push_back(std::move(collector));
+    auto summaries = jstmap::summarise_hits(collectors);
+    EXPECT_EQ(summaries.at(0).best_count(), 2u);
+    EXPECT_EQ(summaries.at(0).second_count(), 2u);
+}
+
+TEST_F(hit_collector_test, strata)
+{
+    jstmap::hit_strata strata{};
+    strata.record(jstmap::hit_locus{.variant_index = 1, .label_offset = 0}, 3);
+    strata.record(jstmap::hit_locus{.variant_index = 2, .label_offset = 0}, 2);
+    strata.record(jstmap::hit_locus{.variant_index = 3, .label_offset = 0}, 1); // Drops the locus with 3 errors.
+    strata.record(jstmap::hit_locus{.variant_index = 4, .label_offset = 0}, 3); // Worse than the second stratum.
+    strata.record(jstmap::hit_locus{.variant_index = 2, .label_offset = 0}, 1); // Moves into the best stratum.
+    strata.record(jstmap::hit_locus{.variant_index = 3, .label_offset = 0}, 2); // Stays in the best stratum.
+
+    jstmap::mapping_summary summary = strata.summary();
+    EXPECT_EQ(strata.best_error_count(), 1u);
+    EXPECT_EQ(summary.best_count(), 2u);
+    EXPECT_EQ(summary.second_count(), 0u);
+
+    jstmap::hit_strata other{};
+    other.record(jstmap::hit_locus{.variant_index = 3, .label_offset = 0}, 0);
+    other.record(jstmap::hit_locus{.variant_index = 5, .label_offset = 0}, 2);
+    strata.merge(other);
+    summary = strata.summary();
+    EXPECT_EQ(summary.best_error_count(), 0u);
+    EXPECT_EQ(summary.best_count(), 1u);
+    EXPECT_EQ(summary.second_error_count(), 1u);
+    EXPECT_EQ(summary.second_count(), 1u);
+}
@@ -0,0 +1,153 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <string_view>
+
+#include <seqan3/test/expect_range_eq.hpp>
+#include <seqan3/test/tmp_filename.hpp>
+
+#include <libjst/variant/concept.hpp>
+
+#include <jstmap/global/crc32.hpp>
+#include <jstmap/global/jst_container.hpp>
+#include <jstmap/global/load_jst.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::to_sequence;
+using jstmap::test::make_store;
+
+struct jst_container_test : public ::testing::Test
+{
+    seqan3::test::tmp_filename tmp_file{"container.jst"};
+};
+
+TEST_F(jst_container_test, crc32)
+{
+    EXPECT_EQ(jstmap::crc32(""), 0u);
+    EXPECT_EQ(jstmap::crc32("123456789"), 0xCBF43926u);
+    EXPECT_EQ(jstmap::crc32("6789", jstmap::crc32("12345")), jstmap::crc32("123456789"));
+}
+
+TEST_F(jst_container_test, round_trip)
+{
+    jstmap::rcs_store_t expected = make_store();
+    jstmap::save_jst(expected, tmp_file.get_path());
+    ASSERT_TRUE(jstmap::jst_container_reader::is_container(tmp_file.get_path()));
+
+    jstmap::rcs_store_t actual = jstmap::load_jst(tmp_file.get_path());
+    ASSERT_EQ(actual.size(), expected.size());
+    EXPECT_RANGE_EQ(actual.source(), expected.source());
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+        EXPECT_RANGE_EQ(actual.sequence_at(idx), expected.sequence_at(idx));
+}
+
+TEST_F(jst_container_test, load_sections)
+{
+    jstmap::save_jst(make_store(), tmp_file.get_path());
+    jstmap::jst_container_reader reader{tmp_file.get_path()};
+
+    EXPECT_EQ(reader.meta().haplotype_count, 4u);
+    EXPECT_EQ(reader.meta().source_size, 18u);
+    EXPECT_EQ(reader.meta().variant_count, 3u);
+    EXPECT_TRUE(reader.has_section(jstmap::jst_section::chunk_index));
+    EXPECT_FALSE(reader.has_section(jstmap::jst_section::reverse));
+
+    std::vector<jstmap::jst_breakend> breakends = reader.load_breakends();
+    ASSERT_EQ(breakends.size(), 3u);
+    EXPECT_EQ(breakends[1].low, 6u);
+    EXPECT_EQ(breakends[1].deletion_size, 0u);
+    EXPECT_RANGE_EQ(breakends[1].insertion, to_sequence("GG"));
+    EXPECT_EQ(breakends[2].deletion_size, 3u);
+
+    EXPECT_EQ(reader.coverage_block_count(), 1u);
+    EXPECT_EQ(reader.load_coverage_block(0).size(), 3u);
+    EXPECT_EQ(reader.load_chunk_index(), (std::vector<uint64_t>{0}));
+}
+
+TEST_F(jst_container_test, detect_corruption)
+{
+    jstmap::save_jst(make_store(), tmp_file.get_path());
+
+    { // Flip one byte of the source section, which follows the header and the meta section.
+        std::fstream stream{tmp_file.get_path(), std::ios::in | std::ios::out | std::ios::binary};
+        stream.seekg(80);
+        char byte{};
+        stream.read(&byte, 1);
+        stream.seekp(80);
+        byte = ~byte;
+        stream.write(&byte, 1);
+    }
+
+    EXPECT_THROW(jstmap::load_jst(tmp_file.get_path()), std::runtime_error);
+}
+
+TEST_F(jst_container_test, reject_plain_archive)
+{
+    {
+        std::ofstream stream{tmp_file.get_path(), std::ios::binary};
+        stream << "not a jst container";
+    }
+
+    EXPECT_FALSE(jstmap::jst_container_reader::is_container(tmp_file.get_path()));
+    EXPECT_THROW(jstmap::load_jst(tmp_file.get_path()), std::runtime_error);
+    EXPECT_THROW(jstmap::load_jst(tmp_file.get_path(), {{0, 18}}), std::runtime_error);
+}
+
+TEST_F(jst_container_test, load_selected_blocks)
+{
+    jstmap::save_jst(make_store(), tmp_file.get_path());
+    jstmap::jst_container_reader reader{tmp_file.get_path()};
+
+    EXPECT_EQ(reader.select_coverage_blocks({}), std::vector<bool>{false});
+    EXPECT_EQ(reader.select_coverage_blocks({{0, 4}}), std::vector<bool>{true});
+    EXPECT_THROW(reader.load_store(std::vector<bool>{}), std::invalid_argument);
+
+    jstmap::rcs_store_t rcs_store = reader.load_store(std::vector<bool>{false});
+    ASSERT_EQ(rcs_store.size(), 4u);
+    for (size_t idx = 0; idx < rcs_store.size(); ++idx)
+        EXPECT_RANGE_EQ(rcs_store.sequence_at(idx), to_sequence("ACGTACGTACGTNNACGT"));
+
+    jstmap::rcs_store_t expected = make_store();
+    rcs_store = jstmap::load_jst(tmp_file.get_path(), {{0, 18}});
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+        EXPECT_RANGE_EQ(rcs_store.sequence_at(idx), expected.sequence_at(idx));
+}
+
+TEST_F(jst_container_test, load_selected_blocks_keeps_variant_indices)
+{
+    jstmap::rcs_store_t expected = make_store();
+    jstmap::save_jst(expected, tmp_file.get_path(), 1);
+    jstmap::jst_container_reader reader{tmp_file.get_path()};
+    ASSERT_EQ(reader.coverage_block_count(), 3u);
+
+    // Only the coverage of the substitution is loaded, the insertion and the deletion are kept without carriers.
+    jstmap::rcs_store_t actual = reader.load_store(std::vector<bool>{true, false, false});
+    expected = jstmap::load_jst(tmp_file.get_path());
+    ASSERT_EQ(std::ranges::size(actual.variants()), std::ranges::size(expected.variants()));
+
+    auto expected_it = expected.variants().begin();
+    for (auto && breakend : actual.variants()) {
+        auto && expected_breakend = *expected_it++;
+        EXPECT_EQ(libjst::low_breakend(breakend), libjst::low_breakend(expected_breakend));
+        EXPECT_EQ(libjst::high_breakend(breakend), libjst::high_breakend(expected_breakend));
+        EXPECT_EQ(libjst::position(breakend), libjst::position(expected_breakend));
+        EXPECT_RANGE_EQ(libjst::alt_sequence(breakend), libjst::alt_sequence(expected_breakend));
+        if (libjst::low_breakend(breakend) == 2)
+            EXPECT_EQ(libjst::coverage(breakend), libjst::coverage(expected_breakend));
+        else
+            EXPECT_TRUE(std::ranges::empty(libjst::coverage(breakend)));
+    }
+
+    EXPECT_RANGE_EQ(actual.sequence_at(0), expected.sequence_at(0));
+    EXPECT_RANGE_EQ(actual.sequence_at(1), to_sequence("ACGTACGTACGTNNACGT"));
+}
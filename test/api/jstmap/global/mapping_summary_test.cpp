@@ -0,0 +1,72 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <jstmap/global/mapping_summary.hpp>
+
+TEST(mapping_summary_test, empty)
+{
+    jstmap::mapping_summary summary{};
+    EXPECT_TRUE(summary.empty());
+    EXPECT_EQ(summary.mapping_quality(), 0u);
+}
+
+TEST(mapping_summary_test, record)
+{
+    jstmap::mapping_summary summary{};
+    EXPECT_TRUE(summary.record(3));
+    EXPECT_FALSE(summary.record(3));
+    EXPECT_TRUE(summary.record(1));
+    EXPECT_FALSE(summary.record(2));
+    EXPECT_FALSE(summary.record(4));
+
+    EXPECT_EQ(summary.best_error_count(), 1u);
+    EXPECT_EQ(summary.best_count(), 1u);
+    EXPECT_EQ(summary.second_error_count(), 2u);
+    EXPECT_EQ(summary.second_count(), 1u);
+}
+
+TEST(mapping_summary_test, merge)
+{
+    jstmap::mapping_summary lhs{};
+    lhs.record(2);
+    lhs.record(2);
+    lhs.record(4);
+
+    jstmap::mapping_summary rhs{};
+    rhs.record(1);
+    rhs.record(2);
+
+    lhs.merge(rhs);
+    EXPECT_EQ(lhs.best_error_count(), 1u);
+    EXPECT_EQ(lhs.best_count(), 1u);
+    EXPECT_EQ(lhs.second_error_count(), 2u);
+    EXPECT_EQ(lhs.second_count(), 3u);
+}
+
+TEST(mapping_summary_test, mapping_quality)
+{
+    jstmap::mapping_summary unique{};
+    unique.record(0);
+    EXPECT_EQ(unique.mapping_quality(), jstmap::mapping_summary::max_mapping_quality);
+
+    jstmap::mapping_summary repeat{};
+    repeat.record(0);
+    repeat.record(0);
+    EXPECT_EQ(repeat.mapping_quality(), 3u);
+
+    jstmap::mapping_summary close_second{};
+    close_second.record(0);
+    close_second.record(1);
+    EXPECT_EQ(close_second.mapping_quality(), 30u);
+
+    jstmap::mapping_summary distant_second{};
+    distant_second.record(0);
+    distant_second.record(3);
+    EXPECT_EQ(distant_second.mapping_quality(), jstmap::mapping_summary::max_mapping_quality);
+}
@@ -0,0 +1,63 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+
+#include <seqan3/test/expect_range_eq.hpp>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/packed_dna_sequence.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::to_sequence;
+
+using packed_sequence_t = jstmap::packed_dna_sequence<jstmap::alphabet_t>;
+
+TEST(packed_dna_sequence_test, pack_and_unpack)
+{
+    jstmap::reference_t sequence = to_sequence("NNACGTTGCANNNNACGTANGGGTACCA");
+    packed_sequence_t packed{sequence};
+
+    EXPECT_EQ(packed.size(), sequence.size());
+    EXPECT_EQ(packed.n_runs(), (std::vector<std::pair<uint64_t, uint64_t>>{{0, 2}, {10, 4}, {19, 1}}));
+    EXPECT_RANGE_EQ(packed.unpack<jstmap::reference_t>(), sequence);
+}
+
+TEST(packed_dna_sequence_test, unpack_every_alignment)
+{
+    // Every prefix places the runs of N and the sequence end at a different offset within the packed bytes.
+    std::string const chars{"ACGTNACGTTNNGCAACGTNNNNNTTGCA"};
+    for (size_t size = 0; size <= chars.size(); ++size) {
+        jstmap::reference_t sequence = to_sequence(std::string_view{chars}.substr(0, size));
+        EXPECT_RANGE_EQ(packed_sequence_t{sequence}.unpack<jstmap::reference_t>(), sequence) << "size " << size;
+    }
+}
+
+TEST(packed_dna_sequence_test, serialise)
+{
+    packed_sequence_t expected{to_sequence("NNACGTTGCANNNNACGTAN")};
+    packed_sequence_t actual{};
+
+    std::stringstream archive_stream{};
+    {
+        cereal::BinaryOutputArchive output_archive{archive_stream};
+        output_archive(expected);
+    }
+    {
+        cereal::BinaryInputArchive input_archive{archive_stream};
+        input_archive(actual);
+    }
+    EXPECT_EQ(actual, expected);
+}
@@ -0,0 +1,130 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <seqan3/io/sam_file/input.hpp>
+#include <seqan3/test/tmp_filename.hpp>
+
+#include <jstmap/global/sorted_sam_writer.hpp>
+
+struct sorted_sam_writer_test : public ::testing::Test
+{
+    using record_t = jstmap::sorted_sam_writer::record_type;
+
+    seqan3::test::tmp_filename tmp_file{"sorted.sam"};
+    std::vector<int32_t> positions{5, 3, 9, 3, 1, 7, 5, 0};
+
+    // The expected ids ordered by position, where records with the same position keep the order they were added in.
+    std::vector<std::pair<std::string, int32_t>> expected_records{
+        {"r7", 0}, {"r4", 1}, {"r1", 3}, {"r3", 3}, {"r0", 5}, {"r6", 5}, {"r5", 7}, {"r2", 9}
+    };
+
+    void write_records(jstmap::sorted_sam_writer & writer) const
+    {
+        using namespace seqan3::literals;
+        for (size_t idx = 0; idx < positions.size(); ++idx)
+            writer.push(record_t{.id = "r" + std::to_string(idx),
+                                           .reference_position = positions[idx],
+                                           .sequence = "ACGT"_dna5});
+    }
+
+    std::vector<std::pair<std::string, int32_t>> read_records(std::string const & sorting = "coordinate") const
+    {
+        seqan3::sam_file_input input{tmp_file.get_path(),
+                                     seqan3::fields<seqan3::field::id, seqan3::field::ref_offset>{}};
+        EXPECT_EQ(input.header().sorting, sorting);
+
+        std::vector<std::pair<std::string, int32_t>> records{};
+        for (auto && record : input)
+            records.emplace_back(record.id(), record.reference_position().value_or(-1));
+        return records;
+    }
+};
+
+TEST_F(sorted_sam_writer_test, in_memory)
+{
+    {
+        jstmap::sorted_sam_writer writer{tmp_file.get_path(),
+                                         {"reference"},
+                                         {10},
+                                         jstmap::sort_configuration{.has_coordinates = true}};
+        write_records(writer);
+        EXPECT_EQ(writer.run_count(), 0u);
+        writer.finish();
+    }
+    EXPECT_EQ(read_records(), expected_records);
+}
+
+TEST_F(sorted_sam_writer_test, spilled_runs)
+{
+    {
+        jstmap::sorted_sam_writer writer{tmp_file.get_path(),
+                                         {"reference"},
+                                         {10},
+                                         jstmap::sort_configuration{.max_memory = 1,
+                                                                    .thread_count = 2,
+                                                                    .has_coordinates = true}};
+        write_records(writer);
+        EXPECT_GT(writer.run_count(), 1u);
+        writer.finish();
+        EXPECT_EQ(writer.run_count(), 0u);
+    }
+    EXPECT_EQ(read_records(), expected_records);
+}
+
+TEST_F(sorted_sam_writer_test, finish_on_destruction)
+{
+    {
+        jstmap::sorted_sam_writer writer{tmp_file.get_path(),
+                                         {"reference"},
+                                         {10},
+                                         jstmap::sort_configuration{.max_memory = 256,
+                                                                    .thread_count = 2,
+                                                                    .has_coordinates = true}};
+        write_records(writer);
+    }
+    EXPECT_EQ(read_records(), expected_records);
+}
+
+TEST_F(sorted_sam_writer_test, unknown_order_without_coordinates)
+{
+    {
+        jstmap::sorted_sam_writer writer{tmp_file.get_path(), {"reference"}, {10}, jstmap::sort_configuration{}};
+        write_records(writer);
+    }
+    EXPECT_EQ(read_records("unknown"), expected_records);
+}
+
+TEST_F(sorted_sam_writer_test, spill_large_tags)
+{
+    using namespace seqan3::literals;
+
+    // The small records fit into the buffer, whereas the same records with a long string tag are spilled.
+    jstmap::sort_configuration const configuration{.max_memory = 8 * 1024, .has_coordinates = true};
+    {
+        jstmap::sorted_sam_writer writer{tmp_file.get_path(), {"reference"}, {10}, configuration};
+        write_records(writer);
+        EXPECT_EQ(writer.run_count(), 0u);
+    }
+    {
+        jstmap::sorted_sam_writer writer{tmp_file.get_path(), {"reference"}, {10}, configuration};
+        for (size_t idx = 0; idx < positions.size(); ++idx) {
+            record_t record{.id = "r" + std::to_string(idx),
+                            .reference_position = positions[idx],
+                            .sequence = "ACGT"_dna5};
+            record.tags.get<"CO"_tag>() = std::string(2048, 'A');
+            writer.push(std::move(record));
+        }
+        EXPECT_GT(writer.run_count(), 0u);
+    }
+    EXPECT_EQ(read_records(), expected_records);
+}
@@ -0,0 +1,113 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include <seqan3/test/tmp_filename.hpp>
+
+#include <jstmap/global/topology_cache.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::make_coverage;
+using jstmap::test::to_sequence;
+
+TEST(topology_cache_test, save_and_load)
+{
+    libjst::seek_position reference_position{};
+    reference_position.reset(4, libjst::breakpoint_end::high);
+
+    libjst::seek_position alternate_position{};
+    alternate_position.initiate_alternate_node(2);
+    alternate_position.next_alternate_node(true);
+    alternate_position.next_alternate_node(false);
+    alternate_position.next_alternate_node(true);
+
+    jstmap::jst_fingerprint const jst{.variant_count = 12, .breakends_checksum = 7, .coverages_checksum = 9};
+    jstmap::topology_cache expected{10'000, 30, jst};
+    expected.set_chunk(0, jstmap::cached_chunk{.nodes = {{.position = reference_position,
+                                                          .label_begin = 4,
+                                                          .label_size = 6,
+                                                          .path_size = 10,
+                                                          .is_source_label = true},
+                                                         {.position = alternate_position,
+                                                          .label_begin = 0,
+                                                          .label_size = 5,
+                                                          .path_size = 14}},
+                                               .labels = to_sequence("ACNTG")});
+    expected.set_chunk(2, jstmap::cached_chunk{.nodes = {{.position = alternate_position,
+                                                          .label_begin = 1,
+                                                          .label_size = 2,
+                                                          .path_size = 3}},
+                                               .labels = to_sequence("TTA")});
+
+    seqan3::test::tmp_filename tmp_file{"cache.topo"};
+    expected.save(tmp_file.get_path());
+    jstmap::topology_cache actual = jstmap::topology_cache::load(tmp_file.get_path());
+
+    EXPECT_EQ(actual.bin_size(), 10'000u);
+    EXPECT_EQ(actual.window_size(), 30u);
+    EXPECT_EQ(actual.jst(), jst);
+    ASSERT_EQ(actual.chunk_count(), 3u);
+    EXPECT_EQ(actual.chunk(0), expected.chunk(0));
+    EXPECT_TRUE(actual.chunk(1).nodes.empty());
+    EXPECT_EQ(actual.chunk(2), expected.chunk(2));
+
+    // The first label is a slice of the source, the second one is stored in the chunk.
+    jstmap::reference_t const source = to_sequence("ACGTACGTACGTNNACGT");
+    auto first_label = [&] (jstmap::cached_chunk const & chunk) {
+        auto label = chunk.cargo(chunk.nodes.front(), source).sequence();
+        return jstmap::test::to_string(jstmap::reference_t{label.begin(), label.end()});
+    };
+    EXPECT_EQ(first_label(actual.chunk(0)), "ACGTAC");
+    EXPECT_EQ(first_label(actual.chunk(2)), "TA");
+}
+
+TEST(topology_cache_test, is_compatible)
+{
+    jstmap::rcs_store_t rcs_store = jstmap::test::make_store();
+    seqan3::test::tmp_filename jst_file{"store.jst"};
+    jstmap::save_jst(rcs_store, jst_file.get_path());
+    jstmap::jst_fingerprint const jst = jstmap::jst_fingerprint::read(jstmap::jst_container_reader{jst_file.get_path()});
+    EXPECT_EQ(jst.variant_count, 3u);
+
+    jstmap::topology_cache cache{8, 4, jst};
+    EXPECT_TRUE(cache.is_compatible(jst, 8));
+    EXPECT_FALSE(cache.is_compatible(jst, 16));
+
+    // The same number of variants with a different alternate sequence.
+    jstmap::rcs_store_t changed_alternate{rcs_store.source(), 4};
+    auto domain = changed_alternate.variants().coverage_domain();
+    changed_alternate.add(jstmap::variant_t{libjst::breakpoint{2, 1}, to_sequence("A"), make_coverage({0, 2}, domain)});
+    changed_alternate.add(jstmap::variant_t{libjst::breakpoint{6, 0}, to_sequence("GG"), make_coverage({1}, domain)});
+    changed_alternate.add(jstmap::variant_t{libjst::breakpoint{9, 3}, to_sequence(""), make_coverage({1, 3}, domain)});
+    jstmap::save_jst(changed_alternate, jst_file.get_path());
+    EXPECT_FALSE(cache.is_compatible(jstmap::jst_fingerprint::read(jstmap::jst_container_reader{jst_file.get_path()}), 8));
+
+    // The same breakends with a different coverage.
+    jstmap::rcs_store_t changed_coverage{rcs_store.source(), 4};
+    changed_coverage.add(jstmap::variant_t{libjst::breakpoint{2, 1}, to_sequence("T"), make_coverage({0, 1}, domain)});
+    changed_coverage.add(jstmap::variant_t{libjst::breakpoint{6, 0}, to_sequence("GG"), make_coverage({1}, domain)});
+    changed_coverage.add(jstmap::variant_t{libjst::breakpoint{9, 3}, to_sequence(""), make_coverage({1, 3}, domain)});
+    jstmap::save_jst(changed_coverage, jst_file.get_path());
+    jstmap::jst_fingerprint const changed_jst =
+        jstmap::jst_fingerprint::read(jstmap::jst_container_reader{jst_file.get_path()});
+    EXPECT_EQ(changed_jst.breakends_checksum, jst.breakends_checksum);
+    EXPECT_FALSE(cache.is_compatible(changed_jst, 8));
+}
+
+TEST(topology_cache_test, load_invalid_file)
+{
+    seqan3::test::tmp_filename tmp_file{"cache.topo"};
+    {
+        std::ofstream output_stream{tmp_file.get_path()};
+        output_stream << "no topology cache";
+    }
+    EXPECT_THROW(jstmap::topology_cache::load(tmp_file.get_path()), std::runtime_error);
+}
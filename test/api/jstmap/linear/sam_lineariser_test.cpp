@@ -0,0 +1,328 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+#include <seqan3/alphabet/views/to_char.hpp>
+#include <seqan3/io/sam_file/input.hpp>
+#include <seqan3/io/sam_file/output.hpp>
+#include <seqan3/test/tmp_filename.hpp>
+
+#include <libjst/traversal/tree_traverser_base.hpp>
+
+#include <jstmap/global/coordinate_index.hpp>
+#include <jstmap/global/reference_tree_cache.hpp>
+#include <jstmap/global/sam_tags.hpp>
+#include <jstmap/linear/sam_lineariser.hpp>
+
+#include "../test_utility.hpp"
+
+struct sam_lineariser_test : public ::testing::Test
+{
+    static constexpr size_t query_size = 4;
+
+    //!\brief A record matching the path of a node of the reference tree.
+    struct tree_record
+    {
+        size_t variant_index{};
+        jstmap::match_position position{};
+        seqan3::sam_tag_dictionary tags{};
+        std::string sequence{};
+        std::vector<uint32_t> coverage_ids{};
+    };
+
+    jstmap::rcs_store_t rcs_store = jstmap::test::make_store();
+    jstmap::coordinate_index coordinates{rcs_store};
+    seqan3::test::tmp_filename sam_file{"mapped.sam"};
+    seqan3::test::tmp_filename linear_file{"linear.sam"};
+
+    // One record at the begin and one at the end of the path of every node that is long enough.
+    std::vector<tree_record> make_records() const
+    {
+        jstmap::reference_tree_cache reference_trees{rcs_store};
+        std::vector<tree_record> records{};
+        libjst::tree_traverser_base traverser{reference_trees.get(query_size - 1)};
+        for (auto it = traverser.begin(); it != traverser.end(); ++it) {
+            auto cargo = *it;
+            std::string path_sequence{};
+            std::ranges::copy(cargo.path_sequence() | std::views::transform([] (auto symbol) {
+                return seqan3::to_char(symbol);
+            }), std::back_inserter(path_sequence));
+            if (path_sequence.size() < query_size)
+                continue;
+
+            auto const coverage = cargo.coverage();
+            std::vector<uint32_t> const coverage_ids(coverage.begin(), coverage.end());
+            for (size_t label_offset : {size_t{0}, path_sequence.size() - query_size}) {
+                jstmap::match_position const position{.tree_position = cargo.position(),
+                                                      .label_offset = static_cast<std::ptrdiff_t>(label_offset)};
+                tree_record record{.variant_index = cargo.position().get_variant_index(),
+                                   .position = position,
+                                   .sequence = path_sequence.substr(label_offset, query_size),
+                                   .coverage_ids = coverage_ids};
+                jstmap::encode_match_position(position, record.tags);
+                records.push_back(std::move(record));
+            }
+        }
+        return records;
+    }
+
+    std::string haplotype_segment(uint32_t const haplotype, int64_t const position) const
+    {
+        std::string sequence{};
+        for (auto symbol : rcs_store.sequence_at(haplotype))
+            sequence.push_back(seqan3::to_char(symbol));
+        return sequence.substr(position, query_size);
+    }
+
+    // Writes the records followed by a record without a tree position.
+    void write_records(std::vector<tree_record> const & records) const
+    {
+        using namespace std::literals;
+        using namespace seqan3::literals;
+
+        seqan3::sam_file_output output{sam_file.get_path(),
+                                       std::vector<std::string>{"jst"},
+                                       std::vector<size_t>{rcs_store.source().size()},
+                                       seqan3::fields<seqan3::field::id,
+                                                      seqan3::field::ref_id,
+                                                      seqan3::field::ref_offset,
+                                                      seqan3::field::seq,
+                                                      seqan3::field::tags>{}};
+        for (size_t idx = 0; idx < records.size(); ++idx)
+            output.emplace_back("r" + std::to_string(idx),
+                                output.header().ref_ids()[0],
+                                static_cast<int32_t>(records[idx].variant_index),
+                                to_dna5(records[idx].sequence),
+                                records[idx].tags);
+        output.emplace_back("invalid"s, output.header().ref_ids()[0], 0, "ACGT"_dna5, seqan3::sam_tag_dictionary{});
+    }
+
+    // Writes every record paired with its successor as mate, followed by an unmapped mate of the first record.
+    void write_pairs(std::vector<tree_record> const & records) const
+    {
+        using namespace std::literals;
+        using namespace seqan3::literals;
+
+        seqan3::sam_file_output output{sam_file.get_path(),
+                                       std::vector<std::string>{"jst"},
+                                       std::vector<size_t>{rcs_store.source().size()},
+                                       seqan3::fields<seqan3::field::id,
+                                                      seqan3::field::flag,
+                                                      seqan3::field::ref_id,
+                                                      seqan3::field::ref_offset,
+                                                      seqan3::field::mate,
+                                                      seqan3::field::seq,
+                                                      seqan3::field::tags>{}};
+        using mate_type = std::tuple<std::optional<int32_t>, std::optional<int32_t>, int32_t>;
+        auto add_mate = [] (seqan3::sam_tag_dictionary tags, tree_record const & mate) {
+            jstmap::encode_match_position(mate.position, tags, jstmap::mate_position_tags);
+            tags.get<"ms"_tag>() = static_cast<int32_t>(mate.sequence.size());
+            return tags;
+        };
+
+        for (size_t idx = 0; idx + 1 < records.size(); ++idx) {
+            tree_record const & mate = records[idx + 1];
+            output.emplace_back("p" + std::to_string(idx),
+                                seqan3::sam_flag::paired | seqan3::sam_flag::first_in_pair,
+                                output.header().ref_ids()[0],
+                                static_cast<int32_t>(records[idx].variant_index),
+                                mate_type{0, static_cast<int32_t>(mate.variant_index), 0},
+                                to_dna5(records[idx].sequence),
+                                add_mate(records[idx].tags, mate));
+        }
+        output.emplace_back("unmapped"s,
+                            seqan3::sam_flag::paired | seqan3::sam_flag::second_in_pair | seqan3::sam_flag::unmapped,
+                            output.header().ref_ids()[0],
+                            static_cast<int32_t>(records[0].variant_index),
+                            mate_type{0, static_cast<int32_t>(records[0].variant_index), 0},
+                            "ACGT"_dna5,
+                            add_mate(seqan3::sam_tag_dictionary{}, records[0]));
+    }
+
+    static seqan3::dna5_vector to_dna5(std::string const & sequence)
+    {
+        seqan3::dna5_vector result{};
+        for (char c : sequence)
+            result.push_back(seqan3::assign_char_to(c, seqan3::dna5{}));
+        return result;
+    }
+
+    static bool covers(tree_record const & record, uint32_t const haplotype)
+    {
+        return std::ranges::find(record.coverage_ids, haplotype) != record.coverage_ids.end();
+    }
+};
+
+TEST_F(sam_lineariser_test, linear_position)
+{
+    std::vector<tree_record> records = make_records();
+    ASSERT_GT(records.size(), 4u);
+
+    for (uint32_t haplotype = 0; haplotype < rcs_store.size(); ++haplotype) {
+        jstmap::sam_lineariser lineariser{rcs_store, coordinates, haplotype};
+        for (tree_record const & record : records) {
+            std::optional<int64_t> position = lineariser.linear_position(record.variant_index,
+                                                                         record.tags,
+                                                                         record.sequence.size());
+            if (!covers(record, haplotype)) {
+                EXPECT_FALSE(position.has_value()) << "haplotype " << haplotype << " record " << record.sequence;
+                continue;
+            }
+            ASSERT_TRUE(position.has_value()) << "haplotype " << haplotype << " record " << record.sequence;
+            EXPECT_EQ(haplotype_segment(haplotype, *position), record.sequence) << "haplotype " << haplotype;
+        }
+    }
+}
+
+TEST_F(sam_lineariser_test, empty_record)
+{
+    jstmap::sam_lineariser lineariser{rcs_store, coordinates, 0};
+    EXPECT_FALSE(lineariser.linear_position(0, make_records().front().tags, 0).has_value());
+}
+
+TEST_F(sam_lineariser_test, linearise_file)
+{
+    using namespace seqan3::literals;
+
+    std::vector<tree_record> records = make_records();
+    write_records(records);
+
+    uint32_t const haplotype = 1;
+    size_t const covered_count = std::ranges::count_if(records, [&] (tree_record const & record) {
+        return covers(record, haplotype);
+    });
+
+    jstmap::sam_lineariser lineariser{rcs_store, coordinates, haplotype};
+    jstmap::linearisation_statistics statistics = lineariser(sam_file.get_path(),
+                                                             linear_file.get_path(),
+                                                             2,
+                                                             std::nullopt,
+                                                             3);
+    EXPECT_EQ(statistics.record_count, records.size() + 1);
+    EXPECT_EQ(statistics.linearised_count, covered_count);
+    EXPECT_EQ(statistics.uncovered_count, records.size() - covered_count);
+    EXPECT_EQ(statistics.invalid_count, 1u);
+
+    seqan3::sam_file_input input{linear_file.get_path(),
+                                 seqan3::fields<seqan3::field::id,
+                                                seqan3::field::ref_offset,
+                                                seqan3::field::seq,
+                                                seqan3::field::tags>{}};
+    EXPECT_EQ(input.header().ref_ids()[0], "haplotype_1");
+
+    size_t linearised_count{};
+    std::string previous_id{};
+    for (auto && record : input) {
+        std::string sequence{};
+        std::ranges::copy(record.sequence() | seqan3::views::to_char, std::back_inserter(sequence));
+        ASSERT_TRUE(record.reference_position().has_value());
+        EXPECT_EQ(haplotype_segment(haplotype, *record.reference_position()), sequence) << record.id();
+        EXPECT_FALSE(jstmap::has_tree_position(record.tags()));
+        EXPECT_FALSE(record.tags().contains("lo"_tag));
+        // The records are written in the order of the input.
+        if (!previous_id.empty())
+            EXPECT_LT(std::stoul(previous_id.substr(1)), std::stoul(record.id().substr(1)));
+        previous_id = record.id();
+        ++linearised_count;
+    }
+    EXPECT_EQ(linearised_count, covered_count);
+}
+
+TEST_F(sam_lineariser_test, linearise_file_sorted)
+{
+    std::vector<tree_record> records = make_records();
+    write_records(records);
+
+    uint32_t const haplotype = 3;
+    jstmap::sam_lineariser lineariser{rcs_store, coordinates, haplotype};
+    jstmap::linearisation_statistics statistics = lineariser(sam_file.get_path(),
+                                                             linear_file.get_path(),
+                                                             2,
+                                                             jstmap::sort_configuration{.max_memory = 256},
+                                                             3);
+    EXPECT_EQ(statistics.invalid_count, 1u);
+
+    // The linearised positions are coordinates of the haplotype, such that the output is coordinate sorted.
+    seqan3::sam_file_input input{linear_file.get_path(),
+                                 seqan3::fields<seqan3::field::ref_offset, seqan3::field::seq>{}};
+    EXPECT_EQ(input.header().sorting, "coordinate");
+
+    size_t linearised_count{};
+    int32_t previous_position{};
+    for (auto && record : input) {
+        std::string sequence{};
+        std::ranges::copy(record.sequence() | seqan3::views::to_char, std::back_inserter(sequence));
+        ASSERT_TRUE(record.reference_position().has_value());
+        EXPECT_LE(previous_position, *record.reference_position());
+        EXPECT_EQ(haplotype_segment(haplotype, *record.reference_position()), sequence);
+        previous_position = *record.reference_position();
+        ++linearised_count;
+    }
+    EXPECT_EQ(linearised_count, statistics.linearised_count);
+}
+
+TEST_F(sam_lineariser_test, linearise_pairs)
+{
+    using namespace seqan3::literals;
+
+    std::vector<tree_record> records = make_records();
+    write_pairs(records);
+
+    uint32_t const haplotype = 2;
+    jstmap::sam_lineariser lineariser{rcs_store, coordinates, haplotype};
+    jstmap::linearisation_statistics statistics = lineariser(sam_file.get_path(), linear_file.get_path());
+
+    size_t covered_count{};
+    size_t unpaired_count{};
+    for (size_t idx = 0; idx + 1 < records.size(); ++idx) {
+        if (!covers(records[idx], haplotype))
+            continue;
+        ++covered_count;
+        unpaired_count += !covers(records[idx + 1], haplotype);
+    }
+    bool const places_unmapped = covers(records[0], haplotype);
+    ASSERT_GT(unpaired_count, 0u);
+    EXPECT_EQ(statistics.linearised_count, covered_count + places_unmapped);
+    EXPECT_EQ(statistics.unpaired_count, unpaired_count);
+    EXPECT_EQ(statistics.invalid_count, 0u);
+
+    seqan3::sam_file_input input{linear_file.get_path(),
+                                 seqan3::fields<seqan3::field::id,
+                                                seqan3::field::flag,
+                                                seqan3::field::ref_offset,
+                                                seqan3::field::mate,
+                                                seqan3::field::tags>{}};
+    for (auto && record : input) {
+        EXPECT_FALSE(jstmap::has_tree_position(record.tags(), jstmap::mate_position_tags));
+        EXPECT_FALSE(record.tags().contains("ms"_tag));
+        ASSERT_TRUE(record.reference_position().has_value());
+        if (record.id() == "unmapped") { // Placed at its mate.
+            EXPECT_EQ(record.reference_position(), record.mate_position());
+            continue;
+        }
+
+        tree_record const & mate = records[std::stoul(record.id().substr(1)) + 1];
+        if (!covers(mate, haplotype)) {
+            EXPECT_FALSE(static_cast<bool>(record.flag() & seqan3::sam_flag::paired)) << record.id();
+            EXPECT_FALSE(record.mate_position().has_value()) << record.id();
+            continue;
+        }
+        EXPECT_TRUE(static_cast<bool>(record.flag() & seqan3::sam_flag::paired)) << record.id();
+        ASSERT_TRUE(record.mate_position().has_value()) << record.id();
+        EXPECT_EQ(haplotype_segment(haplotype, *record.mate_position()), mate.sequence) << record.id();
+    }
+}
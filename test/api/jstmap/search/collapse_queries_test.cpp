@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+#include <jstmap/search/collapse_queries.hpp>
+
+struct collapse_queries_test : public ::testing::Test
+{
+    static std::vector<jstmap::search_query> make_queries(std::vector<std::string_view> const & sequences)
+    {
+        std::vector<jstmap::search_query> queries{};
+        for (std::string_view chars : sequences) {
+            jstmap::sequence_record_t record{};
+            record.id() = "read" + std::to_string(queries.size());
+            for (char c : chars)
+                record.sequence().push_back(seqan3::assign_char_to(c, jstmap::alphabet_t{}));
+            queries.emplace_back(queries.size(), std::move(record));
+        }
+        return queries;
+    }
+};
+
+TEST_F(collapse_queries_test, collapse)
+{
+    jstmap::collapsed_queries collapsed = jstmap::collapse_queries(make_queries({"ACGT", "GGTA", "ACGT", "ACGTA", "ACGT"}));
+
+    ASSERT_EQ(collapsed.queries.size(), 3u);
+    EXPECT_EQ(collapsed.queries[0].key(), 0u);
+    EXPECT_EQ(collapsed.queries[1].key(), 1u);
+    EXPECT_EQ(collapsed.queries[2].key(), 2u);
+    EXPECT_EQ(collapsed.queries[0].value().id(), "read0");
+    EXPECT_EQ(collapsed.queries[2].value().id(), "read3");
+
+    EXPECT_EQ(collapsed.original_keys[0], (std::vector<size_t>{0, 2, 4}));
+    EXPECT_EQ(collapsed.original_keys[1], (std::vector<size_t>{1}));
+    EXPECT_EQ(collapsed.original_keys[2], (std::vector<size_t>{3}));
+    EXPECT_EQ(collapsed.multiplicity(0), 3u);
+}
+
+TEST_F(collapse_queries_test, empty)
+{
+    EXPECT_TRUE(jstmap::collapse_queries({}).queries.empty());
+}
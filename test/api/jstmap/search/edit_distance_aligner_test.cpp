@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/search/edit_distance_aligner.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::to_sequence;
+
+struct edit_distance_aligner_test : public ::testing::Test
+{
+    static std::string to_string(std::vector<seqan3::cigar> const & cigar_sequence)
+    {
+        std::string result{};
+        for (seqan3::cigar const & element : cigar_sequence)
+            result += std::to_string(seqan3::get<0>(element)) + seqan3::get<1>(element).to_char();
+        return result;
+    }
+
+    jstmap::edit_alignment align(std::string_view query, std::string_view segment)
+    {
+        return aligner(to_sequence(query), to_sequence(segment));
+    }
+
+    jstmap::edit_distance_aligner aligner{};
+};
+
+TEST_F(edit_distance_aligner_test, exact)
+{
+    jstmap::edit_alignment alignment = align("ACGTACGT", "TTACGTACGTTT");
+    EXPECT_EQ(alignment.edit_distance, 0);
+    EXPECT_EQ(alignment.begin_position, 2);
+    EXPECT_EQ(alignment.end_position, 10);
+    EXPECT_EQ(to_string(alignment.cigar_sequence), "8M");
+}
+
+TEST_F(edit_distance_aligner_test, mismatch)
+{
+    jstmap::edit_alignment alignment = align("ACGTACGT", "GGACGAACGTGG");
+    EXPECT_EQ(alignment.edit_distance, 1);
+    EXPECT_EQ(alignment.begin_position, 2);
+    EXPECT_EQ(alignment.end_position, 10);
+    EXPECT_EQ(to_string(alignment.cigar_sequence), "8M");
+}
+
+TEST_F(edit_distance_aligner_test, insertion)
+{
+    jstmap::edit_alignment alignment = align("ACGTTACGT", "GGACGTACGTGG");
+    EXPECT_EQ(alignment.edit_distance, 1);
+    EXPECT_EQ(alignment.end_position - alignment.begin_position, 8);
+    EXPECT_EQ(to_string(alignment.cigar_sequence), "3M1I5M");
+}
+
+TEST_F(edit_distance_aligner_test, deletion)
+{
+    jstmap::edit_alignment alignment = align("ACGTACGT", "GGACGTTTACGTGG");
+    EXPECT_EQ(alignment.edit_distance, 2);
+    EXPECT_EQ(alignment.end_position - alignment.begin_position, 10);
+    EXPECT_EQ(to_string(alignment.cigar_sequence), "3M2D5M");
+}
+
+TEST_F(edit_distance_aligner_test, multiple_blocks)
+{
+    std::string query{};
+    for (size_t idx = 0; idx < 50; ++idx)
+        query += "ACG";
+
+    std::string segment = "TT" + query + "TT";
+    segment[2 + 100] = 'T'; // substitution within the second block.
+    jstmap::edit_alignment alignment = align(query, segment);
+    EXPECT_EQ(alignment.edit_distance, 1);
+    EXPECT_EQ(alignment.begin_position, 2);
+    EXPECT_EQ(to_string(alignment.cigar_sequence), "150M");
+}
@@ -0,0 +1,70 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/search/exact_matcher.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::to_sequence;
+
+struct exact_matcher_test : public ::testing::Test
+{
+    using hit_t = std::pair<uint32_t, std::ptrdiff_t>;
+
+    static std::vector<hit_t> find_all(std::vector<jstmap::reference_t> const & needles, std::string_view haystack)
+    {
+        std::vector<hit_t> hits{};
+        jstmap::exact_matcher matcher{needles};
+        matcher(to_sequence(haystack), [&] (uint32_t needle_idx, std::ptrdiff_t begin_position) {
+            hits.emplace_back(needle_idx, begin_position);
+        });
+        std::ranges::sort(hits);
+        return hits;
+    }
+};
+
+TEST_F(exact_matcher_test, window_size)
+{
+    std::vector<jstmap::reference_t> needles{to_sequence("ACGT"), to_sequence("GTACGTA")};
+    EXPECT_EQ(jstmap::exact_matcher{needles}.window_size(), 7u);
+}
+
+TEST_F(exact_matcher_test, multiple_needles)
+{
+    std::vector<jstmap::reference_t> needles{to_sequence("ACGT"), to_sequence("CGTAC"), to_sequence("TTTT")};
+    EXPECT_EQ(find_all(needles, "ACGTACGTNACGTTTTT"),
+              (std::vector<hit_t>{{0, 0}, {0, 4}, {0, 9}, {1, 1}, {2, 12}, {2, 13}}));
+}
+
+TEST_F(exact_matcher_test, ambiguous_bases)
+{
+    std::vector<jstmap::reference_t> needles{to_sequence("NNAC"), to_sequence("ACGTA")};
+    EXPECT_EQ(find_all(needles, "ACNNACGTAC"), (std::vector<hit_t>{{0, 2}, {1, 4}}));
+}
+
+TEST_F(exact_matcher_test, ambiguous_prefix)
+{
+    // The first needle is indexed by its q-gram ACGTA at offset 1.
+    std::vector<jstmap::reference_t> needles{to_sequence("NACGTAC"), to_sequence("ACGTA")};
+    EXPECT_EQ(find_all(needles, "TNACGTACGTANACGTAC"),
+              (std::vector<hit_t>{{0, 1}, {0, 11}, {1, 2}, {1, 6}, {1, 12}}));
+    EXPECT_TRUE(find_all({to_sequence("NACGTAC")}, "ACGTACNACGTA").empty());
+}
+
+TEST_F(exact_matcher_test, no_match)
+{
+    std::vector<jstmap::reference_t> needles{to_sequence("ACGTACGTACGT")};
+    EXPECT_TRUE(find_all(needles, "ACGTACGT").empty());
+    EXPECT_TRUE(find_all({}, "ACGTACGT").empty());
+}
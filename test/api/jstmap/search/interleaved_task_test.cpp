@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <jstmap/search/interleaved_task.hpp>
+
+namespace
+{
+    jstmap::interleaved_task append(std::string & log, char const symbol, size_t const count, bool const interleave)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            co_await jstmap::interleave_point{interleave};
+            log.push_back(symbol);
+        }
+    }
+
+    jstmap::interleaved_task fail()
+    {
+        co_await jstmap::interleave_point{true};
+        throw std::runtime_error{"failed task"};
+    }
+}  // namespace
+
+TEST(interleaved_task_test, run)
+{
+    std::string log{};
+    jstmap::interleaved_task task = append(log, 'a', 3, true);
+
+    EXPECT_FALSE(task.done());
+    EXPECT_TRUE(log.empty()); // lazily started
+    task.run();
+    EXPECT_TRUE(task.done());
+    EXPECT_EQ(log, "aaa");
+}
+
+TEST(interleaved_task_test, no_suspension_without_interleaving)
+{
+    std::string log{};
+    jstmap::interleaved_task task = append(log, 'a', 3, false);
+
+    task.resume();
+    EXPECT_TRUE(task.done());
+    EXPECT_EQ(log, "aaa");
+}
+
+TEST(interleaved_task_test, empty_task)
+{
+    jstmap::interleaved_task task{};
+    EXPECT_TRUE(task.done());
+    EXPECT_NO_THROW(task.run());
+}
+
+TEST(interleaved_task_test, run_interleaved)
+{
+    std::string log{};
+    std::vector<jstmap::interleaved_task> tasks{};
+    tasks.push_back(append(log, 'a', 3, true));
+    tasks.push_back(append(log, 'b', 1, true));
+    tasks.push_back(jstmap::interleaved_task{});
+    tasks.push_back(append(log, 'c', 2, true));
+
+    jstmap::run_interleaved(tasks);
+    EXPECT_EQ(log, "abcaca");
+    EXPECT_TRUE(std::ranges::all_of(tasks, [] (auto const & task) { return task.done(); }));
+}
+
+TEST(interleaved_task_test, rethrow_exception)
+{
+    jstmap::interleaved_task task = fail();
+    EXPECT_THROW(task.run(), std::runtime_error);
+}
@@ -0,0 +1,56 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <jstmap/search/lru_cache.hpp>
+
+TEST(lru_cache_test, hit_and_miss)
+{
+    jstmap::lru_cache<int, std::string> cache{2};
+    size_t made_count{};
+    auto make = [&] (std::string value) {
+        return [&made_count, value] () { ++made_count; return value; };
+    };
+
+    EXPECT_EQ(cache.get_or_emplace(1, make("a")), "a");
+    EXPECT_EQ(cache.get_or_emplace(1, make("x")), "a");
+    EXPECT_EQ(made_count, 1u);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(lru_cache_test, evict_least_recently_used)
+{
+    jstmap::lru_cache<int, std::string> cache{2};
+    size_t made_count{};
+    auto make = [&] (std::string value) {
+        return [&made_count, value] () { ++made_count; return value; };
+    };
+
+    cache.get_or_emplace(1, make("a"));
+    cache.get_or_emplace(2, make("b"));
+    cache.get_or_emplace(1, make("x")); // 2 is now the least recently used entry.
+    cache.get_or_emplace(3, make("c"));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(made_count, 3u);
+
+    EXPECT_EQ(cache.get_or_emplace(1, make("x")), "a");
+    EXPECT_EQ(cache.get_or_emplace(2, make("d")), "d");
+    EXPECT_EQ(made_count, 4u);
+}
+
+TEST(lru_cache_test, clear)
+{
+    jstmap::lru_cache<int, int> cache{4};
+    cache.get_or_emplace(1, [] () { return 10; });
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.get_or_emplace(1, [] () { return 20; }), 20);
+    EXPECT_EQ(cache.capacity(), 4u);
+}
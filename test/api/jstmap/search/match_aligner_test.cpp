@@ -0,0 +1,101 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include <seqan3/alignment/pairwise/align_pairwise.hpp>
+#include <seqan3/utility/views/slice.hpp>
+
+#include <libjst/traversal/tree_traverser_base.hpp>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/search/match_aligner.hpp>
+
+#include "../test_utility.hpp"
+
+struct match_aligner_test : public ::testing::Test
+{
+    static constexpr double error_rate = 0.1;
+    static constexpr size_t query_size = 6;
+
+    jstmap::rcs_store_t rcs_store = jstmap::test::make_store();
+    jstmap::match_aligner aligner{rcs_store, error_rate};
+
+    // Aligns a single match the way the matches were aligned before they were batched.
+    jstmap::search_match align_single(jstmap::record_sequence_t const & query, jstmap::match_position position) const
+    {
+        auto node = aligner.reference_tree(query_size - 1).seek(position.tree_position);
+        auto ref_sequence = (*node).path_sequence();
+        std::ptrdiff_t const errors = aligner.error_count(std::ranges::ssize(query));
+        std::ptrdiff_t const begin_position = std::max<std::ptrdiff_t>(0, position.label_offset - errors);
+        std::ptrdiff_t const end_position = std::min(position.label_offset + std::ranges::ssize(query) + errors,
+                                                     std::ranges::ssize(ref_sequence));
+
+        auto align_config = seqan3::align_cfg::method_global{
+                                seqan3::align_cfg::free_end_gaps_sequence1_leading{false},
+                                seqan3::align_cfg::free_end_gaps_sequence2_leading{true},
+                                seqan3::align_cfg::free_end_gaps_sequence1_trailing{false},
+                                seqan3::align_cfg::free_end_gaps_sequence2_trailing{true}}
+                          | seqan3::align_cfg::scoring_scheme{seqan3::nucleotide_scoring_scheme{
+                                seqan3::match_score{4}, seqan3::mismatch_score{-5}}}
+                          | seqan3::align_cfg::gap_cost_affine{seqan3::align_cfg::open_score{-10},
+                                                               seqan3::align_cfg::extension_score{-1}};
+        auto ref_segment = ref_sequence | seqan3::views::slice(begin_position, end_position);
+        auto result = *seqan3::align_pairwise(std::tie(query, ref_segment), align_config).begin();
+        return jstmap::search_match{std::move(position), jstmap::alignment_result{std::move(result)}};
+    }
+};
+
+TEST_F(match_aligner_test, batches_equal_single_alignments)
+{
+    // Every node of the reference tree is matched at the begin of its path, which clips the reference segment at
+    // position 0, at the end of its path and in between. Every second query carries a substitution.
+    std::vector<jstmap::record_sequence_t> queries{};
+    std::vector<jstmap::match_position> positions{};
+    libjst::tree_traverser_base traverser{aligner.reference_tree(query_size - 1)};
+    for (auto it = traverser.begin(); it != traverser.end(); ++it) {
+        auto cargo = *it;
+        jstmap::reference_t path_sequence{};
+        std::ranges::copy(cargo.path_sequence(), std::back_inserter(path_sequence));
+        std::ptrdiff_t const path_size = std::ranges::ssize(path_sequence);
+        if (path_size < static_cast<std::ptrdiff_t>(query_size))
+            continue;
+
+        std::ptrdiff_t const last_offset = path_size - query_size;
+        for (std::ptrdiff_t label_offset : {std::ptrdiff_t{0}, last_offset / 2, last_offset}) {
+            jstmap::record_sequence_t query{path_sequence.begin() + label_offset,
+                                            path_sequence.begin() + label_offset + query_size};
+            if (queries.size() % 2 == 1) {
+                char const substitute = (seqan3::to_char(query[query_size / 2]) == 'A') ? 'C' : 'A';
+                query[query_size / 2] = seqan3::assign_char_to(substitute, jstmap::alphabet_t{});
+            }
+            queries.push_back(std::move(query));
+            positions.push_back(jstmap::match_position{.tree_position = cargo.position(), .label_offset = label_offset});
+        }
+    }
+    ASSERT_GT(queries.size(), 3u);
+
+    jstmap::match_alignment_queue queue{aligner, 4};
+    for (size_t idx = 0; idx < queries.size(); ++idx)
+        queue.add(queries[idx], positions[idx], idx);
+
+    size_t aligned_count{};
+    queue.align([&] (size_t const idx, jstmap::search_match match) {
+        jstmap::search_match expected = align_single(queries[idx], positions[idx]);
+        EXPECT_EQ(match.position(), positions[idx]) << "match " << idx;
+        EXPECT_EQ(match.get_score(), expected.get_score()) << "match " << idx;
+        EXPECT_EQ(match.get_cigar(), expected.get_cigar()) << "match " << idx;
+        ++aligned_count;
+    });
+    EXPECT_EQ(aligned_count, queries.size());
+    EXPECT_EQ(queue.size(), 0u);
+}
@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/search/mate_rescuer.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::to_sequence;
+using jstmap::test::to_string;
+
+struct mate_rescuer_test : public ::testing::Test
+{
+    jstmap::rcs_store_t rcs_store = jstmap::test::make_store();
+
+    // The tree the rescuer builds over the store before it extends it from the anchor.
+    auto base_tree() const
+    {
+        return rcs_store | libjst::make_volatile()
+                         | libjst::labelled()
+                         | libjst::coloured()
+                         | libjst::prune()
+                         | libjst::merge()
+                         | libjst::seek();
+    }
+
+    // The anchor at the begin of the root of the tree.
+    jstmap::match_position root_anchor() const
+    {
+        auto tree = base_tree();
+        libjst::tree_traverser_base traverser{tree};
+        return jstmap::match_position{.tree_position = (*traverser.begin()).position(), .label_offset = 0};
+    }
+
+    std::vector<std::pair<jstmap::match_position, std::ptrdiff_t>> rescue(std::string_view mate,
+                                                                          uint32_t const max_insert_size) const
+    {
+        jstmap::reference_t mate_sequence = to_sequence(mate);
+        jstmap::mate_rescuer rescuer{rcs_store, 0.0, max_insert_size};
+        std::vector<std::pair<jstmap::match_position, std::ptrdiff_t>> rescued{};
+        rescuer(mate_sequence, root_anchor(), [&] (jstmap::match_position position, std::ptrdiff_t const template_length) {
+            rescued.emplace_back(std::move(position), template_length);
+        });
+        return rescued;
+    }
+};
+
+TEST(mate_rescuer_test, reverse_complement)
+{
+    EXPECT_EQ(to_string(jstmap::reverse_complement(to_sequence("AACGTTG"))), "CAACGTT");
+    EXPECT_EQ(to_string(jstmap::reverse_complement(to_sequence("ACNGT"))), "ACNGT");
+    EXPECT_TRUE(jstmap::reverse_complement(jstmap::reference_t{}).empty());
+}
+
+TEST_F(mate_rescuer_test, rescue_across_variant)
+{
+    // Only haplotype 1 spells CGGGTA across the insertion of GG: ACGTA[CGGGTA]NNACGT.
+    auto rescued = rescue("CGGGTA", 20);
+    ASSERT_EQ(rescued.size(), 1u);
+    auto const & [position, template_length] = rescued.front();
+    EXPECT_EQ(template_length, 11);
+
+    auto tree = base_tree();
+    auto cargo = *tree.seek(position.tree_position);
+    EXPECT_TRUE(cargo.coverage().contains(1));
+    EXPECT_FALSE(cargo.coverage().contains(0));
+
+    jstmap::reference_t path_sequence{};
+    std::ranges::copy(cargo.path_sequence(), std::back_inserter(path_sequence));
+    ASSERT_GE(std::ranges::ssize(path_sequence), position.label_offset + 6);
+    EXPECT_EQ(to_string(path_sequence).substr(position.label_offset, 6), "CGGGTA");
+}
+
+TEST_F(mate_rescuer_test, no_rescue)
+{
+    EXPECT_TRUE(rescue("GGGGGG", 20).empty());
+    EXPECT_TRUE(rescue("CGGGTA", 8).empty()); // The mate ends behind the insert size window.
+}
+
+TEST_F(mate_rescuer_test, shared_rescuer)
+{
+    // One rescuer serves the mates of all reads.
+    jstmap::mate_rescuer rescuer{rcs_store, 0.0, 20u};
+    size_t rescued_count{};
+    auto count_rescue = [&] (jstmap::match_position, std::ptrdiff_t) { ++rescued_count; };
+    rescuer(to_sequence("CGGGTA"), root_anchor(), count_rescue);
+    EXPECT_EQ(rescued_count, 1u);
+    rescuer(to_sequence("GGGGGG"), root_anchor(), count_rescue);
+    EXPECT_EQ(rescued_count, 1u);
+    rescuer(to_sequence("CGGGTA"), root_anchor(), count_rescue);
+    EXPECT_EQ(rescued_count, 2u);
+}
@@ -0,0 +1,57 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include <jstmap/search/order_queries.hpp>
+
+static jstmap::sequence_record_t make_record(std::string_view chars)
+{
+    jstmap::sequence_record_t record{};
+    for (char c : chars)
+        record.sequence().push_back(seqan3::assign_char_to(c, jstmap::alphabet_t{}));
+    return record;
+}
+
+TEST(order_queries_test, query_minimiser)
+{
+    EXPECT_EQ(jstmap::query_minimiser(make_record("ACGTACGT").sequence()), std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(jstmap::query_minimiser(make_record("ACGTACGTNACGTACGT").sequence()),
+              std::numeric_limits<uint64_t>::max());
+
+    // Queries sharing the substring holding the minimiser share the minimiser.
+    EXPECT_EQ(jstmap::query_minimiser(make_record("GATTACAGATTACACCGT").sequence()),
+              jstmap::query_minimiser(make_record("NNGATTACAGATTACACCGT").sequence()));
+}
+
+TEST(order_queries_test, order_by_minimiser)
+{
+    std::vector<std::string_view> sequences{"CCCCGGGGAAAATTTTCA", "GATTACAGATTACAGATT", "CCCCGGGGAAAATTTTCA",
+                                            "ACGT", "GATTACAGATTACAGATT"};
+    jstmap::search_queries_type queries{};
+    for (std::string_view chars : sequences)
+        queries.emplace_back(queries.size(), make_record(chars));
+
+    jstmap::order_by_minimiser(queries);
+
+    ASSERT_EQ(queries.size(), 5u);
+    for (size_t idx = 1; idx < queries.size(); ++idx)
+        EXPECT_LE(jstmap::query_minimiser(queries[idx - 1].value().sequence()),
+                  jstmap::query_minimiser(queries[idx].value().sequence()));
+
+    // Equal minimisers keep their relative order and end up next to each other.
+    auto position_of = [&] (size_t key) {
+        return std::ranges::find(queries, key, &jstmap::search_query::key) - queries.begin();
+    };
+    EXPECT_EQ(position_of(2) - position_of(0), 1);
+    EXPECT_EQ(position_of(4) - position_of(1), 1);
+    EXPECT_EQ(position_of(3), 4); // no valid k-mer
+}
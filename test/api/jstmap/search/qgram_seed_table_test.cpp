@@ -0,0 +1,80 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/search/qgram_seed_table.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::to_sequence;
+
+struct qgram_seed_table_test : public ::testing::Test
+{
+    // needle index, seed offset, haystack begin
+    using hit_t = std::tuple<uint32_t, uint32_t, std::ptrdiff_t>;
+
+    template <typename table_t>
+    static std::vector<hit_t> find_all(table_t const & table, std::string_view haystack)
+    {
+        std::vector<hit_t> hits{};
+        table(to_sequence(haystack), [&] (jstmap::seed_finder const & finder, jstmap::seed_hit const & hit) {
+            EXPECT_EQ(endPosition(finder) - beginPosition(finder), static_cast<std::ptrdiff_t>(hit.count));
+            hits.emplace_back(hit.index, hit.offset, beginPosition(finder));
+        });
+        std::ranges::sort(hits);
+        return hits;
+    }
+};
+
+TEST_F(qgram_seed_table_test, exact_seeds)
+{
+    std::vector<jstmap::reference_t> needles{to_sequence("ACGTACGTAC"), to_sequence("GGGGCCCCTT")};
+    jstmap::qgram_seed_table table{needles, 0.0};
+
+    EXPECT_EQ(table.window_size(), 10u);
+    EXPECT_EQ(find_all(table, "TTACGTACGTACGGGGCCCCTTA"), (std::vector<hit_t>{{0, 0, 2}, {1, 0, 12}}));
+}
+
+TEST_F(qgram_seed_table_test, pigeonhole_seeds)
+{
+    // 20 bases with 10% errors are split into 3 seeds of size 6.
+    std::vector<jstmap::reference_t> needles{to_sequence("AACCGGTTACGTTGCAATCG")};
+    jstmap::qgram_seed_table table{needles, 0.1};
+
+    ASSERT_EQ(table.window_size(), 6u);
+    // Two errors in the first and second seed; the third seed is found.
+    EXPECT_EQ(find_all(table, "CCAAGCGGTTACCTTGCAATCG"), (std::vector<hit_t>{{0, 12, 14}}));
+    // Ambiguous bases can not be matched.
+    EXPECT_TRUE(find_all(table, "CCAAGCGGTTACCTTGCNATCG").empty());
+}
+
+TEST_F(qgram_seed_table_test, long_seeds)
+{
+    std::string_view long_needle = "ACGTTGCAACGTTGCAACGTTGCAACGTTGCAACGTTGCA";
+    std::vector<jstmap::reference_t> needles{to_sequence(long_needle)};
+    jstmap::qgram_seed_table table{needles, 0.0};
+
+    ASSERT_EQ(table.window_size(), 40u);
+    EXPECT_EQ(find_all(table, long_needle), (std::vector<hit_t>{{0, 0, 0}}));
+    // The mismatch behind the first 32 bases is detected.
+    EXPECT_TRUE(find_all(table, "ACGTTGCAACGTTGCAACGTTGCAACGTTGCAACGTTGCT").empty());
+}
+
+TEST_F(qgram_seed_table_test, empty)
+{
+    std::vector<jstmap::reference_t> needles{};
+    jstmap::qgram_seed_table table{needles, 0.0};
+
+    EXPECT_EQ(table.window_size(), 0u);
+    EXPECT_TRUE(find_all(table, "ACGT").empty());
+}
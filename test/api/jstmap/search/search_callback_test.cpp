@@ -0,0 +1,62 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <libjst/sequence_tree/volatile_tree.hpp>
+
+#include <jstmap/global/hit_collector.hpp>
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/match_position.hpp>
+#include <jstmap/search/bucket.hpp>
+#include <jstmap/search/bucket_searcher.hpp>
+
+#include "../test_utility.hpp"
+
+struct search_callback_test : public ::testing::Test
+{
+    jstmap::rcs_store_t rcs_store = jstmap::test::make_store();
+
+    // Searches the reads with the hit collector as callback, as the search does for every thread.
+    std::vector<jstmap::hit_collector> search(std::vector<jstmap::reference_t> const & reads, double error_rate) const
+    {
+        jstmap::bucket test_bucket{.base_tree = rcs_store | libjst::make_volatile(), .needle_list = reads};
+        jstmap::bucket_searcher searcher{test_bucket, error_rate};
+        std::vector<jstmap::hit_collector> collectors(1);
+        searcher([&] (std::ptrdiff_t const needle_index,
+                      jstmap::match_position const & position,
+                      uint32_t const error_count) {
+            collectors[0].record(needle_index, position, error_count);
+        });
+        return collectors;
+    }
+};
+
+TEST_F(search_callback_test, unique_read)
+{
+    // CTTACGTA occurs once, in the haplotypes 0 and 2 carrying the substitution.
+    auto collectors = search({jstmap::test::to_sequence("CTTACGTA")}, 0.0);
+    ASSERT_TRUE(collectors[0].hits().contains(0));
+
+    auto summaries = jstmap::summarise_hits(collectors);
+    EXPECT_EQ(summaries.at(0).best_error_count(), 0u);
+    EXPECT_EQ(summaries.at(0).best_count(), 1u);
+    EXPECT_EQ(summaries.at(0).mapping_quality(), jstmap::mapping_summary::max_mapping_quality);
+}
+
+TEST_F(search_callback_test, repeated_read)
+{
+    // ACGT occurs at several loci of every haplotype.
+    auto collectors = search({jstmap::test::to_sequence("ACGT")}, 0.0);
+    ASSERT_TRUE(collectors[0].hits().contains(0));
+
+    auto summaries = jstmap::summarise_hits(collectors);
+    EXPECT_GT(summaries.at(0).best_count(), 1u);
+    EXPECT_LT(summaries.at(0).mapping_quality(), jstmap::mapping_summary::max_mapping_quality);
+}
@@ -0,0 +1,69 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <jstmap/search/state_stack_pool.hpp>
+
+using state_t = std::vector<uint64_t>;
+
+TEST(state_stack_pool_test, push_pop)
+{
+    jstmap::state_stack_pool<state_t> stack{};
+    EXPECT_TRUE(stack.empty());
+
+    stack.push() = state_t{1, 2};
+    stack.push() = state_t{3};
+    EXPECT_EQ(stack.size(), 2u);
+    EXPECT_EQ(stack.top(), (state_t{3}));
+
+    stack.pop();
+    EXPECT_EQ(stack.size(), 1u);
+    EXPECT_EQ(stack.top(), (state_t{1, 2}));
+
+    stack.pop();
+    EXPECT_TRUE(stack.empty());
+}
+
+TEST(state_stack_pool_test, reuse_storage)
+{
+    jstmap::state_stack_pool<state_t> stack{};
+    stack.push() = state_t{1, 2, 3, 4};
+    uint64_t const * storage = stack.top().data();
+    stack.pop();
+
+    // The popped element keeps its storage, which is reused by the next state.
+    state_t const next_state{5, 6};
+    state_t & state = stack.push();
+    EXPECT_EQ(state.capacity(), 4u);
+    state = next_state;
+    EXPECT_EQ(state.data(), storage);
+    EXPECT_EQ(stack.top(), (state_t{5, 6}));
+}
+
+TEST(state_stack_pool_test, shrink)
+{
+    jstmap::state_stack_pool<state_t> stack{};
+    stack.push() = state_t{1};
+    size_t const base_size = stack.size();
+    stack.push() = state_t{2};
+    stack.push() = state_t{3};
+
+    stack.shrink(base_size);
+    EXPECT_EQ(stack.size(), 1u);
+    EXPECT_EQ(stack.top(), (state_t{1}));
+}
+
+TEST(state_stack_pool_test, thread_local_pool)
+{
+    auto & pool = jstmap::thread_local_state_stack_pool<state_t>();
+    EXPECT_EQ(&pool, &jstmap::thread_local_state_stack_pool<state_t>());
+    EXPECT_NE(static_cast<void *>(&pool), static_cast<void *>(&jstmap::thread_local_state_stack_pool<int>()));
+}
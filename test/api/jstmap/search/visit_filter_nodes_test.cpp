@@ -0,0 +1,76 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <libjst/sequence_tree/chunked_tree.hpp>
+
+#include <jstmap/global/filter_tree.hpp>
+#include <jstmap/global/jstmap_types.hpp>
+#include <jstmap/global/match_position.hpp>
+#include <jstmap/global/topology_cache.hpp>
+#include <jstmap/search/visit_filter_nodes.hpp>
+
+#include "../test_utility.hpp"
+
+struct visited_node
+{
+    libjst::seek_position position{};
+    std::string label{};
+    std::ptrdiff_t path_size{};
+
+    bool operator==(visited_node const &) const = default;
+};
+
+// Records the seek position, the label and the path size of every visited node.
+auto record_nodes(std::vector<visited_node> & nodes)
+{
+    return [&nodes] (auto cargo) {
+        visited_node node{.position = cargo.position(), .path_size = jstmap::path_size(cargo)};
+        for (jstmap::alphabet_t symbol : cargo.sequence())
+            node.label.push_back(seqan3::to_char(symbol));
+        nodes.push_back(std::move(node));
+    };
+}
+
+TEST(visit_filter_nodes_test, replay_equals_traversal)
+{
+    jstmap::rcs_store_t rcs_store = jstmap::test::make_store();
+
+    for (size_t bin_size : {6u, 18u}) {
+        auto forest = rcs_store | libjst::chunk(bin_size);
+        for (std::ptrdiff_t chunk_idx = 0; chunk_idx < std::ranges::ssize(forest); ++chunk_idx) {
+            for (size_t window_size : {2u, 4u}) {
+                jstmap::cached_chunk cached = jstmap::collect_filter_nodes(forest[chunk_idx],
+                                                                           rcs_store.source(),
+                                                                           window_size);
+
+                std::vector<visited_node> traversed{};
+                jstmap::visit_filter_nodes(jstmap::make_filter_tree(forest[chunk_idx], window_size),
+                                           nullptr,
+                                           nullptr,
+                                           record_nodes(traversed),
+                                           false).run();
+                std::vector<visited_node> replayed{};
+                jstmap::visit_filter_nodes(jstmap::make_filter_tree(forest[chunk_idx], window_size),
+                                           &cached,
+                                           &rcs_store.source(),
+                                           record_nodes(replayed),
+                                           false).run();
+
+                // Only the nodes whose label can contain a window are cached.
+                std::erase_if(traversed, [&] (visited_node const & node) { return node.label.size() < window_size; });
+                EXPECT_FALSE(replayed.empty());
+                EXPECT_EQ(replayed, traversed) << "bin size " << bin_size << ", chunk " << chunk_idx
+                                               << ", window size " << window_size;
+            }
+        }
+    }
+}
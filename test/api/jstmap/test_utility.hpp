@@ -0,0 +1,62 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <jstmap/global/jstmap_types.hpp>
+
+namespace jstmap::test
+{
+
+inline reference_t to_sequence(std::string_view chars)
+{
+    reference_t sequence{};
+    for (char c : chars)
+        sequence.push_back(seqan3::assign_char_to(c, alphabet_t{}));
+    return sequence;
+}
+
+inline std::string to_string(reference_t const & sequence)
+{
+    std::string chars{};
+    for (alphabet_t symbol : sequence)
+        chars.push_back(seqan3::to_char(symbol));
+    return chars;
+}
+
+//!\brief Builds an optimised coverage from the ascending haplotype ids.
+inline coverage_t make_coverage(std::vector<uint32_t> const & ids, coverage_t::domain_type const & domain)
+{
+    coverage_t coverage{domain};
+    for (uint32_t id : ids)
+        coverage.insert(coverage.end(), id);
+    coverage.optimise();
+    return coverage;
+}
+
+/*!\brief A store of four haplotypes over 18 bases with a substitution, an insertion and a deletion.
+ *
+ * \details
+ *
+ * Haplotypes 0 and 2 carry the substitution G -> T at position 2, haplotype 1 carries the insertion of GG in front
+ * of position 6, and haplotypes 1 and 3 carry the deletion of the positions 9 to 11.
+ */
+inline rcs_store_t make_store()
+{
+    rcs_store_t rcs_store{to_sequence("ACGTACGTACGTNNACGT"), 4};
+    auto domain = rcs_store.variants().coverage_domain();
+    rcs_store.add(variant_t{libjst::breakpoint{2, 1}, to_sequence("T"), make_coverage({0, 2}, domain)});
+    rcs_store.add(variant_t{libjst::breakpoint{6, 0}, to_sequence("GG"), make_coverage({1}, domain)});
+    rcs_store.add(variant_t{libjst::breakpoint{9, 3}, to_sequence(""), make_coverage({1, 3}, domain)});
+    return rcs_store;
+}
+
+}  // namespace jstmap::test
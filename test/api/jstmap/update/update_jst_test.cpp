@@ -0,0 +1,128 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2006-2021, Knut Reinert & Freie Universität Berlin
+// Copyright (c) 2016-2021, Knut Reinert & MPI für molekulare Genetik
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/seqan/seqan3/blob/master/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <seqan3/test/tmp_filename.hpp>
+
+#include <jstmap/global/for_each_variant.hpp>
+#include <jstmap/update/update_jst.hpp>
+
+#include "../test_utility.hpp"
+
+using jstmap::test::make_store;
+using jstmap::test::to_string;
+
+struct update_jst_test : public ::testing::Test
+{
+    // Maps the low breakend and the alternate sequence of every variant to its carriers.
+    using variant_map_t = std::map<std::pair<size_t, std::string>, std::vector<uint32_t>>;
+
+    seqan3::test::tmp_filename vcf_file{"update.vcf"};
+
+    // One sample re-calls the substitution at position 2 and adds a substitution at position 14.
+    void SetUp() override
+    {
+        write_vcf("0|1", "1/1:30");
+    }
+
+    void write_vcf(std::string const & first_genotype, std::string const & second_genotype) const
+    {
+        std::ofstream vcf_stream{vcf_file.get_path()};
+        vcf_stream << "##fileformat=VCFv4.2\n"
+                   << "##contig=<ID=chr1,length=18>\n"
+                   << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+                   << "##FORMAT=<ID=GQ,Number=1,Type=Integer,Description=\"Genotype quality\">\n"
+                   << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tsample\n"
+                   << "chr1\t3\t.\tG\tT\t.\tPASS\t.\tGT\t" << first_genotype << "\n"
+                   << "chr1\t15\t.\tA\tC\t.\tPASS\t.\tGT:GQ\t" << second_genotype << "\n";
+    }
+
+    jstmap::jst_update update(bool const append_samples) const
+    {
+        jstmap::update_options options{};
+        options.vcf_file = vcf_file.get_path();
+        options.append_samples = append_samples;
+        return jstmap::update_jst(make_store(), options);
+    }
+
+    static variant_map_t variants(jstmap::rcs_store_t const & rcs_store)
+    {
+        variant_map_t variants{};
+        jstmap::for_each_variant(rcs_store, [&] (auto low, auto, auto const & alt_sequence, auto const & coverage) {
+            jstmap::reference_t alt(std::ranges::begin(alt_sequence), std::ranges::end(alt_sequence));
+            variants[{static_cast<size_t>(low), to_string(alt)}] = std::vector<uint32_t>(coverage.begin(), coverage.end());
+        });
+        return variants;
+    }
+};
+
+TEST_F(update_jst_test, update_records)
+{
+    jstmap::jst_update result = update(false);
+
+    // Only the haplotypes 0 and 1 of the vcf sample are replaced, the haplotypes 2 and 3 keep their carriers.
+    EXPECT_EQ(result.rcs_store.size(), 4u);
+    EXPECT_EQ(variants(result.rcs_store), (variant_map_t{{{2, "T"}, {1, 2}},
+                                                         {{6, "GG"}, {1}},
+                                                         {{9, ""}, {1, 3}},
+                                                         {{14, "C"}, {0, 1}}}));
+    EXPECT_EQ(result.changed_regions, (std::vector<std::pair<uint32_t, uint32_t>>{{2, 3}, {14, 15}}));
+}
+
+TEST_F(update_jst_test, remove_carriers)
+{
+    {
+        std::ofstream vcf_stream{vcf_file.get_path()};
+        vcf_stream << "##fileformat=VCFv4.2\n"
+                   << "##contig=<ID=chr1,length=18>\n"
+                   << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+                   << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tsample\n"
+                   << "chr1\t3\t.\tG\tT\t.\tPASS\t.\tGT\t0|0\n"
+                   << "chr1\t6\t.\tC\tCGG\t.\tPASS\t.\tGT\t0|0\n"
+                   << "chr1\t15\t.\tA\tC\t.\tPASS\t.\tGT\t0|0\n";
+    }
+    jstmap::jst_update result = update(false);
+
+    // The substitution keeps only the carrier 2, which is not in the vcf file, and the insertion loses its only
+    // carrier. The unknown substitution without carriers is not added and the absent deletion keeps its carriers.
+    EXPECT_EQ(variants(result.rcs_store), (variant_map_t{{{2, "T"}, {2}},
+                                                         {{9, ""}, {1, 3}}}));
+    EXPECT_EQ(result.changed_regions, (std::vector<std::pair<uint32_t, uint32_t>>{{2, 3}, {6, 6}}));
+}
+
+TEST_F(update_jst_test, append_samples)
+{
+    jstmap::jst_update result = update(true);
+
+    // The haplotypes of the vcf sample are appended as the haplotypes 4 and 5.
+    EXPECT_EQ(result.rcs_store.size(), 6u);
+    EXPECT_EQ(variants(result.rcs_store), (variant_map_t{{{2, "T"}, {0, 2, 5}},
+                                                         {{6, "GG"}, {1}},
+                                                         {{9, ""}, {1, 3}},
+                                                         {{14, "C"}, {4, 5}}}));
+    EXPECT_EQ(result.changed_regions, (std::vector<std::pair<uint32_t, uint32_t>>{{2, 3}, {14, 15}}));
+}
+
+TEST_F(update_jst_test, reject_non_diploid_genotypes)
+{
+    write_vcf("1", "1|1");
+    EXPECT_THROW(update(false), std::runtime_error);
+
+    write_vcf("0|1", "1|1|0");
+    EXPECT_THROW(update(false), std::runtime_error);
+
+    write_vcf(".|1", "1|.");
+    EXPECT_NO_THROW(update(false));
+}
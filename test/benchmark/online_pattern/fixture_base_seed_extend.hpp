@@ -26,6 +26,7 @@
 #include <jstmap/global/match_position.hpp>
 #include <jstmap/search/load_queries.hpp>
 #include <jstmap/search/filter_queries.hpp>
+#include <jstmap/search/interleaved_task.hpp>
 
 #include <libjst/sequence_tree/chunked_tree.hpp>
 #include <libjst/sequence_tree/coloured_tree.hpp>
@@ -144,6 +145,51 @@ namespace just::bench
             }
             return hit_count;
         }
+
+        template <typename runner_creator_t>
+        void run_interleaved(::benchmark::State & state, runner_creator_t && make_runner, size_t const interleave_count)
+        {
+            size_t const thread_count = state.range(0);
+            auto trees = libjst::chunk(store(), get_chunk_size(thread_count * interleave_count));
+            int32_t hit_count{};
+            for (auto _ : state)
+            {
+                benchmark::DoNotOptimize(hit_count = execute_interleaved(trees, make_runner, queries(), thread_count,
+                                                                         interleave_count));
+                benchmark::ClobberMemory();
+            }
+        }
+
+        template <typename trees_t, typename runner_creator_t, typename search_queries_t>
+        static int32_t execute_interleaved(trees_t && trees,
+                                           runner_creator_t && make_runner,
+                                           search_queries_t && queries,
+                                           size_t const thread_count,
+                                           size_t const interleave_count) {
+            int32_t hit_count = 0;
+            std::ptrdiff_t const chunk_count = std::ranges::ssize(trees);
+            std::ptrdiff_t const group_count = (chunk_count + interleave_count - 1) / interleave_count;
+
+            #pragma omp parallel for num_threads(thread_count), shared(trees), firstprivate(make_runner, queries), schedule(static), reduction(+:hit_count)
+            for (std::ptrdiff_t group = 0; group < group_count; ++group) {
+                std::ptrdiff_t const group_begin = group * interleave_count;
+                std::ptrdiff_t const group_end = std::min<std::ptrdiff_t>(group_begin + interleave_count, chunk_count);
+
+                using runner_t = decltype(make_runner(trees[0], queries));
+                std::vector<runner_t> runners{};
+                runners.reserve(group_end - group_begin);
+                std::vector<jstmap::interleaved_task> tasks{};
+                tasks.reserve(group_end - group_begin);
+                for (std::ptrdiff_t chunk = group_begin; chunk < group_end; ++chunk) {
+                    runners.push_back(make_runner(trees[chunk], queries));
+                    tasks.push_back(runners.back().interleaved([&] (std::ptrdiff_t, jstmap::match_position) {
+                        ++hit_count;
+                    }));
+                }
+                jstmap::run_interleaved(tasks);
+            }
+            return hit_count;
+        }
     };
 }  // namespace just::bench
 
@@ -21,6 +21,8 @@
 #include <libjst/sequence_tree/trim_tree.hpp>
 #include <libjst/sequence_tree/volatile_tree.hpp>
 
+#include <jstmap/search/state_stack_pool.hpp>
+
 #include "fixture_base_ibf.hpp"
 
 namespace just::bench
@@ -30,7 +32,7 @@ namespace just::bench
     private:
 
         using state_t = spm::matcher_state_t<matcher_t>;
-        using state_stack_t = std::stack<state_t>;
+        using state_stack_t = jstmap::state_stack_pool<state_t>;
 
         matcher_t _matcher{};
         state_stack_t _states{};
@@ -43,7 +45,7 @@ namespace just::bench
         {}
 
         constexpr void notify_push() {
-            _states.push(_matcher.capture());
+            _states.push() = _matcher.capture();
         }
 
         constexpr void notify_pop() {